@@ -38,8 +38,13 @@
 
 #include <random>
 #include <map>
+#include <unordered_map>
+#include <unordered_set>
 #include <deque>
+#include <vector>
 #include <memory>
+#include <atomic>
+#include <mutex>
 
 #include "mutator/rng.h"
 #include "data/dataHandler.h"
@@ -100,7 +105,17 @@ protected:
 	* recordings to associate each recording to the right copy of the
 	* DataHandler.
 	*/
-	std::map<size_t, std::vector<std::reference_wrapper<const Data::DataHandler>>> dataHandlers;
+	std::unordered_map<size_t, std::vector<std::reference_wrapper<const Data::DataHandler>>> dataHandlers;
+
+	/**
+	* \brief Number of recordings referencing each hash of the dataHandlers
+	* attribute.
+	*
+	* This counter is used to free copies of DataHandler as soon as the last
+	* recording referencing them is removed from the Archive, without
+	* browsing the recordings.
+	*/
+	std::unordered_map<size_t, uint64_t> nbRecordingsPerHash;
 
 	/**
 	* \brief Map storing the Program pointers referenced in recordings the
@@ -110,9 +125,109 @@ protected:
 	* whenever the las ArchiveRecording referencing a Program is removed from
 	* the Archive.
 	*
-	* The Map is used to speed the unicity tests.
+	* The Map is used to update the resultsPerProgram when recordings are
+	* removed.
+	*/
+	std::unordered_map<const Program::Program*, std::deque<ArchiveRecording>> recordingsPerProgram;
+
+	/**
+	* \brief Slot associated to each hash of the dataHandlers attribute.
+	*
+	* Slots are small integers indexing the hashes of the Archive, used to
+	* replace hash lookups with array accesses in unicity tests. Slots of
+	* removed hashes are reused for new hashes.
+	*/
+	std::unordered_map<size_t, uint32_t> slotPerHash;
+
+	/// Slots no longer associated to a hash, available for new hashes.
+	std::vector<uint32_t> freeSlots;
+
+	/// Number of slots created in the Archive.
+	uint32_t nbSlots = 0;
+
+	/**
+	* \brief Results of a Program, stored in columns.
+	*
+	* For each slot (i.e. hash) for which the Program has recordings, the
+	* i-th element of each column stores the slot, the minimum and maximum
+	* results of these recordings, and their number. If any of these results
+	* is NaN, the minimum and maximum results are also NaN.
+	*
+	* When a recording is removed, the minimum and maximum results of its
+	* slot can not be updated without the remaining recordings. Instead of
+	* browsing them for each removal, the slot is marked as dirty, and all
+	* dirty slots of the Program are rebuilt at once by
+	* updateDirtyProgramResults().
+	*/
+	struct ProgramResults {
+		/// Slots of the hashes of recordings.
+		std::vector<uint32_t> slots;
+
+		/// Minimum result of recordings, for each slot.
+		std::vector<double> minResults;
+
+		/// Maximum result of recordings, for each slot.
+		std::vector<double> maxResults;
+
+		/// Number of recordings, for each slot.
+		std::vector<uint64_t> nbResults;
+
+		/// Whether the minimum and maximum results are outdated, for each slot.
+		std::vector<uint8_t> isDirty;
+
+		/// Index of each slot in the columns.
+		std::unordered_map<uint32_t, size_t> columnPerSlot;
+	};
+
+	/**
+	* \brief Map storing the results of all Program referenced in
+	* recordings.
+	*
+	* The Map is used to speed the unicity tests. It is mutable because its
+	* dirty slots are rebuilt by the const areProgramResultsUnique() method.
+	*/
+	mutable std::unordered_map<const Program::Program*, ProgramResults> resultsPerProgram;
+
+	/// Program of the resultsPerProgram with dirty slots.
+	mutable std::unordered_set<const Program::Program*> dirtyPrograms;
+
+	/**
+	* \brief Whether the dirtyPrograms is not empty.
+	*
+	* This flag is checked by the areProgramResultsUnique() method, which
+	* may be called concurrently by several threads, without locking the
+	* dirtyProgramsMutex when no rebuild is needed.
+	*/
+	mutable std::atomic<bool> hasDirtyPrograms{ false };
+
+	/// Mutex protecting the rebuild of dirty slots.
+	mutable std::mutex dirtyProgramsMutex;
+
+	/**
+	* \brief Rebuild the minimum and maximum results of all dirty slots.
+	*
+	* Recordings of each Program with dirty slots are browsed once. This
+	* method is thread safe, but must not be called concurrently with the
+	* addition of recordings.
+	*/
+	void updateDirtyProgramResults() const;
+
+	/**
+	* \brief Update the resultsPerProgram with a new recording.
+	*
+	* \param[in] recording the ArchiveRecording added to the Archive.
+	*/
+	void addProgramResult(const ArchiveRecording& recording);
+
+	/**
+	* \brief Update the resultsPerProgram after the removal of a recording.
+	*
+	* Must be called after the removal of the recording from the
+	* recordingsPerProgram attribute.
+	*
+	* \param[in] recording the ArchiveRecording removed from the Archive.
 	*/
-	std::map<const Program::Program*, std::deque<ArchiveRecording>> recordingsPerProgram;
+	void removeProgramResult(const ArchiveRecording& recording);
 
 	/// Recordings of the Archive
 	std::deque<ArchiveRecording> recordings;
@@ -201,6 +316,29 @@ public:
 		double result,
 		bool forced = false);
 
+	/**
+	* \brief Insert a new recording in the Archive, using the given copy of
+	* DataHandler.
+	*
+	* This method inserts a recording without any randomness, like a forced
+	* call to addRecording, and with the same eviction of the oldest
+	* recordings when the maximum number of recordings is exceeded.
+	* Contrary to addRecording, the DataHandler are not copied by the
+	* Archive. If the given hash is not already in the Archive, the Archive
+	* takes ownership of the DataHandler in dHandlerCopy, and the vector is
+	* emptied. Otherwise, dHandlerCopy is left untouched and its content
+	* remains owned by the caller.
+	*
+	* \param[in] program the Program associated to this recording.
+	* \param[in] hash the combined hash of the DataHandler.
+	* \param[in] result double value produced by the Program.
+	* \param[in,out] dHandlerCopy copy of the DataHandler with the given
+	*                 hash, which must not be empty if the hash is not
+	*                 already in the Archive.
+	*/
+	void insertRecording(const Program::Program* const program, size_t hash, double result,
+		std::vector<std::reference_wrapper<const Data::DataHandler>>& dHandlerCopy);
+
 	/**
 	* \brief Check whether the given hash is already in the archive.
 	*
@@ -224,6 +362,13 @@ public:
 		double tau = 1e-4
 	) const;
 
+	/**
+	* \brief Get the maximum number of recordings held in the Archive.
+	*
+	* \return the value of the maxSize attribute.
+	*/
+	size_t getMaxSize() const;
+
 	/**
 	* \brief Get the number of recordings currently held in the Archive.
 	*
@@ -248,7 +393,7 @@ public:
 	*
 	* \return a const reference to the dataHandlers attribute.
 	*/
-	const std::map < size_t, std::vector<std::reference_wrapper<const Data::DataHandler>>>& getDataHandlers() const;
+	const std::unordered_map<size_t, std::vector<std::reference_wrapper<const Data::DataHandler>>>& getDataHandlers() const;
 
 	/**
 	* \brief Clear all content from the Archive.
@@ -0,0 +1,199 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2020) :
+ *
+ * Karol Desnos <kdesnos@insa-rennes.fr> (2020)
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+#ifndef ARCHIVE_RECORDING_BUFFER_H
+#define ARCHIVE_RECORDING_BUFFER_H
+
+#include <vector>
+#include <unordered_map>
+
+#include "archive.h"
+
+/**
+* \brief Archive buffering recordings produced in parallel, before their
+* deterministic insertion in a shared Archive.
+*
+* When roots of a TPGGraph are evaluated in parallel, each thread records
+* program executions into its own ArchiveRecordingBuffer. Recordings of each
+* root are stored in a separate segment, whose random engine is seeded
+* specifically for this root so that archiving decisions do not depend on the
+* thread evaluating the root. Once all roots are evaluated, the merge method
+* inserts the recordings of all segments into the shared Archive, in the
+* order of segments identifiers.
+*
+* The result of this process is identical to the evaluation of each root with
+* a dedicated Archive, followed by the forced insertion of the recordings of
+* all these Archive in the shared Archive. Unlike this approach, each set of
+* DataHandler is copied only once per ArchiveRecordingBuffer, whatever the
+* number of roots whose recordings reference it, and copies are moved into
+* the shared Archive instead of being copied again.
+*
+* The recordings of an ArchiveRecordingBuffer are only accessible through the
+* merge method. Methods of the base Archive class giving access to
+* recordings always behave as if the ArchiveRecordingBuffer was empty.
+*/
+class ArchiveRecordingBuffer : public Archive {
+protected:
+	/// Recording stored in a segment of the buffer.
+	struct BufferedRecording {
+		/// Pointer to the Program. This pointer may point to a freed program.
+		const Program::Program* prog;
+
+		/// Hash of the set of DataHandler for this recording.
+		size_t dataHash;
+
+		/// Value returned by the Program.
+		double result;
+	};
+
+	/**
+	* \brief Recordings of a segment of the buffer.
+	*
+	* Recordings are stored in a circular buffer holding at most maxSize
+	* recordings. When full, the oldest recording is overwritten.
+	*/
+	struct Segment {
+		/// Identifier of the segment, used to order segments in merge.
+		uint64_t id;
+
+		/// Index of the oldest recording in recordings.
+		size_t first;
+
+		/// Circular buffer of recordings.
+		std::vector<BufferedRecording> recordings;
+	};
+
+	/// Segments of the buffer. Only the first nbSegments are in use.
+	std::vector<Segment> segments;
+
+	/// Number of segments in use.
+	size_t nbSegments = 0;
+
+	/**
+	* \brief Copies of DataHandler referenced by buffered recordings.
+	*
+	* Each set of DataHandler is associated to the number of buffered
+	* recordings referencing it, and freed when this number drops to zero.
+	* A set of DataHandler whose ownership was transferred to another
+	* Archive is kept as an empty vector.
+	*/
+	std::unordered_map<size_t, std::pair<std::vector<std::reference_wrapper<const Data::DataHandler>>, uint64_t>> snapshots;
+
+	/**
+	* \brief Decrement the number of references to a copy of DataHandler,
+	* and free it if it is no longer referenced.
+	*
+	* \param[in] hash the hash of the copy of DataHandler.
+	*/
+	void releaseSnapshot(size_t hash);
+
+public:
+	/**
+	* \brief Constructor for ArchiveRecordingBuffer.
+	*
+	* \param[in] size maximum number of recordings kept in each segment.
+	* \param[in] archivingProbability probability for each call to
+	* addRecording to actually lead to a new recording in the current
+	* segment.
+	*/
+	ArchiveRecordingBuffer(size_t size = 50, double archivingProbability = 1.0) : Archive(size, archivingProbability) {};
+
+	/**
+	* \brief Destructor of the class.
+	*
+	* Free all the copies of DataHandler still owned by the buffer.
+	*/
+	~ArchiveRecordingBuffer();
+
+	/**
+	* \brief Start a new segment of recordings.
+	*
+	* Following calls to addRecording will store their recordings in the new
+	* segment.
+	*
+	* \param[in] id the identifier of the new segment.
+	* \param[in] seed the seed value for the random engine deciding which
+	* recordings are kept in the segment.
+	*/
+	void startSegment(uint64_t id, size_t seed);
+
+	/**
+	* \brief Add a new recording to the current segment.
+	*
+	* Recordings are added with the same probability, and the same random
+	* process, as with the Archive::addRecording method. If the segment is
+	* full, its oldest recording is removed.
+	*
+	* \throw std::runtime_error if no segment was started.
+	*/
+	void addRecording(const Program::Program* const program,
+		const std::vector<std::reference_wrapper<const Data::DataHandler>>& dHandler,
+		double result,
+		bool forced = false) override;
+
+	/**
+	* \brief Get the total number of recordings held in the segments of the
+	* ArchiveRecordingBuffer.
+	*
+	* \return the number of buffered recordings.
+	*/
+	size_t getNbBufferedRecordings() const;
+
+	/**
+	* \brief Remove all segments and recordings from the buffer.
+	*
+	* Allocated segments are kept for later use.
+	*/
+	void clearBuffer();
+
+	/**
+	* \brief Insert the buffered recordings of several ArchiveRecordingBuffer
+	* into an Archive.
+	*
+	* Segments of all ArchiveRecordingBuffer are sorted in the ascending order
+	* of their identifiers, and the last recordings of this sequence are
+	* inserted into the archive, in this order, up to its maximum size.
+	* When a set of DataHandler is not yet in the archive, its copy is moved
+	* from the ArchiveRecordingBuffer to the archive.
+	*
+	* All ArchiveRecordingBuffer are cleared with clearBuffer once merged.
+	*
+	* \param[in,out] buffers the ArchiveRecordingBuffer to merge.
+	* \param[in,out] archive the Archive into which recordings are inserted.
+	*/
+	static void merge(const std::vector<ArchiveRecordingBuffer*>& buffers, Archive& archive);
+};
+
+#endif
@@ -44,11 +44,25 @@
 
 #include "data/untypedSharedPtr.h"
 
+namespace Program {
+	class CompiledProgram;
+	class ProgramExecutionEngine;
+};
+
+namespace TPG {
+	class FrozenTPGExecutionEngine;
+};
+
 namespace Data {
 	/**
 	* \brief Base class for all sources of data to be accessed by a TPG Instruction executed within a Program.
 	*/
 	class DataHandler {
+		// Engines calling the Instructions::Instruction::Kernel on raw
+		// pointers to data.
+		friend class Program::CompiledProgram;
+		friend class Program::ProgramExecutionEngine;
+		friend class TPG::FrozenTPGExecutionEngine;
 
 	protected:
 
@@ -95,6 +109,32 @@ namespace Data {
 		*/
 		virtual size_t updateHash() const = 0;
 
+		/**
+		* \brief Get a raw pointer to data of the given type, at the given
+		* address.
+		*
+		* This method gives direct access to data natively contained in the
+		* DataHandler, and is used to call the Instructions::Instruction::Kernel
+		* of Instructions. For performance reasons, no check is done on the
+		* given type and address, which must have been validated beforehand,
+		* for example with the getAddressSpace() method.
+		*
+		* The default implementation of this method returns nullptr for all
+		* types, meaning that data of the DataHandler can only be accessed
+		* through the getDataAt() method.
+		*
+		* Since no check is done, this method is protected, and only
+		* accessible to the engines executing Program with kernels.
+		*
+		* \param[in] type the std::type_info of data retrieved.
+		* \param[in] address the location of the data to retrieve.
+		* \return a pointer to the requested const data, or nullptr if the
+		* DataHandler does not support direct access for this type. For an
+		* array type T[n], the pointer points to the first of n contiguous
+		* elements.
+		*/
+		virtual const void* getDataPointerAt(const std::type_info& type, const size_t address) const;
+
 	public:
 		/**
 		* \brief Default constructor of the DataHandler class.
@@ -188,9 +228,9 @@ namespace Data {
 		* Data is returned as an UntypedSharedPtr, with two possible allocations:
 		* - Classic pointer: The returned data is natively contained in the
 		* DataHandler and could be accessed through a regular pointer. In this
-		* case the returned UntypedSharedPtr is associated with an empty destructor
-		* function as its destructor to avoid any deallocation on the
-		* shared_ptr deletion.
+		* case the returned UntypedSharedPtr is a view on the data, built with
+		* UntypedSharedPtr::createView(), which requires no allocation and
+		* never deallocates the data.
 		* - Shared pointer: The returned data is a temporary object that was
 		* constructed on request from data in the DataHandler. Once it has
 		* been used, on deletion of the shared pointer, this temporary object
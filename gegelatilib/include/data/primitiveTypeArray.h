@@ -40,6 +40,9 @@
 #include <sstream>
 #include <functional>
 #include <typeinfo>
+#include <atomic>
+#include <cstdlib>
+#include <string>
 #include <regex>
 
 #include "data/hash.h"
@@ -56,6 +59,32 @@
 #error Unsupported compiler (yet): Check need for name demangling of typeid.name().
 #endif
 
+namespace Data {
+	/**
+	* \brief Get the name of a type in human readable format.
+	*
+	* Contrary to the DEMANGLE_TYPEID_NAME macro, this function frees the
+	* memory allocated for the demangled name.
+	*
+	* \param[in] type the std::type_info whose name is demangled.
+	* \return a std::string containing the demangled name.
+	*/
+	inline std::string getDemangledTypeName(const std::type_info& type)
+	{
+#ifdef _MSC_VER
+		return std::string(type.name());
+#else
+		char* demangled = DEMANGLE_TYPEID_NAME(type.name());
+		if (demangled == nullptr) {
+			return std::string(type.name());
+		}
+		std::string result(demangled);
+		std::free(demangled);
+		return result;
+#endif
+	}
+}
+
 namespace Data {
 	/**
 	* DataHandler for manipulating arrays of a primitive data type.
@@ -92,11 +121,55 @@ namespace Data {
 		*/
 		void checkAddressAndType(const std::type_info& type, const size_t& address) const;
 
+		/**
+		* \brief Entry of the list of types already identified by the
+		* getNbElementsOfType() method.
+		*/
+		struct NbElementsOfType {
+			/// Identified type.
+			const std::type_info* type;
+
+			/// Number of elements of type T composing the identified type.
+			size_t nbElements;
+
+			/// Next entry of the list.
+			const NbElementsOfType* next;
+		};
+
+		/**
+		* \brief Head of the list of types already identified by the
+		* getNbElementsOfType() method.
+		*
+		* Entries are never modified once inserted in the list, and are only
+		* freed with the PrimitiveTypeArray. Hence, the list can be browsed
+		* and extended concurrently without lock.
+		*/
+		mutable std::atomic<const NbElementsOfType*> nbElementsOfTypes{ nullptr };
+
+		/**
+		* \brief Get the number of elements of type T composing the given type.
+		*
+		* Since identifying array types requires demangling their name and
+		* matching it with a std::regex, the result of this method is cached
+		* in the nbElementsOfTypes list of the PrimitiveTypeArray. Hence, the
+		* costly identification is done only once per type, and subsequent
+		* calls only browse the few types already accessed.
+		*
+		* This method is thread safe.
+		*
+		* \param[in] type the std::type_info of data.
+		* \return 1 for type T, n for type T[n], and 0 for unsupported types.
+		*/
+		size_t getNbElementsOfType(const std::type_info& type) const;
+
 		/**
 		* \brief Implementation of the updateHash method.
 		*/
 		virtual size_t updateHash() const override;
 
+		/// Inherited from DataHandler
+		virtual const void* getDataPointerAt(const std::type_info& type, const size_t address) const override;
+
 	public:
 		/**
 		*  \brief Constructor for the PrimitiveTypeArray class.
@@ -106,8 +179,18 @@ namespace Data {
 		*/
 		PrimitiveTypeArray(size_t size = 8);
 
-		/// Default destructor.
-		virtual ~PrimitiveTypeArray() = default;
+		/**
+		* \brief Copy constructor for the PrimitiveTypeArray class.
+		*
+		* Copies the data, and the types already identified by the
+		* getNbElementsOfType() method.
+		*
+		* \param[in] other the PrimitiveTypeArray to copy.
+		*/
+		PrimitiveTypeArray(const PrimitiveTypeArray<T>& other);
+
+		/// Destructor freeing the types identified by getNbElementsOfType().
+		virtual ~PrimitiveTypeArray();
 
 		// Inherited from DataHandler
 		virtual DataHandler* clone() const override;
@@ -155,6 +238,26 @@ namespace Data {
 
 	template <class T> PrimitiveTypeArray<T>::PrimitiveTypeArray(size_t size) : nbElements{ size }, data(size) {}
 
+	template <class T> PrimitiveTypeArray<T>::PrimitiveTypeArray(const PrimitiveTypeArray<T>& other) : DataHandler(other), nbElements{ other.nbElements }, data(other.data)
+	{
+		// Copy the identified types (in reverse order, which does not matter).
+		const NbElementsOfType* head = nullptr;
+		for (const NbElementsOfType* entry = other.nbElementsOfTypes.load(std::memory_order_acquire); entry != nullptr; entry = entry->next) {
+			head = new NbElementsOfType{ entry->type, entry->nbElements, head };
+		}
+		this->nbElementsOfTypes.store(head, std::memory_order_release);
+	}
+
+	template <class T> PrimitiveTypeArray<T>::~PrimitiveTypeArray()
+	{
+		const NbElementsOfType* entry = this->nbElementsOfTypes.load(std::memory_order_acquire);
+		while (entry != nullptr) {
+			const NbElementsOfType* next = entry->next;
+			delete entry;
+			entry = next;
+		}
+	}
+
 	template<class T>
 	inline DataHandler* PrimitiveTypeArray<T>::clone() const
 	{
@@ -173,25 +276,54 @@ namespace Data {
 		return (this->getAddressSpace(type) > 0);
 	}
 
-	template<class T> size_t PrimitiveTypeArray<T>::getAddressSpace(const std::type_info& type) const
+	template<class T> size_t PrimitiveTypeArray<T>::getNbElementsOfType(const std::type_info& type) const
 	{
 		if (type == typeid(T)) {
-			return this->nbElements;
+			return 1;
 		}
 
-		// If the type is an array of the primitive type
-		// with a size inferior to the container.
-		std::string typeName = DEMANGLE_TYPEID_NAME(type.name());
-		std::string regex{ DEMANGLE_TYPEID_NAME(typeid(T).name()) };
+		// Look for the type among already identified types
+		const NbElementsOfType* head = this->nbElementsOfTypes.load(std::memory_order_acquire);
+		for (const NbElementsOfType* entry = head; entry != nullptr; entry = entry->next) {
+			if (*entry->type == type) {
+				return entry->nbElements;
+			}
+		}
+
+		// Check if the type is an array of the primitive type
+		size_t nbElements = 0;
+		std::string typeName = getDemangledTypeName(type);
+		std::string regex = getDemangledTypeName(typeid(T));
 		regex.append("\\s*(const\\s*)?\\[([0-9]+)\\]");
 		std::regex arrayType(regex);
 		std::cmatch cm;
 		if (std::regex_match(typeName.c_str(), cm, arrayType)) {
-			int size = std::atoi(cm[2].str().c_str());
-			if (size <= this->nbElements) {
-				return this->nbElements - size + 1;
-			}
+			nbElements = std::atoi(cm[2].str().c_str());
+		}
+
+		// Store the result at the head of the list.
+		// If another thread inserted an entry meanwhile, retry with the new
+		// head. (The type may then be listed twice, which is harmless.)
+		NbElementsOfType* entry = new NbElementsOfType{ &type, nbElements, head };
+		while (!this->nbElementsOfTypes.compare_exchange_weak(head, entry, std::memory_order_release, std::memory_order_acquire)) {
+			entry->next = head;
 		}
+		return nbElements;
+	}
+
+	template<class T> size_t PrimitiveTypeArray<T>::getAddressSpace(const std::type_info& type) const
+	{
+		if (type == typeid(T)) {
+			return this->nbElements;
+		}
+
+		// If the type is an array of the primitive type
+		// with a size inferior to the container.
+		size_t size = getNbElementsOfType(type);
+		if (size > 0 && size <= this->nbElements) {
+			return this->nbElements - size + 1;
+		}
+
 		// Default case
 		return 0;
 	}
@@ -219,14 +351,14 @@ namespace Data {
 		// check type
 		if (addressSpace == 0) {
 			std::stringstream  message;
-			message << "Data type " << DEMANGLE_TYPEID_NAME(type.name()) << " cannot be accessed in a " << DEMANGLE_TYPEID_NAME(typeid(*this).name()) << ".";
+			message << "Data type " << getDemangledTypeName(type) << " cannot be accessed in a " << getDemangledTypeName(typeid(*this)) << ".";
 			throw std::invalid_argument(message.str());
 		}
 
 		// check location
 		if (address >= addressSpace) {
 			std::stringstream  message;
-			message << "Data type " << DEMANGLE_TYPEID_NAME(type.name()) << " cannot be accessed at address " << address << ", address space size is " << addressSpace + ".";
+			message << "Data type " << getDemangledTypeName(type) << " cannot be accessed at address " << address << ", address space size is " << addressSpace << ".";
 			throw std::out_of_range(message.str());
 		}
 	}
@@ -237,25 +369,18 @@ namespace Data {
 		checkAddressAndType(type, address);
 
 		if (type == typeid(T)) {
-			UntypedSharedPtr result(&(this->data[address]), UntypedSharedPtr::emptyDestructor<const T>());
-			return result;
+			return UntypedSharedPtr::createView<T>(&(this->data[address]));
 		}
 
 		// Else, the only other supported type is cstyle array.
+		// Elements of the array are contiguous in the data vector.
+		return UntypedSharedPtr::createView<T[]>(&(this->data[address]));
+	}
 
-		// Allocate the array
-		size_t arraySize = this->nbElements - this->getAddressSpace(type) + 1;
-		T* array = new T[arraySize];
-
-		// Copy its content
-		for (size_t idx = 0; idx < arraySize; idx++) {
-			array[idx] = this->data[address + idx];
-		}
-
-		// Create the UntypedSharedPtr
-		UntypedSharedPtr result{ std::make_shared<UntypedSharedPtr::Model<const T[]>>(array) };
-		return result;
-
+	template<class T> const void* PrimitiveTypeArray<T>::getDataPointerAt(const std::type_info&, const size_t address) const
+	{
+		// Both the native type and arrays are contiguous in the data vector.
+		return &(this->data[address]);
 	}
 
 	template<class T>
@@ -272,7 +397,8 @@ namespace Data {
 			}
 			else {
 				// Else, the type is the array type.
-				for (int i = 0; i < (this->nbElements - space + 1); i++) {
+				const size_t arraySize = getNbElementsOfType(type);
+				for (size_t i = 0; i < arraySize; i++) {
 					result.push_back(address + i);
 				}
 			}
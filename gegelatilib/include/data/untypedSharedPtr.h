@@ -39,6 +39,8 @@
 #include <functional>
 #include <type_traits>
 #include <memory>
+#include <stdexcept>
+#include <string>
 
 namespace Data {
 
@@ -63,6 +65,11 @@ namespace Data {
 	*
 	* The code of this class is based on the Type Erasure patterns, and is
 	* directly inspired by [this example](https://www.modernescpp.com/index.php/c-core-guidelines-type-erasure-with-templates)/
+	*
+	* In addition, an UntypedSharedPtr can be built as a non-owning view on
+	* const data with the createView() method. Contrary to other
+	* UntypedSharedPtr, views require no heap allocation, which makes them
+	* suitable for passing operands to Instructions.
 	*/
 	class UntypedSharedPtr {
 	public:
@@ -184,6 +191,36 @@ namespace Data {
 		*/
 		UntypedSharedPtr(std::shared_ptr<Concept> concept) : sharedPtrContainer(concept) {};
 
+		/**
+		* \brief Create an UntypedSharedPtr viewing existing const data.
+		*
+		* The created UntypedSharedPtr does not own the viewed data, and
+		* building it requires no heap allocation. Consequently, the viewed
+		* data must outlive the UntypedSharedPtr and all std::shared_ptr
+		* retrieved from it with the getSharedPointer() method.
+		*
+		* Since viewed data is const, only const template parameters can be
+		* given to the getSharedPointer() method of the created
+		* UntypedSharedPtr.
+		*
+		* \code{.cpp}
+		* double values[4]{ 0.0, 1.0, 2.0, 3.0 };
+		* UntypedSharedPtr usp1 = UntypedSharedPtr::createView<double>(values + 1);
+		* UntypedSharedPtr usp2 = UntypedSharedPtr::createView<double[]>(values + 1);
+		* *usp1.getSharedPointer<const double>(); // 1.0
+		* usp2.getSharedPointer<const double[]>()[2]; // 3.0
+		* \endcode
+		*
+		* \tparam T type of the viewed data: either a type T, or an array of
+		* unknown bound T[].
+		* \param[in] ptr pointer to the viewed data.
+		* \return the UntypedSharedPtr viewing the data.
+		*/
+		template <typename T>
+		static UntypedSharedPtr createView(const std::remove_extent_t<T>* ptr) {
+			return UntypedSharedPtr(ptr, typeid(T), typeid(const std::remove_extent_t<T>*));
+		}
+
 		/**
 		* \brief Accessor to the type of data stored in the UntypedSharedPtr.
 		*
@@ -210,6 +247,9 @@ namespace Data {
 		* \endcode
 		*/
 		const std::type_info& getType() const {
+			if (this->viewType != nullptr) {
+				return *this->viewType;
+			}
 			return sharedPtrContainer->getType();
 		}
 
@@ -239,6 +279,9 @@ namespace Data {
 		* \endcode
 		*/
 		const std::type_info& getPtrType() const {
+			if (this->viewType != nullptr) {
+				return *this->viewPtrType;
+			}
 			return sharedPtrContainer->getPtrType();
 		}
 
@@ -292,6 +335,18 @@ namespace Data {
 			const auto& templatePtrTypeNoConst = typeid(std::remove_const_t<T>*);
 			const auto& ownPtrType = this->getPtrType();
 
+			// If the UntypedSharedPtr is a view, build a non-owning shared_ptr
+			// with the aliasing constructor, which requires no allocation.
+			// Viewed data is always const.
+			if (this->viewType != nullptr) {
+				using Element = typename std::shared_ptr<T>::element_type;
+				if constexpr (std::is_const<Element>::value) {
+					if (templateType == ownType) {
+						return std::shared_ptr<T>(std::shared_ptr<void>(), static_cast<Element*>(this->viewPtr));
+					}
+				}
+			}
+
 			// If pointer types are identical (which includes const qualifier), go for it.
 			// Unless non-pointers types are different, which may be the case for arrays
 			if (ownPtrType == templatePtrType && templateType == ownType) {
@@ -359,6 +414,29 @@ namespace Data {
 		* actual std::shared_ptr.
 		*/
 		std::shared_ptr<const Concept> sharedPtrContainer;
+
+	private:
+		/// Pointer to the data viewed by an UntypedSharedPtr built with
+		/// createView(), nullptr otherwise.
+		const void* viewPtr = nullptr;
+
+		/// Type of the data viewed by an UntypedSharedPtr built with
+		/// createView(), nullptr otherwise.
+		const std::type_info* viewType = nullptr;
+
+		/// Pointer type of the data viewed by an UntypedSharedPtr built with
+		/// createView(), nullptr otherwise.
+		const std::type_info* viewPtrType = nullptr;
+
+		/**
+		* \brief Constructor for views, used by createView().
+		*
+		* \param[in] ptr pointer to the viewed data.
+		* \param[in] type type of the viewed data.
+		* \param[in] ptrType pointer type of the viewed data.
+		*/
+		UntypedSharedPtr(const void* ptr, const std::type_info& type, const std::type_info& ptrType) :
+			viewPtr{ ptr }, viewType{ &type }, viewPtrType{ &ptrType } {};
 	};
 }
 #endif // !UNTYPED_SHARED_PTR_H
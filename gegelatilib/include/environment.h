@@ -106,6 +106,17 @@ protected:
 	/// Size of lines within this Environment
 	const LineSize lineSize;
 
+	/**
+	* \brief Registers accessed by each operand of each Instruction.
+	*
+	* For the operand idxOperand of the Instruction idxInstruction, the
+	* element at index idxInstruction * maxNbOperands + idxOperand stores the
+	* address space of the operand type within the registers, and the number
+	* of consecutive registers read by the operand. The address space is 0
+	* if registers can not provide the operand type.
+	*/
+	const std::vector<std::pair<size_t, size_t>> registersAccesses;
+
 	/**
 	* \brief Static method used when constructing a new Environment to compute
 	* the largest AddressSpace of a set of DataHandler.
@@ -133,6 +144,15 @@ protected:
 	*/
 	static const LineSize computeLineSize(const Environment& env);
 
+	/**
+	* \brief Static method used when constructing a new Environment to
+	* compute the registers accessed by the operands of its Instruction.
+	*
+	* \param[in] env The Environment whose information is used.
+	* \return the content of the registersAccesses attribute.
+	*/
+	static std::vector<std::pair<size_t, size_t>> computeRegistersAccesses(const Environment& env);
+
 	/**
 	* \brief Filter an InstructionSet to keep only Instruction with operand
 	* types provided by the given DataHandler.
@@ -166,7 +186,7 @@ public:
 		nbRegisters{ nbRegs }, fakeRegisters(nbRegs),
 		nbInstructions{ instructionSet.getNbInstructions() }, maxNbOperands{ instructionSet.getMaxNbOperands() },
 		maxNbParameters{ instructionSet.getMaxNbParameters() }, nbDataSources{ dHandlers.size() + 1 }, largestAddressSpace{ computeLargestAddressSpace(nbRegs, dHandlers) },
-		lineSize{ computeLineSize(*this) } {};
+		lineSize{ computeLineSize(*this) }, registersAccesses{ computeRegistersAccesses(*this) } {};
 
 	/**
 	* \brief Get the size of the number of registers of this Environment.
@@ -235,6 +255,26 @@ public:
 	*/
 	const Data::DataHandler& getFakeRegisters() const;
 
+	/**
+	* \brief Get the registers accessed by an operand of an Instruction.
+	*
+	* An operand of the Instruction whose location is L, when reading
+	* registers, accesses the N consecutive registers starting at index
+	* L % S, where S and N are respectively the first and second elements of
+	* the returned pair. S is 0 if the registers can not provide the operand
+	* type.
+	*
+	* Contrary to the methods of the DataHandler returned by
+	* getFakeRegisters(), this method does not allocate any memory.
+	*
+	* \param[in] instructionIndex the index of the Instruction.
+	* \param[in] operandIndex the index of the operand of the Instruction.
+	* \return a const reference to the address space and number of
+	* registers accessed by the operand.
+	* \throw std::out_of_range if an index is too large.
+	*/
+	const std::pair<size_t, size_t>& getRegistersAccess(uint64_t instructionIndex, uint64_t operandIndex) const;
+
 	/**
 	* \brief Get the Instruction Set of the Environment.
 	*
@@ -0,0 +1,170 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2020) :
+ *
+ * Karol Desnos <kdesnos@insa-rennes.fr> (2020)
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+#ifndef TPG_GRAPH_BINARY_EXPORTER_H
+#define TPG_GRAPH_BINARY_EXPORTER_H
+
+#include <cstdint>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+
+#include "tpg/tpgGraph.h"
+#include "program/program.h"
+
+namespace File {
+	/**
+	* \brief Class used to export a TPGGraph into a binary file.
+	*
+	* Contrary to the dot format, the binary format is not meant to be read
+	* by a human, but to be imported quickly with a TPGGraphBinaryImporter.
+	* All content is stored as 64-bit words with the endianness of the
+	* exporting platform, in the following order:
+	* - A header with the formatMagic and formatVersion, followed by the
+	*   fields of the LineSize of the Environment of the TPGGraph, and by the
+	*   number of vertices, Program and edges of the TPGGraph.
+	* - One word per TPGVertex, in the order of the TPGGraph vertices: 0 for
+	*   a TPGTeam, and actionID + 1 for a TPGAction.
+	* - For each Program, its number of Line and the number of words of its
+	*   Program::PackedLines, followed by these words. Each Line is thus
+	*   stored on LineSize::totalNbBits bits only.
+	* - Three words per TPGEdge, in the order of the TPGGraph edges: the
+	*   index of its source TPGVertex, of its Program, and of its destination
+	*   TPGVertex.
+	*
+	* Since vertices and edges are stored in the order of the TPGGraph, the
+	* imported TPGGraph is identical to the exported one.
+	*/
+	class TPGGraphBinaryExporter {
+	protected:
+		/**
+		* \brief File in which the binary content is written during export.
+		*/
+		FILE* pFile;
+
+		/**
+		* \brief Reference to the TPGGraph exported into binary.
+		*/
+		const TPG::TPGGraph& tpg;
+
+		/**
+		* \brief Write a 64-bit word in the file.
+		*
+		* \param[in] word the word to write.
+		*/
+		void writeWord(uint64_t word);
+
+		/**
+		* \brief Write the content of the given Program in the file.
+		*
+		* \param[in] program the Program to write.
+		* \throws std::out_of_range if a value of a Line can not be encoded
+		* with the LineSize of the Environment.
+		*/
+		void writeProgram(const Program::Program& program);
+
+	public:
+		/// Characters "GEGELATI" identifying the binary format.
+		static const uint64_t formatMagic;
+
+		/// Version of the binary format.
+		static const uint64_t formatVersion;
+
+		/**
+		* \brief Constructor for the exporter.
+		*
+		* \param[in] filePath initial path to the file where the binary
+		* content will be written.
+		* \param[in] graph const reference to the graph whose content will
+		* be exported in binary.
+		* \throws std::runtime_error in case no file could be opened at the
+		* given filePath.
+		*/
+		TPGGraphBinaryExporter(const char* filePath, const TPG::TPGGraph& graph) : pFile{ NULL }, tpg{ graph } {
+			if ((pFile = fopen(filePath, "wb")) == NULL) {
+				throw std::runtime_error("Could not open file " + std::string(filePath));
+			}
+		};
+
+		/// Disable copy construction.
+		TPGGraphBinaryExporter(const TPGGraphBinaryExporter& other) = delete;
+
+		/// Disable TPGGraphBinaryExporter default assignment operator.
+		TPGGraphBinaryExporter& operator=(const TPGGraphBinaryExporter& other) = delete;
+
+		/**
+		* Destructor for the exporter.
+		*
+		* Closes the file.
+		*/
+		~TPGGraphBinaryExporter() {
+			if (pFile != NULL) {
+				fclose(pFile);
+			}
+		}
+
+		/**
+		* \brief Set a new file for the exporter.
+		*
+		* \param[in] newFilePath new path to the file where the binary
+		* content will be written.
+		* \throws std::runtime_error in case no file could be opened at the
+		* given newFilePath.
+		*/
+		void setNewFilePath(const char* newFilePath) {
+			//  Close previous file
+			if (pFile != NULL) {
+				fclose(pFile);
+			}
+
+			// open new one;
+			if ((pFile = fopen(newFilePath, "wb")) == NULL) {
+				throw std::runtime_error("Could not open file " + std::string(newFilePath));
+			}
+		}
+
+		/**
+		* \brief Print the TPGGraph given when constructing the
+		* TPGGraphBinaryExporter into a binary file.
+		*
+		* The file is flushed when the method returns.
+		*
+		* \throws std::runtime_error if writing into the file fails.
+		*/
+		void print();
+	};
+};
+
+#endif
@@ -0,0 +1,184 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2020) :
+ *
+ * Karol Desnos <kdesnos@insa-rennes.fr> (2020)
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+#ifndef TPG_GRAPH_BINARY_IMPORTER_H
+#define TPG_GRAPH_BINARY_IMPORTER_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "tpg/tpgGraph.h"
+#include "program/program.h"
+
+namespace File {
+	/**
+	* \brief Class used to import a TPGGraph from a binary file written by a
+	* TPGGraphBinaryExporter.
+	*
+	* The file is mapped in memory, when supported by the platform, and its
+	* content is read in place, without parsing. Otherwise, the file is read
+	* at once into a buffer. The lines of each Program are loaded at once
+	* into a Program::PackedLines, and then unpacked into the Program.
+	*
+	* The file can only be imported into a TPGGraph whose Environment has the
+	* same LineSize as the Environment of the exported TPGGraph.
+	*/
+	class TPGGraphBinaryImporter {
+	protected:
+		/**
+		* \brief TPGGraph imported from the binary file.
+		*/
+		TPG::TPGGraph& tpg;
+
+		/// Content of the file, as 64-bit words.
+		const uint64_t* content;
+
+		/// Number of 64-bit words in the content.
+		size_t nbWords;
+
+		/// Index of the next word to read in the content.
+		size_t readIndex;
+
+		/// Address of the memory mapping of the file (if any).
+		void* mapping;
+
+		/// Size of the memory mapping of the file.
+		size_t mappingSize;
+
+		/// Buffer holding the content of the file, when it is not mapped.
+		std::vector<uint64_t> buffer;
+
+		/**
+		* \brief Open the file and map its content.
+		*
+		* \param[in] filePath path to the file to open.
+		* \throws std::runtime_error in case the file could not be opened, or
+		* if its size is not a multiple of 64 bits.
+		*/
+		void openFile(const char* filePath);
+
+		/**
+		* \brief Release the content of the file.
+		*/
+		void closeFile();
+
+		/**
+		* \brief Read the next 64-bit words of the content.
+		*
+		* \param[in] nb number of words to read.
+		* \return a pointer to the nb words, within the content.
+		* \throws std::runtime_error if the content ends before nb words.
+		*/
+		const uint64_t* readWords(size_t nb);
+
+		/**
+		* \brief Read the header of the file and check its compatibility with
+		* the Environment of the TPGGraph.
+		*
+		* \throws std::runtime_error if the format magic or version are not
+		* supported, or if the LineSize does not match the one of the
+		* Environment.
+		*/
+		void readHeader();
+
+		/**
+		* \brief Read a Program from the content.
+		*
+		* \return the read Program.
+		* \throws std::runtime_error if the number of words of the Program is
+		* inconsistent with its number of Line, or if a Line is invalid for
+		* the Environment of the TPGGraph.
+		*/
+		std::shared_ptr<Program::Program> readProgram();
+
+	public:
+		/**
+		* \brief Constructor for the importer.
+		*
+		* The TPGGraph is imported during construction.
+		*
+		* \param[in] filePath path to the binary file.
+		* \param[in] tpgref a reference to the TPGGraph to build from the
+		* binary file.
+		* \throws std::runtime_error in case no file could be opened at the
+		* given filePath, or if its content is invalid.
+		*/
+		TPGGraphBinaryImporter(const char* filePath, TPG::TPGGraph& tpgref) :
+			tpg{ tpgref }, content{ nullptr }, nbWords{ 0 }, readIndex{ 0 }, mapping{ nullptr }, mappingSize{ 0 }
+		{
+			this->openFile(filePath);
+			this->importGraph();
+		};
+
+		/// Disable copy construction.
+		TPGGraphBinaryImporter(const TPGGraphBinaryImporter& other) = delete;
+
+		/// Disable TPGGraphBinaryImporter default assignment operator.
+		TPGGraphBinaryImporter& operator=(const TPGGraphBinaryImporter& other) = delete;
+
+		/**
+		* Destructor for the importer.
+		*
+		* Releases the content of the file.
+		*/
+		~TPGGraphBinaryImporter() {
+			this->closeFile();
+		}
+
+		/**
+		* \brief Set a new file for the importer.
+		*
+		* \param[in] newFilePath path to the new binary file.
+		* \throws std::runtime_error in case no file could be opened at the
+		* given newFilePath.
+		*/
+		void setNewFilePath(const char* newFilePath);
+
+		/**
+		* \brief Creates a TPGGraph from its description in the binary file.
+		*
+		* The TPGGraph is cleared before the import. Vertices and edges are
+		* created in the order of the exported TPGGraph, and introns of the
+		* imported Program are identified.
+		*
+		* \throws std::runtime_error if the content of the file is invalid.
+		* In this case, the TPGGraph may be partially imported.
+		*/
+		void importGraph();
+	};
+};
+
+#endif
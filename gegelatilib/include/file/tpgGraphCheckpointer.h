@@ -0,0 +1,139 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2020) :
+ *
+ * Karol Desnos <kdesnos@insa-rennes.fr> (2020)
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+#ifndef TPG_GRAPH_CHECKPOINTER_H
+#define TPG_GRAPH_CHECKPOINTER_H
+
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "tpg/tpgGraph.h"
+
+namespace File {
+	/**
+	* \brief Class used to save snapshots of a TPGGraph into a dot file
+	* without stalling the thread modifying the TPGGraph.
+	*
+	* When the checkpoint() method is called, a copy of the TPGGraph is made
+	* with TPG::TPGGraph::clone(), which only duplicates its vertices and
+	* edges. This copy is then exported with a TPGGraphDotExporter by a
+	* background thread, while the caller keeps modifying the TPGGraph.
+	*
+	* The dot content is first written into a temporary file, which then
+	* replaces the checkpoint file. Hence, the checkpoint file always holds
+	* a complete TPGGraph, even if the process stops during an export.
+	*
+	* At most one export is running at a time: a call to checkpoint()
+	* waits for the end of the previous export.
+	*/
+	class TPGGraphCheckpointer {
+	protected:
+		/// Path of the checkpoint file.
+		const std::string filePath;
+
+		/// Background thread exporting the last snapshot.
+		std::thread exportThread;
+
+		/// Snapshot of the TPGGraph being exported.
+		std::unique_ptr<TPG::TPGGraph> snapshot;
+
+		/// Exception thrown by the last export, if any.
+		std::exception_ptr exportException;
+
+		/// Number of completed checkpoints.
+		std::atomic<uint64_t> nbCheckpoints{ 0 };
+
+		/**
+		* \brief Export the snapshot into the checkpoint file.
+		*
+		* This method is executed by the exportThread.
+		*/
+		void exportSnapshot();
+
+	public:
+		/**
+		* \brief Constructor for the checkpointer.
+		*
+		* \param[in] path path to the checkpoint file.
+		*/
+		TPGGraphCheckpointer(const char* path) : filePath{ path } {};
+
+		/// Disable copy construction.
+		TPGGraphCheckpointer(const TPGGraphCheckpointer& other) = delete;
+
+		/// Disable TPGGraphCheckpointer default assignment operator.
+		TPGGraphCheckpointer& operator=(const TPGGraphCheckpointer& other) = delete;
+
+		/**
+		* \brief Destructor for the checkpointer.
+		*
+		* Waits for the end of the running export, if any. Exceptions
+		* thrown by this export are ignored.
+		*/
+		~TPGGraphCheckpointer();
+
+		/**
+		* \brief Save a snapshot of the given TPGGraph into the checkpoint
+		* file.
+		*
+		* The method returns once the snapshot of the TPGGraph is made,
+		* before its export.
+		*
+		* \param[in] graph the TPGGraph to save.
+		* \throws std::runtime_error if the previous export failed.
+		*/
+		void checkpoint(const TPG::TPGGraph& graph);
+
+		/**
+		* \brief Wait for the end of the running export, if any.
+		*
+		* \throws std::runtime_error if the export failed.
+		*/
+		void wait();
+
+		/**
+		* \brief Get the number of checkpoints saved so far.
+		*
+		* \return the number of completed exports.
+		*/
+		uint64_t getNbCheckpoints() const;
+	};
+};
+
+#endif
@@ -61,6 +61,15 @@ namespace File {
 		*/
 		FILE* pFile;
 
+		/**
+		* \brief Dot content printed during export.
+		*
+		* The dot content is entirely printed in this string before being
+		* written into the file at once, instead of being written with many
+		* small writes.
+		*/
+		std::string content;
+
 		/**
 		* \brief Character chain used to control the indentation of the exported
 		* file.
@@ -148,11 +157,24 @@ namespace File {
 		*/
 		bool findProgramID(const Program::Program& prog, uint64_t& id);
 
+		/**
+		* \brief Append formatted text at the end of the content.
+		*
+		* \param[in] format printf-like format string.
+		* \throws std::runtime_error if the text cannot be formatted.
+		*/
+		void write(const char* format, ...);
+
+		/**
+		* \brief Print the dot content of the TPGGraph into the content
+		* attribute.
+		*/
+		void printToContent();
+
 		/**
 		* \brief Print the dot content for the given TPGTeam.
 		*
-		* Content is printed directly into the file opened by the class
-		* constructor, or by a call to setNewFilePath.
+		* Content is printed into the content attribute.
 		*
 		* \param[in] team the TPGTeam being printed.
 		*/
@@ -162,8 +184,7 @@ namespace File {
 		/**
 		* \brief Print the dot content for the given TPGAction.
 		*
-		* Content is printed directly into the file opened by the class
-		* constructor, or by a call to setNewFilePath.
+		* Content is printed into the content attribute.
 		* This method returns the identifier associated to the printed action
 		* so that the print TPGEdge method can target this TPGAction. Indeed,
 		* contrary to TPGTeam which have a unique ID, each action is printed on
@@ -232,6 +253,18 @@ namespace File {
 			}
 		};
 
+		/**
+		* \brief Constructor for an exporter printing only into a string.
+		*
+		* The dot content of the TPGGraph can be obtained with the
+		* printToString() method. A file must be set with setNewFilePath()
+		* before calling the print() method.
+		*
+		* \param[in] graph const reference to the graph whose content will
+		* be exported in dot.
+		*/
+		TPGGraphDotExporter(const TPG::TPGGraph& graph) : pFile{ NULL }, tpg{ graph }, offset{ "" }, nbActions{ 0 } {};
+
 		/**
 		* Disable copy construction.
 		*
@@ -269,7 +302,9 @@ namespace File {
 		*/
 		void setNewFilePath(const char* newFilePath) {
 			//  Close previous file
-			fclose(pFile);
+			if (pFile != NULL) {
+				fclose(pFile);
+			}
 
 			// open new one;
 			if ((pFile = fopen(newFilePath, "w")) == NULL) {
@@ -281,8 +316,23 @@ namespace File {
 		/**
 		* \brief Print the TPGGraph given when constructing the
 		* TPGGraphDotExporter into a dot file.
+		*
+		* The dot content is printed in memory, and written into the file
+		* with a single write.
+		*
+		* \throws std::runtime_error if no file is opened, or if writing
+		* into the file fails.
 		*/
 		void print();
+
+		/**
+		* \brief Print the TPGGraph given when constructing the
+		* TPGGraphDotExporter into a string.
+		*
+		* \return a const reference to the dot content, which is valid until
+		* the next call to print() or printToString().
+		*/
+		const std::string& printToString();
 	};
 };
 
@@ -42,7 +42,8 @@
 #include <string>
 #include <memory>
 #include <inttypes.h>
-#include <regex>
+#include <unordered_map>
+#include <vector>
 #include <fstream>
 #include <cstdio>
 
@@ -88,7 +89,7 @@ namespace File {
 		* This map is used to associate an unique id to a tpg vertex and to 
 		* keep track of the pointers while restoring the TPGGraph described in a dot file
 		*/
-		std::map<uint64_t, const TPG::TPGVertex*> vertexID;
+		std::unordered_map<uint64_t, const TPG::TPGVertex*> vertexID;
 
 		/**
 		* \brief Map associating pointers to Program to an integer ID.
@@ -96,7 +97,7 @@ namespace File {
 		* This map is used to associate an unique id to a tpg program and to 
 		* keep track of the pointers while restoring the TPGGraph described in a dot file
 		*/
-		std::map<uint64_t, std::shared_ptr<Program::Program>> programID;
+		std::unordered_map<uint64_t, std::shared_ptr<Program::Program>> programID;
 		
 		/**
 		* \brief Map associating pointers to TPGVertex representing actions
@@ -105,14 +106,14 @@ namespace File {
 		* This map is used to ensure that identical actions are not created
 		* more than once.
 		*/
-		std::map<uint64_t, const TPG::TPGVertex*> actionID;
+		std::unordered_map<uint64_t, const TPG::TPGVertex*> actionID;
 
 		/**
 		* \brief Map associating actions to the corresponding action ID
 		*
 		* This map is here is used to access the correct TPGVertex while linking an action.
 		*/
-		std::map<uint64_t, uint64_t> actionLabel;
+		std::unordered_map<uint64_t, uint64_t> actionLabel;
 
 		/**
 		* \brief string used to spot the end of a line in the program description.
@@ -120,193 +121,112 @@ namespace File {
 		static const std::string lineSeparator;
 
 		/**
-		* \brief Contains the regex to identify a team declaration
+		* \brief Size of the buffer used by the pFile stream.
 		*
-		* this regex values "T([0-9]+)\\x20\\x5B.*\\x5D"
-		*
-		* Explanation :
-		*
-		* T([0-9]+)     looks for a T followed by a number. the number will be stored in a group
-		* \\x20\\x5B    looks for a succession of a whitespace and an opening bracket ('[')
-		* .*\\x5D		the following can be any sequence of character terminated by ]
-		*
-		* Example:
-		* T10 [fillcolor="#1199bb"]				Should pass
-		* P0 [fillcolor="#cccccc" shape=point]	Should not pass
+		* A large buffer reduces the number of system calls when importing
+		* large dot files.
 		*/
-		static const std::string teamRegex;
+		static const size_t FILE_BUFFER_SIZE = 1 << 20;
 
 		/**
-		* \brief Contains the regex to identify a program declaration
-		*
-		* this regex values "P([0-9]+)\\x20\\x5B.*\\x5D"
-		*
-		* Explanation :
-		*
-		* P([0-9]+)     looks for a P followed by a number. the number will be stored in a group
-		* \\x20\\x5B    looks for a succession of a whitespace and an opening bracket ('[')
-		* .*\\x5D		the following can be any sequence of character terminated by ]
-		*
-		* Example:
-		* P0 [fillcolor="#cccccc" shape=point]	Should pass
-		* T10 [fillcolor="#1199bb"]				Should not pass
+		* \brief Buffer used by the pFile stream.
 		*/
-		static const std::string programRegex;
+		std::vector<char> fileBuffer;
 
 		/**
-		* \brief contains the regex to identify an instruction declaration
+		* \brief Map associating a Program integer ID to the destination of
+		* the first TPGEdge created with this Program.
 		*
-		* this regex values "I([0-9]+)\\x20\\x5B.*label=\"(.*)\"\\x5D"
-		*
-		* Explanation :
-		*
-		* I([0-9]+)     looks for a I followed by a number. the number will be stored in a group
-		* \\x20\\x5B    looks for a succession of a whitespace and an opening bracket ('[')
-		* .*			the following can be any sequence of character
-		* label=\"	    looks for the label declaration sequence.
-		* (.*)\"\\x5D	stores the content of the label in a group and  look for the ending sequence : "]
-		*
-		* Example:
-		* I0 [shape=box style=invis]			Should pass
-		* P0 [fillcolor="#cccccc" shape=point]	Should not pass
+		* In the dot file, TPGEdge whose Program was already declared only
+		* reference the Program, their destination being the one of the first
+		* TPGEdge of this Program.
 		*/
-		static const std::string instructionRegex;
+		std::unordered_map<uint64_t, const TPG::TPGVertex*> programDestination;
 
 		/**
-		* \brief contains the regex to identify an action declaration
-		*
-		* this regex values "A([0-9]+)\\x20\\x5B.*=\"([0-9]+)\"\\x5D"
-		*
-		* Explanation :
-		*
-		* A([0-9]+)     looks for a A followed by a number. the number will be stored in a group
-		* \\x20\\x5B    looks for a succession of a whitespace and an opening bracket ('[')
-		* .*=\"	        the following can be any sequence of character ending with ="		  
-		* ([0-9]+)	    looks for a number and stores it into the next group
-		* \"\\x5D 		the end of the sequence is made of "]
+		* \brief Parse an unsigned integer number.
 		*
-		* Example:
-		* A0 [shape=box style=invis]			Should pass
-		* P0 [fillcolor="#cccccc" shape=point]	Should not pass
+		* \param[in,out] cursor pointer to the first digit of the number,
+		* moved after its last digit.
+		* \return the parsed number.
+		* \throws std::invalid_argument if the cursor does not point to a
+		* digit.
+		* \throws std::out_of_range if the number exceeds the range of
+		* uint64_t.
 		*/
-		static const std::string actionRegex;
+		static uint64_t parseUnsigned(const char*& cursor);
 
 		/**
-		* \brief contains the regex to identify a Program -> Instruction Link
+		* \brief Parse a signed integer number.
 		*
-		* this regex values "P([0-9]+)\\x20->\\x20I([0-9]+).*"
-		*
-		* Explanation :
-		*
-		* P[0-9]+       looks for a P followed by a number. the number will be stored in a group
-		* \\x20	        looks for a whitespace 
-		* ->			looxs for the sequence '->'
-		* \\x20 	    looks for a whitespace 
-		* I[0-9]+       looks for a I followed by a number. the number will be stored in a group
-		* .*			the following can be any sequence of character
-		*
-		* Example:
-		* P22 -> I22[style=invis]			Should pass
-		* T0 -> P22 -> A11					Should not pass
+		* \param[in,out] cursor pointer to the sign, or to the first digit, of
+		* the number, moved after its last digit.
+		* \return the parsed number.
+		* \throws std::invalid_argument if no digit is found.
+		* \throws std::out_of_range if the number exceeds the range of
+		* int64_t.
 		*/
-		static const std::string linkProgramInstructionRegex;
+		static int64_t parseSigned(const char*& cursor);
 
 		/**
-		* \brief contains the regex to identify a Team -> Program -> Action Link
-		*
-		* this regex values "T([0-9]+)\\x20->\\x20P([0-9]+)\\x20->\\x20A([0-9]+).*"
-		*
-		* Explanation :
-		*
-		* T[0-9]+       looks for a T followed by a number. the number will be stored in a group
-		* \\x20	        looks for a whitespace 
-		* ->			looxs for the sequence '->'
-		* \\x20	        looks for a whitespace 
-		* P[0-9]+       looks for a P followed by a number. the number will be stored in a group
-		* \\x20	        looks for a whitespace 
-		* ->			looxs for the sequence '->'
-		* \\x20	        looks for a whitespace 
-		* A[0-9]+       looks for a A followed by a number. the number will be stored in a group
-		* .*			the following can be any sequence of character
+		* \brief Skip the given token.
 		*
-		* Example:
-		* P22 -> I22[style=invis]			Should not pass
-		* T0 -> P22 -> A11					Should pass
+		* \param[in,out] cursor pointer to the parsed characters, moved after
+		* the token if it is found.
+		* \param[in] token the expected characters.
+		* \return true if the parsed characters start with the token, false
+		* otherwise.
 		*/
-		static const std::string linkProgramActionRegex;
+		static bool skipToken(const char*& cursor, const char* token);
 
 		/**
-		* \brief contains the regex to identify a Team -> Program -> Team Link
-		*
-		* this regex values "T([0-9]+)\\x20->\\x20P([0-9]+)\\x20->\\x20T([0-9]+).*"
-		*
-		* Explanation :
-		*
-		* T[0-9]+       looks for a T followed by a number. the number will be stored in a group
-		* \\x20	        looks for a whitespace 
-		* ->			looxs for the sequence '->'
-		* \\x20	        looks for a whitespace 
-		* P[0-9]+       looks for a P followed by a number. the number will be stored in a group
-		* \\x20	        looks for a whitespace 
-		* ->			looxs for the sequence '->'
-		* \\x20	        looks for a whitespace 
-		* T[0-9]+       looks for a T followed by a number. the number will be stored in a group
-		* *			    the following can be any sequence of character
-		*
-		* Example:
-		* P22 -> I22[style=invis]			Should not pass
-		* T0 -> P22 -> T11					Should pass
-		*/
-		static const std::string linkProgramTeamRegex;
-
-		/**
-		* \brief contains the regex to identify a Team -> Program Link
-		* the outgoing program vertex must already have been linked
-		*
-		* this regex values "T([0-9]+)\\x20->\\x20P([0-9]+)"
-		*
-		* Explanation :
-		*
-		* T[0-9]+       looks for a T followed by a number. the number will be stored in a group
-		* \\x20	        looks for a whitespace 
-		* ->			looxs for the sequence '->'
-		* \\x20	        looks for a whitespace 
-		* P[0-9]+       looks for a P followed by a number. the number will be stored in a group
-		*
-		* Example:
-		* P22 -> I22[style=invis]			Should not pass
-		* T0 -> P22 -> T11					Should pass
-		*/
-		static const std::string addLinkProgramRegex;
-		
-		/**
-		* \brief Reads the content of the parameters in a string and puts it in the line
+		* \brief Reads the content of the parameters and puts it in the line
 		* passed in parameter
 		*
-		* \param[in] str the string to parse
+		* Parameters are stored with the following format:
+		* param_1|param_2|...|param_n|
+		*
+		* \param[in,out] cursor pointer to the first parameter, moved after
+		* the parameters.
+		* \param[in] end pointer to the character ending the parameters.
 		* \param[in] line the line to fill with the parsed informations
-		*/ 
-		void readParameters(std::string & str, Program::Line & line);
+		* \throws std::out_of_range if a parameter exceeds the range of
+		* int16_t.
+		*/
+		void readParameters(const char*& cursor, const char* end, Program::Line& line);
 
 		/**
 		* \brief Reads the content of the operands and puts it in the line
 		* passed in parameter
 		*
-		* \param[in] str the string to parse
+		* Operands are stored with the following format:
+		* op1_param1|op1_param2#...#opN_param1|opN_param2
+		*
+		* \param[in,out] cursor pointer to the first operand, moved after
+		* the operands.
 		* \param[in] line the line to fill with the parsed informations
-		*/ 
-		void readOperands(std::string & str, Program::Line & line);
+		*/
+		void readOperands(const char*& cursor, Program::Line& line);
 
 		/**
-		* \brief Reads the content of a line and puts it in the line
-		* passed in parameter
-		*/ 
-		void readLine(std::smatch & matches);
+		* \brief Reads the content of the lines of a Program and puts it in
+		* this Program.
+		*
+		* \param[in] program the integer ID of the Program.
+		* \param[in] label pointer to the first character of the lines.
+		* \param[in] end pointer to the character ending the lines.
+		* \throws std::invalid_argument if a line is not followed by the
+		* lineSeparator, nor by the end of the lines.
+		* \throws std::out_of_range if a number of a line is out of range.
+		*/
+		void readLine(uint64_t program, const char* label, const char* end);
 
 		/**
 		* \brief Create a program from its dot content.
+		*
+		* \param[in] program the integer ID of the Program.
 		*/
-		void readProgram(std::smatch & matches);
+		void readProgram(uint64_t program);
 
 		/**
 		* \brief dumps the header of the dot file
@@ -317,38 +237,66 @@ namespace File {
 
 		/**
 		* \brief reads and creates a TPGTeam.
+		*
+		* \param[in] team the integer ID of the TPGTeam.
 		*/
-		void readTeam(std::smatch & matches);
+		void readTeam(uint64_t team);
 
 		/**
 		* \brief reads and creates a TPGAction.
+		*
+		* \param[in] action the integer ID of the TPGAction in the dot file.
+		* \param[in] label the action ID of the TPGAction.
 		*/
-		void readAction(std::smatch & matches);
+		void readAction(uint64_t action, uint64_t label);
 
 		/**
 		* \brief reads a link declaration and creates a team to action edge
+		*
+		* \param[in] team the integer ID of the source TPGTeam.
+		* \param[in] program the integer ID of the Program.
+		* \param[in] action the integer ID of the destination TPGAction.
 		*/
-		void readLinkTeamProgramAction(std::smatch & matches);
+		void readLinkTeamProgramAction(uint64_t team, uint64_t program, uint64_t action);
 
 		/**
 		* \brief reads a link declaration and creates a team to team edge
+		*
+		* \param[in] team the integer ID of the source TPGTeam.
+		* \param[in] program the integer ID of the Program.
+		* \param[in] destination the integer ID of the destination TPGTeam.
 		*/
-		void readLinkTeamProgramTeam(std::smatch & matches);
+		void readLinkTeamProgramTeam(uint64_t team, uint64_t program, uint64_t destination);
 
 		/**
 		* \brief reads a link declaration and creates a team to program's destination edge.
+		*
+		* \param[in] team the integer ID of the source TPGTeam.
+		* \param[in] program the integer ID of the Program.
 		*/
-		void readLinkTeamProgram(std::smatch & matches);
-
+		void readLinkTeamProgram(uint64_t team, uint64_t program);
 
 		/**
 		*	\brief reads a single line of the file
-		*   
-		*	\return true if the line read matched any of the line characteristics specified as regexs.
+		*
+		*	Lines of the file are parsed in a single pass, with the following
+		*	shapes (T= Team, A= Action, P= Program, I= Instruction):
+		*	- T10 [fillcolor="#1199bb"]
+		*	- A0 [fillcolor="#ff3366" shape=box ... label="2"]
+		*	- P0 [fillcolor="#cccccc" shape=point]
+		*	- I0 [shape=box style=invis label="..."]
+		*	- P0 -> I0[style=invis]
+		*	- T0 -> P0 -> A11
+		*	- T0 -> P0 -> T11
+		*	- T0 -> P0
+		*
+		*	\return true if the line read matched any of the line shapes.
+		*	\throws std::ifstream::failure if no line could be read.
 		*/
 		bool readLineFromFile();
 
 
+
 	public:
 		/**
 		* \brief Constructor for the importer.
@@ -362,8 +310,10 @@ namespace File {
 		*/
 		TPGGraphDotImporter(const char* filePath, Environment environment, TPG::TPGGraph & tpgref) : 
 			env{environment}, 
-			tpg{tpgref}
+			tpg{tpgref},
+			fileBuffer(FILE_BUFFER_SIZE)
 		{
+			pFile.rdbuf()->pubsetbuf(fileBuffer.data(), fileBuffer.size());
 			pFile.open(filePath);
 			if (!pFile.is_open()) {
 				throw std::runtime_error("Could not open file " + std::string(filePath));
@@ -372,7 +322,8 @@ namespace File {
 		};
 
 		/**
-		* \brief Maximum number of characters that can be read in a single line.
+		* \brief Maximum number of characters that can be read in a single line
+		* of the header of the file.
 		*/
 		static const unsigned int MAX_READ_SIZE=1024;
 
@@ -49,6 +49,9 @@
 
 #include <file/tpgGraphDotExporter.h>
 #include <file/tpgGraphDotImporter.h>
+#include <file/tpgGraphBinaryExporter.h>
+#include <file/tpgGraphBinaryImporter.h>
+#include <file/tpgGraphCheckpointer.h>
 
 #include <instructions/addPrimitiveType.h>  
 #include <instructions/instruction.h>
@@ -72,20 +75,26 @@
 #include <mutator/rng.h>
 #include <mutator/tpgMutator.h>
 
+#include <program/compiledProgram.h>
 #include <program/line.h>  
 #include <program/program.h>  
+#include <program/packedLines.h>
 #include <program/programExecutionEngine.h>
 
 #include <tpg/tpgAction.h>
 #include <tpg/tpgEdge.h>
 #include <tpg/tpgExecutionEngine.h>
+#include <tpg/frozenTPGGraph.h>
+#include <tpg/frozenTPGExecutionEngine.h>
 #include <tpg/tpgGraph.h>
 #include <tpg/tpgTeam.h>
 #include <tpg/tpgVertex.h>
 #include <tpg/policyStats.h>
 
 #include <archive.h>
+#include <archiveRecordingBuffer.h>
 #include <environment.h>
 #include <parameter.h>
+#include <threadPool.h>
 
 #endif
@@ -59,6 +59,22 @@ namespace Instructions {
 	class Instruction {
 
 	public:
+		/**
+		* \brief Signature of the kernel of an Instruction.
+		*
+		* A kernel executes an Instruction directly on raw pointers to its
+		* operands, and on an array of its parameters, without any check. See
+		* getKernel() for more details.
+		*
+		* \param[in] instruction the Instruction whose kernel is called.
+		* \param[in] operands array of getNbOperands() pointers to the
+		* operands, whose types are given by getOperandTypes(). For an array
+		* operand type T[n], the pointer points to the first of the n
+		* contiguous elements.
+		* \param[in] parameters array of getNbParameters() Parameter.
+		* \return the result of the Instruction.
+		*/
+		typedef double (*Kernel)(const Instruction& instruction, const void* const* operands, const Parameter* parameters);
 
 		/// Default virtual destructor for polyphormism.
 		virtual ~Instruction() = default;
@@ -114,6 +130,23 @@ namespace Instructions {
 			const std::vector<std::reference_wrapper<const Parameter>>& params,
 			const std::vector<Data::UntypedSharedPtr>& args) const = 0;
 
+		/**
+		* \brief Get the kernel of the Instruction, if any.
+		*
+		* Calling the kernel of an Instruction is equivalent to calling its
+		* execute() method, but avoids the type checking of operands and the
+		* dereferencing of UntypedSharedPtr. Hence, the compatibility of
+		* operands with the getOperandTypes() must be checked before calling
+		* the kernel. This is notably the case when a Program is lowered into
+		* a Program::CompiledProgram, so that type checking happens only once
+		* for all executions of the Program.
+		*
+		* \return the default implementation returns nullptr, meaning that the
+		* Instruction has no kernel and must be executed with the execute()
+		* method.
+		*/
+		virtual Kernel getKernel() const;
+
 	protected:
 		/**
 		* \brief Protected constructor to force the class abstract nature.
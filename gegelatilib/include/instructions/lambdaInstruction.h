@@ -39,6 +39,8 @@
 
 #include <functional>
 #include <typeinfo>
+#include <tuple>
+#include <utility>
 
 #include "data/untypedSharedPtr.h"
 #include "instructions/instruction.h"
@@ -54,6 +56,11 @@ namespace Instructions {
 	*
 	* Each template parameter corresponds to an argument of the function given
 	* to the LambdaInstruction constructor, specifying its type.
+	*
+	* When the function given to the constructor is convertible into a raw
+	* function pointer, which is the case for lambdas without capture, the
+	* kernel of the LambdaInstruction calls this function directly instead of
+	* going through a std::function.
 	*/
 	template< typename First, typename... Rest>
 	class LambdaInstruction : public Instructions::Instruction {
@@ -65,6 +72,14 @@ namespace Instructions {
 		*/
 		const std::function<double(const First, const Rest...)> func;
 
+		/**
+		* \brief Raw pointer to the function executed for this Instruction.
+		*
+		* This pointer is nullptr when the function given to the constructor
+		* cannot be converted into a raw function pointer.
+		*/
+		double (* const funcPtr)(First, Rest...);
+
 	public:
 		/**
 		* \brief delete the default constructor.
@@ -74,11 +89,14 @@ namespace Instructions {
 		/**
 		* \brief Constructor for the LambdaInstruction.
 		*
-		* \param[in] function the c++ std::function that will be executed for
+		* \param[in] function the c++ function that will be executed for
 		* this Instruction. The function must have the same types in its argument
 		* list as specified by the template parameters. (checked at compile time)
+		* The function can be given as a std::function, or as any callable
+		* object convertible into a std::function.
 		*/
-		LambdaInstruction(std::function<double(First, Rest...)> function) : func{ function } {
+		template <typename F>
+		LambdaInstruction(F function) : func{ function }, funcPtr{ getFunctionPointer(function) } {
 
 			this->operandTypes.push_back(typeid(First));
 			// Fold expression to push all other types
@@ -128,6 +146,25 @@ namespace Instructions {
 			return result;
 		};
 
+		/**
+		* \brief Inherited from Instruction
+		*
+		* The kernel calls the function of the LambdaInstruction directly,
+		* bypassing the execute() method. Hence, it is only returned for
+		* instances of the LambdaInstruction class itself. Derived classes,
+		* which may override execute(), have no kernel unless they override
+		* this method too.
+		*/
+		virtual Instruction::Kernel getKernel() const override {
+			if (typeid(*this) != typeid(LambdaInstruction<First, Rest...>)) {
+				return Instruction::getKernel();
+			}
+			if (this->funcPtr != nullptr) {
+				return &LambdaInstruction::kernel<true>;
+			}
+			return &LambdaInstruction::kernel<false>;
+		};
+
 	private:
 		/**
 		* \brief Function to retrieve the shared pointer from any datatype in the
@@ -152,6 +189,75 @@ namespace Instructions {
 				return (args.at(idx).getSharedPointer<const std::remove_all_extents_t<T>[]>()).get();
 			};
 		};
+
+		/**
+		* \brief Get a raw function pointer from the given function, if
+		* possible.
+		*
+		* \param[in] function the function given to the constructor.
+		* \return the function converted into a raw function pointer, or
+		* nullptr if the conversion is not possible.
+		*/
+		template<typename F>
+		static auto getFunctionPointer(const F& function) -> double (*)(First, Rest...) {
+			if constexpr (std::is_convertible<F, double (*)(First, Rest...)>::value) {
+				return function;
+			}
+			else {
+				return nullptr;
+			}
+		};
+
+		/**
+		* \brief Function to retrieve an argument from a raw pointer in the
+		* kernel.
+		*
+		* Template parameter T is the Type of the retrieved argument.
+		*
+		* \param[in] ptr the raw pointer to the argument.
+		* \return the appropriate argument for this->func.
+		*/
+		template<typename T>
+		static constexpr auto getDataFromRawPointer(const void* ptr) {
+			if constexpr (!std::is_array<T>::value) {
+				return *static_cast<const T*>(ptr);
+			}
+			else {
+				return static_cast<const std::remove_all_extents_t<T>*>(ptr);
+			};
+		};
+
+		/**
+		* \brief Call the function of the LambdaInstruction with arguments
+		* retrieved from raw pointers.
+		*
+		* \tparam UseFuncPtr whether the funcPtr or the func attribute is
+		* called.
+		* \tparam Idx indexes of the arguments.
+		* \param[in] operands the raw pointers to the arguments.
+		* \return the result of the function.
+		*/
+		template<bool UseFuncPtr, size_t... Idx>
+		double callWithRawPointers(const void* const* operands, std::index_sequence<Idx...>) const {
+			if constexpr (UseFuncPtr) {
+				return this->funcPtr(getDataFromRawPointer<std::tuple_element_t<Idx, std::tuple<First, Rest...>>>(operands[Idx])...);
+			}
+			else {
+				return this->func(getDataFromRawPointer<std::tuple_element_t<Idx, std::tuple<First, Rest...>>>(operands[Idx])...);
+			}
+		};
+
+		/**
+		* \brief Kernel of the LambdaInstruction.
+		*
+		* \tparam UseFuncPtr whether the funcPtr or the func attribute is
+		* called.
+		* See Instruction::Kernel for the parameters.
+		*/
+		template<bool UseFuncPtr>
+		static double kernel(const Instruction& instruction, const void* const* operands, const Parameter*) {
+			return static_cast<const LambdaInstruction&>(instruction).callWithRawPointers<UseFuncPtr>(operands, std::index_sequence_for<First, Rest...>());
+		};
 	};
 };
 
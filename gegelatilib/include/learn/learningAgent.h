@@ -38,6 +38,7 @@
 #define LEARNING_AGENT_H
 
 #include <map>
+#include <memory>
 
 #include "instructions/set.h"
 #include "environment.h"
@@ -45,6 +46,7 @@
 #include "tpg/tpgGraph.h"
 #include "tpg/tpgExecutionEngine.h"
 #include "mutator/mutationParameters.h"
+#include "file/tpgGraphCheckpointer.h"
 
 #include "learn/evaluationResult.h"
 #include "learn/learningParameters.h"
@@ -94,6 +96,15 @@ namespace Learn {
 		/// Random Number Generator for this Learning Agent
 		Mutator::RNG rng;
 
+		/// Checkpointer saving the TPGGraph during the train() method.
+		std::unique_ptr<File::TPGGraphCheckpointer> checkpointer;
+
+		/// Number of generations between two checkpoints of the TPGGraph.
+		uint64_t checkpointPeriod = 0;
+
+		/// Whether identical Programs are shared after each population.
+		bool programDeduplication = false;
+
 	public:
 		/**
 		* \brief Constructor for LearningAgent.
@@ -244,6 +255,39 @@ namespace Learn {
 		*/
 		uint64_t train(volatile bool& altTraining, bool printProgressBar);
 
+		/**
+		* \brief Periodically save the TPGGraph into a dot file during
+		* training.
+		*
+		* When a checkpoint is set, the train() method saves a snapshot of
+		* the TPGGraph every given number of generations, with a
+		* File::TPGGraphCheckpointer. The snapshot is exported by a
+		* background thread while the training continues. The train()
+		* method waits for the end of the last export before returning.
+		*
+		* \param[in] filePath path to the checkpoint file.
+		* \param[in] period number of generations between two checkpoints.
+		* A value of 0 disables the checkpoints.
+		*/
+		void setCheckpoint(const char* filePath, uint64_t period);
+
+		/**
+		* \brief Share identical Programs of the TPGGraph during training.
+		*
+		* When enabled, Programs with the same effective code are shared by
+		* the TPGEdge of the TPGGraph after each population of the TPGGraph,
+		* with TPG::TPGGraph::internPrograms(). The evaluation of a shared
+		* Program then benefits from a single entry of the bid cache.
+		*
+		* Since the Archive records the results of a shared Program as
+		* those of a single Program, enabling the deduplication changes the
+		* outcome of the neutrality tests of the mutations, and hence the
+		* training results.
+		*
+		* \param[in] enable whether the deduplication is enabled.
+		*/
+		void setProgramDeduplication(bool enable);
+
 		/**
 		* \brief Update the bestRoot and resultsPerRoot attributes.
 		*
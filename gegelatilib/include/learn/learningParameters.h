@@ -69,6 +69,16 @@ namespace Learn {
 		/// Number of registers for the Program execution
 		size_t nbRegisters = 8;
 		/**
+		* \brief Maximum number of Program bids memoized during the
+		* evaluation of roots.
+		*
+		* When several roots share Program and are evaluated on identical
+		* inputs, memoizing the bids of Program avoids executing them
+		* several times. See TPG::TPGExecutionEngine::bidCache.
+		* A value of 0 deactivates the memoization.
+		*/
+		size_t bidCacheSize = 0;
+		/**
 		* \brief Number of threads (ParallelLearningAgent only)
 		*
 		* Integer parameter controlling the number of
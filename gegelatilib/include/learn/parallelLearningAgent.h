@@ -37,11 +37,14 @@
 #ifndef PARALLEL_LEARNING_AGENT
 #define PARALLEL_LEARNING_AGENT
 
-#include <thread>
-#include <mutex>
-#include <queue>
+#include <map>
+#include <memory>
+#include <vector>
 
 #include "instructions/set.h"
+#include "archiveRecordingBuffer.h"
+#include "environment.h"
+#include "threadPool.h"
 #include "tpg/tpgExecutionEngine.h"
 
 #include "learn/evaluationResult.h"
@@ -66,47 +69,64 @@ namespace Learn {
 		const uint64_t maxNbThreads;
 
 		/**
-		* \brief Method for evaluating all roots with parallelism.
+		* \brief ThreadPool used for all parallel computations.
 		*
-		* \param[in] generationNumber the integer number of the current generation.
-		* \param[in] mode the LearningMode to use during the policy evaluation.
-		* \param[in] results Map to store the resulting score of evaluated roots.
+		* The threads of this ThreadPool are created once with the
+		* ParallelLearningAgent and are reused for evaluating roots and for
+		* mutating Programs, at each generation.
 		*/
-		void evaluateAllRootsInParallel(uint64_t generationNumber, LearningMode mode, std::multimap<std::shared_ptr<EvaluationResult>, const TPG::TPGVertex*>& results);
+		ThreadPool threadPool;
 
 		/**
-		* \brief Function implementing the behavior of slave threads during
-		* parallel evaluation of roots.
+		* \brief Private resources used by a thread for evaluating roots.
+		*/
+		struct EvaluationContext {
+			/// Private copy of the LearningEnvironment.
+			std::unique_ptr<LearningEnvironment> learningEnvironment;
+
+			/// Environment built with the data sources of the private
+			/// LearningEnvironment.
+			std::unique_ptr<Environment> environment;
+
+			/// TPGExecutionEngine executing TPG within the Environment.
+			std::unique_ptr<TPG::TPGExecutionEngine> tee;
+
+			/// Buffer for the recordings of evaluated roots, in training mode.
+			std::unique_ptr<ArchiveRecordingBuffer> archiveBuffer;
+		};
+
+		/**
+		* \brief EvaluationContext of each thread of the threadPool, indexed by
+		* thread index.
 		*
-		* \param[in] generationNumber the integer number of the current generation.
-		* \param[in] mode the LearningMode to use during the policy evaluation.
-		* \param[in,out] rootsToProcess Ordered list of root TPGVertex to
-		* process, stored as a pair with an id filling the archiveMap.
-		* \param[in] rootsToProcessMutex Mutex protecting the rootsToProcess
-		* \param[in] resultsPerRootMap Map to store the resulting score of evaluated roots.
-		* \param[in] resultsPerRootMapMutex Mutex protecting the results.
-		* \param[in] archiveSeeds Seed values for the archiving process of each root.
-		* \param[in,out] archiveMap Map storing the exhaustiveArchive to be merged.
-		* \param[in] archiveMapMutex Mutex protecting the archiveMap.
+		* Each EvaluationContext is created the first time its thread evaluates
+		* a root, and is reused in all following generations. Hence, the
+		* LearningEnvironment is cloned at most once per thread.
 		*/
-		void slaveEvalRootThread(uint64_t generationNumber, LearningMode mode,
-			std::queue<std::pair<uint64_t, const TPG::TPGVertex*>>& rootsToProcess, std::mutex& rootsToProcessMutex,
-			std::map<uint64_t, std::pair<std::shared_ptr<EvaluationResult>, const TPG::TPGVertex*>>& resultsPerRootMap, std::mutex& resultsPerRootMapMutex,
-			std::map<uint64_t, size_t>& archiveSeeds,
-			std::map<uint64_t, Archive*>& archiveMap, std::mutex& archiveMapMutex);
+		std::vector<EvaluationContext> evaluationContexts;
 
 		/**
-		* \brief Method to merge several Archive created in parallel
-		* threads.
+		* \brief Get the EvaluationContext of a thread, ready for evaluating
+		* the roots of a new call to evaluateAllRoots.
 		*
-		* The purpose of this method is to merhe several Archive
-		* into the archive attribute of this ParallelLearningAgent. This
-		* method is the key to obtain deterministic Archive even in a parallel
-		* context.
+		* The EvaluationContext is created if needed. Otherwise, memoized
+		* bids of its TPGExecutionEngine are cleared, since Program of
+		* the previous generation may have been freed, and its
+		* ArchiveRecordingBuffer is cleared.
 		*
-		* \param[in,out] archiveMap Map storing the Archive to be merged.
+		* \param[in] threadIdx the index of the thread in the threadPool.
+		* \return a reference to the EvaluationContext of the thread.
 		*/
-		void mergeArchiveMap(std::map<uint64_t, Archive*>& archiveMap);
+		EvaluationContext& getEvaluationContext(uint64_t threadIdx);
+
+		/**
+		* \brief Method for evaluating all roots with parallelism.
+		*
+		* \param[in] generationNumber the integer number of the current generation.
+		* \param[in] mode the LearningMode to use during the policy evaluation.
+		* \param[in] results Map to store the resulting score of evaluated roots.
+		*/
+		void evaluateAllRootsInParallel(uint64_t generationNumber, LearningMode mode, std::multimap<std::shared_ptr<EvaluationResult>, const TPG::TPGVertex*>& results);
 
 	public:
 		/**
@@ -120,7 +140,7 @@ namespace Learn {
 		* \param[in] p The LearningParameters for the LearningAgent.
 		*/
 		ParallelLearningAgent(LearningEnvironment& le, const Instructions::Set& iSet, const LearningParameters& p) :
-			LearningAgent(le, iSet, p), maxNbThreads{ p.nbThreads } {};
+			LearningAgent(le, iSet, p), maxNbThreads{ p.nbThreads }, threadPool(p.nbThreads), evaluationContexts(threadPool.getNbThreads()) {};
 
 		/**
 		* \brief Evaluate all root TPGVertex of the TPGGraph.
@@ -140,6 +160,17 @@ namespace Learn {
 		*/
 		std::multimap<std::shared_ptr<EvaluationResult>, const TPG::TPGVertex*> evaluateAllRoots(uint64_t generationNumber, LearningMode mode) override;
 
+		/**
+		* \brief Clear the EvaluationContext of all threads.
+		*
+		* This method must be called when the LearningEnvironment given to
+		* the constructor is modified in a way that should be reflected in the
+		* private copies used by the threads, for example when its data sources
+		* are changed. New copies of the LearningEnvironment are then created
+		* the next time roots are evaluated in parallel.
+		*/
+		void clearEvaluationContexts();
+
 		/// Inherited from LearningAgent
 		void trainOneGeneration(uint64_t generationNumber) override;
 	};
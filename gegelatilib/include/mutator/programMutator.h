@@ -149,8 +149,8 @@ namespace Mutator {
 		* Because of the probabilistic nature of this function, it may happen
 		* that no alteration is peformed.
 		*
-		* After altering the Program, its intron Line are identified with a
-		* call to Program::identifyIntrons().
+		* After altering the Program, its intron Line are updated with a
+		* call to Program::updateIntrons().
 		*
 		* \param[in,out] p the Program whose line will be altered.
 		* \param[in] params MutationParameters for the mutation.
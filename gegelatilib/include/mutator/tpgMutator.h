@@ -40,6 +40,7 @@
 
 #include "mutator/mutationParameters.h"
 #include "archive.h"
+#include "threadPool.h"
 #include "tpg/tpgGraph.h"
 
 namespace Mutator {
@@ -222,6 +223,12 @@ namespace Mutator {
 		* \brief Mutate the behavior of a Program and ensure its unicity
 		* against the given Archive.
 		*
+		* Mutations leading to the effective code of a Program already found
+		* not unique are rejected without executing the Program on the
+		* Archive. Rejected effective codes are indexed with
+		* Program::getEffectiveCodeHash(), and compared in full when their
+		* hash matches.
+		*
 		* \param[in,out] newProg Program whose behavior is being mutated.
 		* \param[in] params Probability parameters for the mutation.
 		* \param[in] archive Archive used to assess the uniqueness of the
@@ -246,6 +253,21 @@ namespace Mutator {
 		*/
 		void mutateNewProgramBehaviors(const uint64_t& maxNbThreads, std::list<std::shared_ptr<Program::Program>>& newPrograms, Mutator::RNG& rng, const Mutator::MutationParameters& params, const Archive& archive);
 
+		/**
+		* \brief Function mutating the behavior of the given list of Program.
+		*
+		* Same as the previous function, except that the Program are mutated
+		* using the threads of an existing ThreadPool.
+		*
+		* \param[in] threadPool ThreadPool used for parallel execution.
+		* \param[in] newPrograms List of new Program to mutate.
+		* \param[in] rng Random Number Generator used in the mutation process.
+		* \param[in] params Probability parameters for the mutation.
+		* \param[in] archive Archive used to assess the uniqueness of the
+		* mutated Program behavior.
+		*/
+		void mutateNewProgramBehaviors(ThreadPool& threadPool, std::list<std::shared_ptr<Program::Program>>& newPrograms, Mutator::RNG& rng, const Mutator::MutationParameters& params, const Archive& archive);
+
 		/**
 		* \brief Create new root TPGTeam within the TPGGraph.
 		*
@@ -275,6 +297,21 @@ namespace Mutator {
 		*   - `n > 1`: Set the number of threads explicitly.
 		*/
 		void populateTPG(TPG::TPGGraph& graph, const Archive& archive, const Mutator::MutationParameters& params, Mutator::RNG& rng, uint64_t maxNbThreads = std::thread::hardware_concurrency());
+
+		/**
+		* \brief Create new root TPGTeam within the TPGGraph.
+		*
+		* Same as the previous function, except that the behavior of new
+		* Program is mutated using the threads of an existing ThreadPool.
+		*
+		* \param[in,out] graph the TPGGraph to mutate.
+		* \param[in] archive Archive used to assess the uniqueness of the
+		*            mutated Program behavior.
+		* \param[in] params Probability parameters for the mutation.
+		* \param[in] rng Random Number Generator used in the mutation process.
+		* \param[in] threadPool ThreadPool used for parallel execution.
+		*/
+		void populateTPG(TPG::TPGGraph& graph, const Archive& archive, const Mutator::MutationParameters& params, Mutator::RNG& rng, ThreadPool& threadPool);
 	};
 };
 
@@ -0,0 +1,187 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2020) :
+ *
+ * Karol Desnos <kdesnos@insa-rennes.fr> (2020)
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+#ifndef COMPILED_PROGRAM_H
+#define COMPILED_PROGRAM_H
+
+#include <cstdint>
+#include <typeinfo>
+#include <vector>
+#include <exception>
+
+#include "parameter.h"
+#include "instructions/instruction.h"
+
+namespace Program {
+	// Declare class to make it usable as an argument.
+	class Program;
+
+	/**
+	* \brief Class storing a Program lowered into a flat bytecode ready for
+	* execution.
+	*
+	* When a Program is executed, each of its Line must be interpreted to
+	* retrieve its Instruction within the Instructions::Set of the
+	* Environment, and to scale the location of each of its operands to the
+	* address space of the accessed DataHandler. Since these operations give
+	* the same result for each execution of a Program, they can be done once
+	* when building a CompiledProgram, instead of once per execution.
+	*
+	* Since the compatibility of operand types with each Instruction is
+	* checked when building the CompiledProgram, Instructions providing a
+	* kernel can be executed without further type checking.
+	*
+	* A CompiledProgram contains only the non-intron Line of the Program it
+	* was built from. Its content is stored in contiguous vectors to make the
+	* execution of the CompiledProgram as cache-friendly as possible.
+	*
+	* A CompiledProgram is not updated when its Program is modified. Keeping
+	* it up to date is the responsibility of the Program class, see
+	* Program::getCompiledProgram().
+	*/
+	class CompiledProgram {
+	public:
+		/**
+		* \brief Structure storing an operand of a CompiledProgram::Line.
+		*/
+		typedef struct Operand {
+			/// Index of the data source (0 for registers) accessed by the operand.
+			uint64_t dataSourceIndex;
+
+			/// Location of the operand, already scaled to the address space of
+			/// the data source for the operand type.
+			uint64_t location;
+
+			/// Type of the operand.
+			const std::type_info* type;
+		} Operand;
+
+		/**
+		* \brief Structure storing a Line of a CompiledProgram.
+		*/
+		typedef struct Line {
+			/// Instruction executed by the Line (nullptr for a faulty Line).
+			const Instructions::Instruction* instruction;
+
+			/**
+			* \brief Kernel of the Instruction, if any.
+			*
+			* The kernel is set only if the Instruction has one, and if all
+			* operands of the Line can be accessed directly with
+			* Data::DataHandler::getDataPointerAt(). Otherwise, it is nullptr
+			* and the Line must be executed with Instructions::Instruction::execute().
+			*/
+			Instructions::Instruction::Kernel kernel;
+
+			/// Index of the register where the result of the Line is written.
+			uint64_t destinationIndex;
+
+			/// Index of the first Operand of the Line in the operands vector.
+			size_t operandsOffset;
+
+			/// Number of operands of the Line.
+			size_t nbOperands;
+
+			/// Index of the first Parameter of the Line in the parameters
+			/// vector.
+			size_t parametersOffset;
+
+			/// Number of parameters of the Line.
+			size_t nbParameters;
+
+			/**
+			* \brief Exception caught while lowering the Line.
+			*
+			* A Line referencing an Instruction, or a data source, absent from
+			* the Environment cannot be executed. Instead of aborting the
+			* lowering of the whole Program, the exception is kept and rethrown
+			* when executing the Line.
+			*/
+			std::exception_ptr fault;
+		} Line;
+
+	protected:
+		/// Non-intron lines of the Program, in execution order.
+		std::vector<Line> lines;
+
+		/// Operands of all lines, in the order of the lines.
+		std::vector<Operand> operands;
+
+		/// Parameters of all lines, in the order of the lines.
+		std::vector<Parameter> parameters;
+
+		/// Delete the default constructor.
+		CompiledProgram() = delete;
+
+	public:
+		/**
+		* \brief Constructor lowering the given Program.
+		*
+		* Instructions are resolved within the Instructions::Set of the
+		* Environment of the Program, and operand locations are scaled with
+		* the DataHandler of this Environment.
+		*
+		* \param[in] prog the Program to lower.
+		*/
+		CompiledProgram(const Program& prog);
+
+		/**
+		* \brief Get the lowered lines of the CompiledProgram.
+		*
+		* \return a const reference to the lines attribute.
+		*/
+		const std::vector<Line>& getLines() const;
+
+		/**
+		* \brief Get the operands of the given Line.
+		*
+		* \param[in] line a Line of this CompiledProgram.
+		* \return a pointer to the first of the line.nbOperands Operand of
+		* the Line.
+		*/
+		const Operand* getOperands(const Line& line) const;
+
+		/**
+		* \brief Get the parameters of the given Line.
+		*
+		* \param[in] line a Line of this CompiledProgram.
+		* \return a pointer to the first of the line.nbParameters Parameter
+		* of the Line.
+		*/
+		const Parameter* getParameters(const Line& line) const;
+	};
+};
+
+#endif
@@ -42,6 +42,8 @@
 #include <cstring>
 
 namespace Program {
+	class Program;
+
 	/**
 	* Class used to store information of a single line of a Program.
 	*/
@@ -57,6 +59,10 @@ namespace Program {
 		/// index of the register to which the result of this line should be written.
 		uint64_t destinationIndex;
 
+		/// Whether the parameters and operands arrays were allocated by the
+		/// Line, or are stored in a memory block provided by its Program.
+		const bool ownsData;
+
 		/// Array storing the parameters for this instruction.
 		Parameter* const parameters;
 
@@ -67,6 +73,60 @@ namespace Program {
 		/// Delete the default constructor.
 		Line() = delete;
 
+		/// The Program constructs its Line in place.
+		friend class Program;
+
+		/**
+		* \brief Get the size of the memory block storing the operands and
+		* parameters of a Line constructed in place.
+		*
+		* \param[in] env the Environment of the Line.
+		* \return the size of the block in bytes.
+		*/
+		static size_t getDataSize(const Environment& env) {
+			return env.getMaxNbOperands() * sizeof(std::pair<uint64_t, uint64_t>) + env.getMaxNbParameters() * sizeof(Parameter);
+		}
+
+		/**
+		* \brief Constructor for a Line whose operands and parameters are
+		* stored in a given memory block.
+		*
+		* Operands are stored at the beginning of the block, followed by the
+		* parameters. The block is filled with 0 bits.
+		*
+		* \param[in] env the const reference to the Environment for this Program::Line.
+		* \param[in] data a memory block of getDataSize() bytes, aligned for
+		* operands, and outliving the Line.
+		*/
+		Line(const Environment& env, void* data) :
+			environment{ env },
+			instructionIndex{ 0 },
+			destinationIndex{ 0 },
+			ownsData{ false },
+			parameters{ (Parameter*)((std::pair<uint64_t, uint64_t>*)data + env.getMaxNbOperands()) },
+			operands{ (std::pair<uint64_t, uint64_t>*)data }{
+			memset(data, 0, getDataSize(env));
+		};
+
+		/**
+		* \brief Copy constructor for a Line whose operands and parameters
+		* are stored in a given memory block.
+		*
+		* \param[in] other the const reference to the copied Program::Line.
+		* \param[in] data a memory block of getDataSize() bytes, aligned for
+		* operands, and outliving the Line.
+		*/
+		Line(const Line& other, void* data) :
+			environment{ other.environment },
+			instructionIndex{ other.instructionIndex },
+			destinationIndex{ other.destinationIndex },
+			ownsData{ false },
+			parameters{ (Parameter*)((std::pair<uint64_t, uint64_t>*)data + other.environment.getMaxNbOperands()) },
+			operands{ (std::pair<uint64_t, uint64_t>*)data }{
+			memcpy((void*)this->operands, other.operands, this->environment.getMaxNbOperands() * sizeof(std::pair<uint64_t, uint64_t>));
+			memcpy((void*)this->parameters, other.parameters, this->environment.getMaxNbParameters() * sizeof(Parameter));
+		};
+
 	public:
 		/**
 		* \brief Constructor for a Line of a program.
@@ -79,6 +139,7 @@ namespace Program {
 			environment{ env },
 			instructionIndex{ 0 },
 			destinationIndex{ 0 },
+			ownsData{ true },
 			parameters{ (Parameter*)calloc(env.getMaxNbParameters(), sizeof(Parameter)) },
 			operands{ (std::pair<uint64_t, uint64_t>*)calloc(env.getMaxNbOperands(), sizeof(std::pair<uint64_t, uint64_t>)) }{};
 
@@ -94,6 +155,7 @@ namespace Program {
 			environment{ other.environment },
 			instructionIndex{ other.instructionIndex },
 			destinationIndex{ other.destinationIndex },
+			ownsData{ true },
 			parameters{ (Parameter*)calloc(other.environment.getMaxNbParameters(), sizeof(Parameter)) },
 			operands{ (std::pair<uint64_t, uint64_t>*)calloc(other.environment.getMaxNbOperands(), sizeof(std::pair<uint64_t, uint64_t>)) }{
 			// Check needed to avoid compilation warnings
@@ -119,11 +181,14 @@ namespace Program {
 		/**
 		* Destructor of a Program::Line.
 		*
-		* Dealocates the memory allocated for attributes.
+		* Dealocates the memory allocated for attributes, unless they are
+		* stored in a memory block of the Program of the Line.
 		*/
 		~Line() {
-			free((void*)this->parameters);
-			free((void*)this->operands);
+			if (this->ownsData) {
+				free((void*)this->parameters);
+				free((void*)this->operands);
+			}
 		}
 
 		/**
@@ -0,0 +1,201 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2020) :
+ *
+ * Karol Desnos <kdesnos@insa-rennes.fr> (2020)
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+#ifndef PACKED_LINES_H
+#define PACKED_LINES_H
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "environment.h"
+#include "parameter.h"
+#include "program/program.h"
+
+namespace Program {
+	/**
+	* \brief Class packing the Line of a Program in a single bit-packed buffer.
+	*
+	* Contrary to the Program::Line, which stores each of its attributes in a
+	* separate 64-bit variable or heap-allocated array, the PackedLines stores
+	* each line as a record of exactly LineSize::totalNbBits bits, as computed
+	* by the Environment. Records of successive lines are contiguous within a
+	* single buffer of 64-bit words.
+	*
+	* Within a record, fields are stored in the following order: the
+	* instructionIndex, the destinationIndex, the operands pairs (dataSource
+	* index followed by location), and the parameters.
+	*
+	* The PackedLines is a serialization format: lines are packed from a
+	* Program, or loaded from a buffer, and unpacked into a Program. It is
+	* used by the File::TPGGraphBinaryExporter and the
+	* File::TPGGraphBinaryImporter. Program::Program keeps storing its lines
+	* as Program::Line, which are not replaced with a PackedLines.
+	*/
+	class PackedLines {
+	protected:
+		/// Environment within which the lines are executed.
+		const Environment& environment;
+
+		/// Number of bits of the instructionIndex field.
+		const uint64_t nbInstructionBits;
+
+		/// Number of bits of the destinationIndex field.
+		const uint64_t nbDestinationBits;
+
+		/// Number of bits of the dataSource index of an operand.
+		const uint64_t nbDataSourceBits;
+
+		/// Number of bits of the location of an operand.
+		const uint64_t nbLocationBits;
+
+		/// Number of bits of a line record.
+		const uint64_t nbLineBits;
+
+		/// Number of lines in the store.
+		uint64_t nbLines;
+
+		/// Buffer storing the line records.
+		std::vector<uint64_t> words;
+
+		/**
+		* \brief Get the number of bits needed to encode values in [0, nbValues[.
+		*/
+		static uint64_t getNbBitsFor(uint64_t nbValues);
+
+		/**
+		* \brief Read a field of the buffer.
+		*
+		* \param[in] bitOffset position of the first bit of the field.
+		* \param[in] nbBits number of bits of the field (at most 64).
+		* \return the value of the field.
+		*/
+		uint64_t readBits(uint64_t bitOffset, uint64_t nbBits) const;
+
+		/**
+		* \brief Write a field of the buffer.
+		*
+		* \param[in] bitOffset position of the first bit of the field.
+		* \param[in] nbBits number of bits of the field (at most 64).
+		* \param[in] value the new value of the field.
+		* \return false if the value can not be encoded on nbBits bits, in
+		* which case the buffer is not modified.
+		*/
+		bool writeBits(uint64_t bitOffset, uint64_t nbBits, uint64_t value);
+
+		/// Delete the default constructor.
+		PackedLines() = delete;
+
+		/**
+		* \brief Constructor for an empty PackedLines.
+		*
+		* \param[in] env the Environment within which the lines are executed.
+		*/
+		PackedLines(const Environment& env);
+
+	public:
+		/**
+		* \brief Constructor packing all the lines of a Program.
+		*
+		* \param[in] program the Program whose lines are packed.
+		* \throw std::out_of_range if a value of a Line can not be encoded
+		* on the number of bits given by the LineSize of the Environment.
+		* This may only happen for values set without checks.
+		*/
+		PackedLines(const Program& program);
+
+		/**
+		* \brief Constructor copying line records from a buffer.
+		*
+		* This constructor is used to load lines previously stored from the
+		* buffer of a PackedLines, for example by a
+		* File::TPGGraphBinaryExporter.
+		*
+		* \param[in] env the Environment within which the lines are executed.
+		* \param[in] nbLines the number of lines stored in the buffer.
+		* \param[in] buffer the line records, as returned by getWords().
+		* \param[in] nbWords the number of 64-bit words of the buffer.
+		* \throw std::invalid_argument if nbWords is not the number of words
+		* needed to store nbLines lines in the given Environment.
+		*/
+		PackedLines(const Environment& env, uint64_t nbLines, const uint64_t* buffer, uint64_t nbWords);
+
+		/**
+		* Disable PackedLines default assignment operator.
+		*
+		* As for the Program, there is no need for an assignment operator.
+		*/
+		PackedLines& operator=(const PackedLines& other) = delete;
+
+		/// Get the Environment of the PackedLines.
+		const Environment& getEnvironment() const;
+
+		/// Get the number of lines in the PackedLines.
+		uint64_t getNbLines() const;
+
+		/**
+		* \brief Get the number of 64-bit words allocated for the lines.
+		*
+		* \return the size of the buffer storing the line records.
+		*/
+		uint64_t getNbWords() const;
+
+		/**
+		* \brief Get the buffer storing the line records.
+		*
+		* Bits of the last word following the last line record are always 0.
+		*
+		* \return a pointer to the getNbWords() words of the buffer.
+		*/
+		const uint64_t* getWords() const;
+
+		/**
+		* \brief Append the lines of the PackedLines to a Program.
+		*
+		* Lines are added at the end of the Program, in the same order. The
+		* intron property of the Program lines is not updated.
+		*
+		* \param[in,out] program the Program whose Environment must be the
+		* one of the PackedLines.
+		* \param[in] check whether the values of the lines should be checked
+		* against the Environment, as in the setters of Program::Line.
+		* \return false if check is true and a value of a line is invalid,
+		* true otherwise. In both cases, all lines are added to the Program.
+		*/
+		bool unpack(Program& program, const bool check = false) const;
+	};
+};
+
+#endif
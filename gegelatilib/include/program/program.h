@@ -38,9 +38,13 @@
 
 #include <vector>
 #include <algorithm>
+#include <memory>
+#include <new>
+#include <mutex>
 
 #include "environment.h"
 #include "program/line.h"
+#include "program/compiledProgram.h"
 
 namespace Program {
 	/**
@@ -54,42 +58,256 @@ namespace Program {
 
 
 		/**
-		* \brief Lines of the program and intron property.
+		* \brief Size in bytes of a slot of the lineBlocks.
 		*
-		* Each element of this vector stores a pointer to a Line, and a
-		* boolean value indicating whether this Line is an Intron whithin the
-		* program.
+		* Each slot stores a Line followed by its operands and parameters.
+		*/
+		const size_t lineSlotSize;
+
+		/**
+		* \brief Memory blocks storing the Line of the Program in place.
+		*
+		* Blocks are never moved nor freed before the destruction of the
+		* Program, so that references returned by addNewLine() and getLine()
+		* remain valid when other Lines are added, removed or swapped. When
+		* a Program is copied, all its Lines are stored contiguously, in
+		* order, in a single block.
+		*/
+		std::vector<std::unique_ptr<char[]>> lineBlocks;
+
+		/// Number of slots of the last block of the lineBlocks.
+		uint64_t lastLineBlockCapacity;
+
+		/// Number of slots of the last block of the lineBlocks already used.
+		uint64_t lastLineBlockSize;
+
+		/// Slots of the lineBlocks freed by removed Lines.
+		std::vector<char*> freeLineSlots;
+
+		/**
+		* \brief Get a slot of the lineBlocks for a new Line.
+		*
+		* Slots freed by removed Lines are reused first. If none is
+		* available, and if the last block is full, a new block is allocated
+		* with at least nbSlots slots.
+		*
+		* \param[in] nbSlots the minimum number of slots of a new block.
+		* \return a pointer to the slot.
+		*/
+		char* allocateLineSlot(uint64_t nbSlots);
+
+		/**
+		* \brief Destroy a Line stored in the lineBlocks and free its slot.
+		*
+		* \param[in] line the destroyed Line.
+		*/
+		void destroyLine(Line* line);
+
+		/**
+		* \brief Lines of the program, in order.
+		*
+		* Pointed Lines are stored in the lineBlocks of the Program.
+		*/
+		std::vector<Line*> lines;
+
+		/**
+		* \brief Intron property of the lines.
+		*
+		* Each bit of this vector indicates whether the Line with the same
+		* index is an Intron whithin the program.
 		*
 		* Introns are Lines of the program that do not contribute to its final
 		* result, stored in the first register. Hence, skipping these lines
 		* during a program execution can speed up the Program execution.
 		*/
-		std::vector<std::pair<Line*, bool>> lines;
+		std::vector<bool> introns;
+
+		/**
+		* \brief Indexes of the lines that are not introns, in increasing
+		* order.
+		*
+		* This vector is rebuilt from the introns attribute whenever lines are
+		* added, removed, swapped, or when introns are identified.
+		*/
+		std::vector<uint64_t> effectiveLineIndexes;
+
+		/**
+		* \brief Rebuild the effectiveLineIndexes from the introns.
+		*/
+		void updateEffectiveLineIndexes();
+
+		/// Number of 64-bit words of a set of registers.
+		const uint64_t nbRegisterWords;
+
+		/**
+		* \brief Registers useful after the execution of each line.
+		*
+		* For each line, nbRegisterWords words are stored, where each bit
+		* indicates whether the register with the same index is read by the
+		* following non-intron lines, or is the result register 0.
+		*
+		* This liveness information is computed by identifyIntrons(), and
+		* used by updateIntrons() to process only the lines affected by the
+		* modifications of the Program.
+		*/
+		std::vector<uint64_t> usefulRegisters;
+
+		/// Whether introns were identified at least once.
+		bool intronsIdentified;
+
+		/**
+		* \brief Lines modified since the last identification of introns.
+		*
+		* A line is marked as modified when it is added, swapped, or accessed
+		* through the non-const getLine() method.
+		*/
+		std::vector<bool> modifiedLines;
+
+		/**
+		* \brief Range of line indexes whose liveness may have changed since
+		* the last identification of introns.
+		*
+		* The liveness of lines with an index greater or equal to
+		* dirtyLinesEnd is unaffected by the modifications of the Program,
+		* and so is the liveness of lines with an index lower than
+		* dirtyLinesBegin, as long as the registers useful after them are
+		* unchanged.
+		*/
+		uint64_t dirtyLinesBegin, dirtyLinesEnd;
+
+		/**
+		* \brief Whether a non-intron line was modified or removed since the
+		* last identification of introns.
+		*/
+		bool effectiveLinesModified;
+
+		/**
+		* \brief Extend the range of dirty lines to the given index.
+		*
+		* \param[in] idx the index of a line whose liveness may have changed.
+		*/
+		void markDirtyLine(uint64_t idx);
+
+		/**
+		* \brief Record the modification of the line at the given index.
+		*
+		* \param[in] idx the index of the modified line.
+		*/
+		void markModifiedLine(uint64_t idx);
+
+		/**
+		* \brief Forget all modifications recorded since the last
+		* identification of introns.
+		*/
+		void clearModifications();
+
+		/**
+		* \brief Update the set of useful registers with a line.
+		*
+		* If the destination register of the line belongs to the given set
+		* of useful registers, it is removed from the set, and registers read
+		* by the line are added to it.
+		*
+		* \param[in] line the processed Line.
+		* \param[in,out] useful the nbRegisterWords words of the set of
+		* useful registers after the line, updated into the set of useful
+		* registers before the line.
+		* \return true if the line is useful, false if it is an intron.
+		*/
+		bool processLineLiveness(const Line& line, uint64_t* useful) const;
+
+		/**
+		* \brief Hash of the effective code of the Program.
+		*
+		* This hash is updated whenever introns are identified.
+		*/
+		uint64_t effectiveCodeHash;
+
+		/**
+		* \brief Browse the effective code of the Program.
+		*
+		* \param[in] visitor a function called, in order, with each integer
+		* describing the effective code, as returned by getEffectiveCode().
+		*/
+		template <class Visitor> void browseEffectiveCode(Visitor visitor) const;
+
+		/**
+		* \brief Compute the effectiveCodeHash from the current lines and
+		* introns.
+		*/
+		void updateEffectiveCodeHash();
+
+		/**
+		* \brief CompiledProgram built from the current Lines of the Program.
+		*
+		* This CompiledProgram is built on demand by the getCompiledProgram()
+		* method, and reset to nullptr whenever the Program is modified.
+		*/
+		mutable std::shared_ptr<const CompiledProgram> compiledProgram;
+
+		/**
+		* \brief Mutex protecting the compiledProgram attribute.
+		*
+		* Since a Program may be shared by several TPGEdge executed by
+		* different threads, its CompiledProgram may be requested concurrently.
+		*/
+		mutable std::mutex compiledProgramMutex;
+
+		/**
+		* \brief Discard the CompiledProgram of the Program.
+		*
+		* This method must be called by all methods modifying the Program.
+		*/
+		void invalidateCompiledProgram();
 
 		/// Delete the default constructor.
 		Program() = delete;
 
+		/// Offset of the operands and parameters of a Line within its slot.
+		static constexpr size_t LINE_DATA_OFFSET = ((sizeof(Line) + alignof(std::pair<uint64_t, uint64_t>) - 1) / alignof(std::pair<uint64_t, uint64_t>)) * alignof(std::pair<uint64_t, uint64_t>);
+
+		/// Minimum number of slots of a block of the lineBlocks.
+		static constexpr uint64_t MIN_NB_LINE_SLOTS_PER_BLOCK = 8;
+
+		/**
+		* \brief Get the size of a slot of the lineBlocks.
+		*
+		* \param[in] env the Environment of the Program.
+		* \return the size of a slot, keeping Lines stored in consecutive
+		* slots aligned.
+		*/
+		static size_t getLineSlotSize(const Environment& env);
+
 	public:
 		/**
 		* \brief Main constructor of the Program.
 		*
 		* \param[in] e the reference to the Environment that will be referenced in the Program attributes.
 		*/
-		Program(const Environment& e) : environment{ e } {};
+		Program(const Environment& e) : environment{ e }, lineSlotSize{ getLineSlotSize(e) }, lastLineBlockCapacity{ 0 }, lastLineBlockSize{ 0 }, nbRegisterWords{ (e.getNbRegisters() + 63) / 64 },
+			intronsIdentified{ false }, dirtyLinesBegin{ 0 }, dirtyLinesEnd{ 0 }, effectiveLinesModified{ false }, effectiveCodeHash{ 0 } {
+			this->updateEffectiveCodeHash();
+		};
 
 		/**
 		* \brief Copy constructor of the Program.
 		*
 		* This copy constructor realises a deep copy of the Line of the given
 		* Program, instead of the default shallow copy.
+		* The CompiledProgram of the copied Program, if any, is shared with the
+		* copy until one of them is modified.
 		*
 		* \param[in] other a const reference the the copied Program.
 		*/
-		Program(const Program& other) : environment{ other.environment }, lines{ other.lines } {
-			// Replace lines with their copy
-			// Keep intro info
-			std::transform(lines.begin(), lines.end(), lines.begin(),
-				[](std::pair<Line*, bool>& otherLine) -> std::pair<Line*, bool> {return { new Line(*(otherLine.first)), otherLine.second }; });
+		Program(const Program& other) : environment{ other.environment }, lineSlotSize{ other.lineSlotSize }, lastLineBlockCapacity{ 0 }, lastLineBlockSize{ 0 }, lines{ other.lines }, introns{ other.introns },
+			effectiveLineIndexes{ other.effectiveLineIndexes }, nbRegisterWords{ other.nbRegisterWords }, usefulRegisters{ other.usefulRegisters },
+			intronsIdentified{ other.intronsIdentified }, modifiedLines{ other.modifiedLines }, dirtyLinesBegin{ other.dirtyLinesBegin },
+			dirtyLinesEnd{ other.dirtyLinesEnd }, effectiveLinesModified{ other.effectiveLinesModified }, effectiveCodeHash{ other.effectiveCodeHash }, compiledProgram{ other.getCompiledProgramIfAny() } {
+			// Replace lines with their copy, stored in a single block.
+			for (Line*& line : this->lines) {
+				char* slot = this->allocateLineSlot(this->lines.size());
+				line = new (slot) Line(*line, slot + LINE_DATA_OFFSET);
+			}
 		};
 
 		/**
@@ -175,6 +393,9 @@ namespace Program {
 		/**
 		* \brief Get a non-const ref to a Line of the Program.
 		*
+		* Since the returned Line may be modified, the CompiledProgram of the
+		* Program is discarded by this method.
+		*
 		* \param[in] index The integer index of the retrieved Line within the Program.
 		* \return a const reference to the indexed Line of the Program.
 		* \throw std::out_of_range if the index is too large.
@@ -191,15 +412,102 @@ namespace Program {
 		*/
 		bool isIntron(uint64_t index) const;
 
+		/**
+		* \brief Get the indexes of the Lines of the Program that are not
+		* introns.
+		*
+		* The returned indexes are consistent with the isIntron() method.
+		*
+		* \return a const reference to the indexes of non-intron Lines, in
+		* increasing order.
+		*/
+		const std::vector<uint64_t>& getEffectiveLineIndexes() const;
+
 		/**
 		* \brief Scan the Line of the Program to identify introns.
 		*
 		* This method update the boolean value associated to each Line of the
 		* Program to indicate if this Line is an intron or not.
 		*
+		* Since Line of a Program may be modified through references obtained
+		* before the last call to getCompiledProgram(), this method also
+		* discards the CompiledProgram of the Program.
+		*
 		* \return the number of intron Lines idendified.
 		*/
 		uint64_t identifyIntrons();
+
+		/**
+		* \brief Update the intron property of the Line affected by the
+		* modifications made since the last identification of introns.
+		*
+		* Contrary to identifyIntrons(), this method only processes the lines
+		* preceding the modified ones, and stops as soon as the registers
+		* useful after a line are unchanged. Only modifications made through
+		* the methods of the Program, or through references returned by them
+		* since the last identification of introns, are taken into account.
+		* If introns were never identified, identifyIntrons() is called.
+		*
+		* This method also discards the CompiledProgram of the Program.
+		*
+		* \return false if the modifications only affected intron lines,
+		* hence leaving the effective code of the Program unchanged, and true
+		* if the effective code may have changed.
+		*/
+		bool updateIntrons();
+
+		/**
+		* \brief Get a description of the effective code of the Program.
+		*
+		* The effective code of the Program is the sequence of its non-intron
+		* Lines. For each such Line, the returned vector contains the
+		* instruction index, the destination index, and the operands and
+		* parameters actually used by the Instruction.
+		*
+		* Two Programs of the same Environment with equal effective codes
+		* always produce the same results. Intron flags of the Program must be
+		* up to date, see identifyIntrons().
+		*
+		* \return a vector of integers describing the effective code.
+		*/
+		std::vector<uint64_t> getEffectiveCode() const;
+
+		/**
+		* \brief Get a hash of the effective code of the Program.
+		*
+		* The hash is computed from the description of the effective code
+		* returned by getEffectiveCode(), when introns are identified with
+		* identifyIntrons() or updateIntrons(). Hence, Programs with equal
+		* effective codes have equal hashes, and a modification of a Program
+		* leaving its effective code unchanged leaves its hash unchanged.
+		*
+		* \return the hash of the effective code at the last identification
+		* of introns.
+		*/
+		uint64_t getEffectiveCodeHash() const;
+
+		/**
+		* \brief Get the CompiledProgram corresponding to the current Lines of
+		* the Program.
+		*
+		* The CompiledProgram is built on the first call to this method, and
+		* kept until the Program is modified. Hence, successive executions of
+		* an unmodified Program share the same CompiledProgram.
+		*
+		* This method is thread safe.
+		*
+		* \return a shared pointer to the CompiledProgram.
+		*/
+		std::shared_ptr<const CompiledProgram> getCompiledProgram() const;
+
+	private:
+		/**
+		* \brief Get the current CompiledProgram, without building it.
+		*
+		* \return a shared pointer to the CompiledProgram, or nullptr if it
+		* was not built since the last modification of the Program.
+		*/
+		std::shared_ptr<const CompiledProgram> getCompiledProgramIfAny() const;
 	};
 }
 #endif
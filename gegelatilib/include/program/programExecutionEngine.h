@@ -70,6 +70,52 @@ namespace Program {
 		/// Program counter of the execution engine.
 		uint64_t programCounter;
 
+		/**
+		* \brief Environment whose data sources were last checked for
+		* compatibility with those of the ProgramExecutionEngine.
+		*
+		* Programs sharing the same Environment, like all the Programs of a
+		* TPGGraph, do not need to be checked again when they are given to
+		* the setProgram() method.
+		*/
+		const Environment* checkedEnvironment = nullptr;
+
+		/**
+		* \brief Operands of the executed Instruction.
+		*
+		* This vector is kept as an attribute to reuse its memory when
+		* executing successive lines with the executeProgram() method.
+		*/
+		std::vector<Data::UntypedSharedPtr> operands;
+
+		/**
+		* \brief Parameters of the executed Instruction.
+		*
+		* This vector is kept as an attribute to reuse its memory when
+		* executing successive lines with the executeProgram() method.
+		*/
+		std::vector<std::reference_wrapper<const Parameter>> parameters;
+
+		/**
+		* \brief Raw pointers to the operands of the executed Instruction.
+		*
+		* This vector is used when executing lines of a CompiledProgram with
+		* the kernel of their Instruction.
+		*/
+		std::vector<const void*> operandPointers;
+
+		/**
+		* \brief Replace the data sources referenced for the execution of
+		* Programs, without checking their compatibility.
+		*
+		* Contrary to setDataSources(), the dataSources attribute is left
+		* unchanged, so that it can be bound again after the execution.
+		*
+		* \param[in] dataSrc data sources compatible with the dataSources
+		* attribute.
+		*/
+		void bindDataSources(const std::vector<std::reference_wrapper<const Data::DataHandler>>& dataSrc);
+
 	public:
 
 		/**
@@ -80,7 +126,7 @@ namespace Program {
 		*
 		* \param[in] env The Environment in which the Program will be executed.
 		*/
-		ProgramExecutionEngine(Environment& env) : programCounter{ 0 }, registers{ env.getNbRegisters() }, program{ NULL }, dataSources{ env.getDataSources() } {
+		ProgramExecutionEngine(const Environment& env) : programCounter{ 0 }, registers{ env.getNbRegisters() }, program{ NULL }, dataSources{ env.getDataSources() } {
 			// Setup the data sources
 			dataSourcesAndRegisters.push_back(this->registers);
 
@@ -135,6 +181,10 @@ namespace Program {
 		/**
 		* \brief Method for changing the Program executed by a ProgramExecutionEngin.
 		*
+		* The compatibility of the data sources of the ProgramExecutionEngine
+		* with the Environment of the Program is checked only if this
+		* Environment differs from the one of the previous Program.
+		*
 		* \param[in] prog the const Program that will be executed by the ProgramExecutionEngine.
 		* \throws std::runtime_error if the Environment references by the
 		* Program is incompatible with the dataSources of the ProgramExecutionEngine.
@@ -230,6 +280,12 @@ namespace Program {
 		/**
 		* \brief Execute the program completely and returns the content of register 0.
 		*
+		* Instead of interpreting the Line of the Program one by one, this
+		* method executes the CompiledProgram of the Program, which is built
+		* only once for all executions of an unmodified Program. The result
+		* is identical to the one obtained by executing the non-intron lines
+		* with the executeCurrentLine() method.
+		*
 		* \param[in] ignoreException When true, all exceptions thrown when
 		*            fetching current instructions, operands, parameters are
 		*            caught and the current program Line is simply ignored.
@@ -241,6 +297,46 @@ namespace Program {
 		*         end of the program execution.
 		*/
 		double executeProgram(const bool ignoreException = false);
+
+		/**
+		* \brief Execute the given CompiledProgram and returns the content of
+		* register 0.
+		*
+		* This method executes the CompiledProgram on the registers and data
+		* sources of the ProgramExecutionEngine, independently from the
+		* Program of the ProgramExecutionEngine. The CompiledProgram must
+		* have been built from a Program whose Environment is compatible
+		* with the data sources of the ProgramExecutionEngine.
+		*
+		* \param[in] compiledProgram the CompiledProgram to execute.
+		* \param[in] ignoreException see executeProgram().
+		* \return the double value contained in the 0-indexed register at the
+		*         end of the execution.
+		*/
+		double executeCompiledProgram(const CompiledProgram& compiledProgram, const bool ignoreException = false);
+
+		/**
+		* \brief Execute the given CompiledProgram successively on several
+		* sets of data sources.
+		*
+		* The CompiledProgram is executed once for each set of data sources,
+		* which are bound in place of the data sources of the
+		* ProgramExecutionEngine without checking their compatibility again.
+		* Hence, each set of data sources must have been checked beforehand
+		* to be compatible with the data sources of the
+		* ProgramExecutionEngine, for example by comparing their ids. The
+		* data sources of the ProgramExecutionEngine are bound again before
+		* returning.
+		*
+		* \param[in] compiledProgram the CompiledProgram to execute.
+		* \param[in] dataSourcesBatch pointers to the sets of data sources on
+		*            which the CompiledProgram is executed.
+		* \param[out] results the value of the 0-indexed register at the end
+		*             of each execution, in the order of the dataSourcesBatch.
+		* \param[in] ignoreException see executeProgram().
+		*/
+		void executeCompiledProgramBatch(const CompiledProgram& compiledProgram, const std::vector<const std::vector<std::reference_wrapper<const Data::DataHandler>>*>& dataSourcesBatch,
+			std::vector<double>& results, const bool ignoreException = false);
 	};
 	template<class T>
 	inline void ProgramExecutionEngine::setDataSources(const std::vector<std::reference_wrapper<T>>& dataSrc)
@@ -255,7 +351,10 @@ namespace Program {
 		}
 
 		// Set program to check compatibility with new data source
-		this->setProgram(*this->program);
+		this->checkedEnvironment = nullptr;
+		if (this->program != NULL) {
+			this->setProgram(*this->program);
+		}
 	}
 };
 #endif
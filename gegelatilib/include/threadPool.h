@@ -0,0 +1,217 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2020) :
+ *
+ * Karol Desnos <kdesnos@insa-rennes.fr> (2020)
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <cstdint>
+#include <atomic>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <exception>
+
+/**
+* \brief Persistent pool of threads used to execute parallel loops.
+*
+* The threads of a ThreadPool are created once, when the ThreadPool is
+* constructed, and are reused by all calls to the parallelFor method until
+* the ThreadPool is destroyed. This avoids the cost of creating and joining
+* threads every time a parallel computation is needed.
+*
+* Each thread of the pool, including the thread calling parallelFor, owns a
+* deque of task indexes. Initially, the tasks of a parallelFor are split into
+* contiguous blocks, one per deque. Each thread pops tasks from the front of
+* its own deque and, when it runs out of tasks, steals tasks from the back of
+* the deques of other threads. Each deque is stored as a single atomic word,
+* so that popping and stealing tasks never requires any lock.
+*
+* Since tasks may be executed in any order and by any thread, results of the
+* tasks should be stored using their task index to keep computations
+* deterministic.
+*/
+class ThreadPool {
+public:
+	/**
+	* \brief Type of the function executed for each task of a parallelFor.
+	*
+	* The function is given the index of the executed task, and the index of
+	* the thread executing it. Thread indexes are in the range [0;
+	* getNbThreads()[, index 0 being used by the thread calling parallelFor.
+	*/
+	typedef std::function<void(uint64_t taskIdx, uint64_t threadIdx)> Task;
+
+protected:
+	/**
+	* \brief Deque of tasks owned by a thread of the pool.
+	*
+	* The 32 most significant bits of the atomic word store the index of
+	* the first task of the deque, and its 32 least significant bits store
+	* the index following its last task.
+	*/
+	struct alignas(64) TaskDeque {
+		/// Packed index of the first and past-the-end tasks.
+		std::atomic<uint64_t> range{ 0 };
+	};
+
+	/// Number of threads used by the ThreadPool, including the caller.
+	const uint64_t nbThreads;
+
+	/// Worker threads created by the ThreadPool.
+	std::vector<std::thread> workers;
+
+	/// Deques of tasks, one per thread of the pool.
+	std::vector<TaskDeque> deques;
+
+	/// Mutex serializing concurrent calls to parallelFor.
+	std::mutex parallelForMutex;
+
+	/// Mutex protecting the synchronization of workers with parallelFor.
+	std::mutex mutex;
+
+	/// Condition used to wake up workers when a new job is started.
+	std::condition_variable jobStarted;
+
+	/// Condition used to notify the end of a job to parallelFor.
+	std::condition_variable jobEnded;
+
+	/// Identifier of the current job, incremented on each parallelFor.
+	uint64_t jobId = 0;
+
+	/// Number of workers still working on the current job.
+	uint64_t nbBusyWorkers = 0;
+
+	/// Flag used to stop workers when the ThreadPool is destroyed.
+	bool stop = false;
+
+	/// Function executed by the tasks of the current job.
+	const Task* task = nullptr;
+
+	/// First exception thrown by a task of the current job, if any.
+	std::exception_ptr exception;
+
+	/// Mutex protecting the exception attribute.
+	std::mutex exceptionMutex;
+
+	/**
+	* \brief Function executed by worker threads.
+	*
+	* \param[in] threadIdx the index of the worker thread.
+	*/
+	void workerLoop(uint64_t threadIdx);
+
+	/**
+	* \brief Execute tasks of the current job until all deques are empty.
+	*
+	* The thread first processes the tasks of its own deque, and then
+	* steals tasks from other deques.
+	*
+	* \param[in] threadIdx the index of the thread executing the tasks.
+	*/
+	void processTasks(uint64_t threadIdx);
+
+	/**
+	* \brief Pop a task from the front of a deque.
+	*
+	* \param[in] deque the TaskDeque from which a task is popped.
+	* \param[out] taskIdx the index of the popped task, if any.
+	* \return true if a task was popped, false if the deque was empty.
+	*/
+	static bool popFront(TaskDeque& deque, uint64_t& taskIdx);
+
+	/**
+	* \brief Steal a task from the back of a deque.
+	*
+	* \param[in] deque the TaskDeque from which a task is stolen.
+	* \param[out] taskIdx the index of the stolen task, if any.
+	* \return true if a task was stolen, false if the deque was empty.
+	*/
+	static bool popBack(TaskDeque& deque, uint64_t& taskIdx);
+
+public:
+	/**
+	* \brief Constructor of the ThreadPool.
+	*
+	* The constructor creates nbThreads - 1 worker threads, the thread
+	* calling the parallelFor method being used as an additional thread.
+	*
+	* \param[in] nbThreads Number of threads used by the ThreadPool.
+	* Values `0` and `1` are equivalent and result in a sequential execution
+	* of tasks by the thread calling parallelFor.
+	*/
+	explicit ThreadPool(uint64_t nbThreads);
+
+	/// Deleted copy constructor.
+	ThreadPool(const ThreadPool&) = delete;
+
+	/// Deleted copy assignment.
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	/**
+	* \brief Destructor of the ThreadPool.
+	*
+	* Stops and joins all the worker threads.
+	*/
+	~ThreadPool();
+
+	/**
+	* \brief Get the number of threads used by the ThreadPool.
+	*
+	* \return the number of threads used by the ThreadPool, including the
+	* thread calling parallelFor.
+	*/
+	uint64_t getNbThreads() const;
+
+	/**
+	* \brief Execute a task for each index in [0; nbTasks[ in parallel.
+	*
+	* This method returns when all tasks have been executed. If tasks throw
+	* exceptions, the remaining tasks are still executed, and the first
+	* exception caught is rethrown once all tasks are complete.
+	*
+	* Concurrent calls to parallelFor are executed one after the other.
+	* Calls to parallelFor from the tasks of a parallelFor are not
+	* supported.
+	*
+	* \param[in] nbTasks the number of tasks to execute.
+	* \param[in] task the function executed for each task.
+	* \throw std::length_error if nbTasks does not fit on 32 bits.
+	*/
+	void parallelFor(uint64_t nbTasks, const Task& task);
+};
+
+#endif
@@ -0,0 +1,192 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2020) :
+ *
+ * Karol Desnos <kdesnos@insa-rennes.fr> (2020)
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+#ifndef FROZEN_TPG_EXECUTION_ENGINE_H
+#define FROZEN_TPG_EXECUTION_ENGINE_H
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include <type_traits>
+
+#include "data/dataHandler.h"
+#include "data/primitiveTypeArray.h"
+#include "parameter.h"
+
+#include "tpg/frozenTPGGraph.h"
+
+namespace TPG {
+	/**
+	* \brief Class in charge of executing a FrozenTPGGraph.
+	*
+	* Contrary to the TPGExecutionEngine, this class does not support the
+	* recording of Program results in an Archive, nor the memoization of
+	* bids. Vertices and edges are browsed by index in the contiguous
+	* vectors of the FrozenTPGGraph, without virtual call nor RTTI, and the
+	* CompiledProgram of edges are executed directly.
+	*
+	* When data sources are set, the pointers to the operands of all lines
+	* of the CompiledProgram executed with a kernel are resolved once and
+	* for all with Data::DataHandler::getDataPointerAt(). Hence, executing
+	* these lines involves no virtual call, except the call to their kernel,
+	* and the result register is read directly. Lines whose Instruction has
+	* no kernel are still executed with a virtual call to
+	* Instructions::Instruction::execute(), with operands fetched at each
+	* execution with a virtual call to Data::DataHandler::getDataAt().
+	*
+	* The result of the executeFromRoot() method is identical to the action
+	* ID of the TPGAction reached by TPGExecutionEngine::executeFromRoot() on
+	* the TPGGraph the FrozenTPGGraph was built from.
+	*/
+	class FrozenTPGExecutionEngine {
+	protected:
+		/// The FrozenTPGGraph executed by the FrozenTPGExecutionEngine.
+		const FrozenTPGGraph& graph;
+
+		/// Registers used for the execution of CompiledProgram.
+		Data::PrimitiveTypeArray<double> registers;
+
+		/**
+		* \brief Storage of the registers, written directly by the
+		* FrozenTPGExecutionEngine.
+		*
+		* The registers are private to the FrozenTPGExecutionEngine, hence
+		* their content is never accessed through their DataHandler
+		* interface, except by Instructions without kernel.
+		*/
+		double* registerData;
+
+		/// Data sources (including registers) used by the CompiledProgram.
+		std::vector<std::reference_wrapper<const Data::DataHandler>> dataSourcesAndRegisters;
+
+		/**
+		* \brief Pointers to the operands of all lines executed with a kernel.
+		*
+		* Operands of the lines of the CompiledProgram at index i in the
+		* FrozenTPGGraph start at index programOperandsOffsets[i], and are
+		* then stored in the order of the operands of the CompiledProgram.
+		* Pointers of lines executed without kernel are nullptr.
+		*/
+		std::vector<const void*> operandPointers;
+
+		/// Index of the first operand pointer of each CompiledProgram.
+		std::vector<size_t> programOperandsOffsets;
+
+		/// Operands of an executed Instruction without kernel.
+		std::vector<Data::UntypedSharedPtr> operands;
+
+		/// Parameters of an executed Instruction without kernel.
+		std::vector<std::reference_wrapper<const Parameter>> parameters;
+
+		/**
+		* \brief Execution during which each vertex was last visited.
+		*
+		* Vertices whose stamp equals the currentStamp were already visited
+		* during the current execution, and must not be visited again. Using
+		* stamps avoids resetting the vector for each execution.
+		*/
+		std::vector<uint64_t> visitStamps;
+
+		/// Stamp of the current execution.
+		uint64_t currentStamp = 0;
+
+		/**
+		* \brief Set the data sources and resolve the operand pointers of all
+		* lines executed with a kernel.
+		*
+		* \param[in] dataSrc The vector of DataHandler references with which
+		* the FrozenTPGGraph will be executed.
+		* \throws std::runtime_error if the data sources are incompatible with
+		* those of the Environment of the FrozenTPGGraph.
+		*/
+		void bindDataSources(const std::vector<std::reference_wrapper<const Data::DataHandler>>& dataSrc);
+
+		/**
+		* \brief Execute a CompiledProgram of the FrozenTPGGraph.
+		*
+		* \param[in] programIndex index of the CompiledProgram in the
+		* FrozenTPGGraph.
+		* \return the value of the 0-indexed register at the end of the
+		* execution.
+		*/
+		double executeProgram(uint64_t programIndex);
+
+	public:
+		/**
+		* \brief Main constructor of the class.
+		*
+		* The FrozenTPGGraph is executed on the data sources of its
+		* Environment.
+		*
+		* \param[in] graph the FrozenTPGGraph to execute, which must outlive
+		*            the FrozenTPGExecutionEngine.
+		*/
+		FrozenTPGExecutionEngine(const FrozenTPGGraph& graph);
+
+		/**
+		* \brief Set the data sources on which the FrozenTPGGraph is executed.
+		*
+		* \param[in] dataSrc The vector of DataHandler references with which
+		* the FrozenTPGGraph will be executed.
+		* \throws std::runtime_error if the data sources are incompatible with
+		* those of the Environment of the FrozenTPGGraph.
+		*/
+		template <class T> void setDataSources(const std::vector<std::reference_wrapper<T>>& dataSrc) {
+			// Check that T is either convertible to a const DataHandler
+			static_assert(std::is_convertible<T&, const Data::DataHandler&>::value);
+			std::vector<std::reference_wrapper<const Data::DataHandler>> constDataSrc;
+			for (const std::reference_wrapper<T>& data : dataSrc) {
+				constDataSrc.push_back(data.get());
+			}
+			this->bindDataSources(constDataSrc);
+		}
+
+		/**
+		* \brief Execute the FrozenTPGGraph starting from its root.
+		*
+		* Starting from the root, the edge with the best bid among the
+		* outgoing edges of each team is followed, excluding edges leading to
+		* already visited vertices. In case of equality, the last evaluated
+		* edge wins.
+		*
+		* \return the action ID of the reached action.
+		* \throw std::runtime_error in case a team has no outgoing edge
+		*        after excluding all edges leading to already visited vertices.
+		*/
+		uint64_t executeFromRoot();
+	};
+};
+
+#endif
@@ -0,0 +1,158 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2020) :
+ *
+ * Karol Desnos <kdesnos@insa-rennes.fr> (2020)
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+#ifndef FROZEN_TPG_GRAPH_H
+#define FROZEN_TPG_GRAPH_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "environment.h"
+#include "program/compiledProgram.h"
+
+#include "tpg/tpgGraph.h"
+
+namespace TPG {
+	/**
+	* \brief Class storing an immutable, flattened, copy of the part of a
+	* TPGGraph reachable from a root TPGVertex.
+	*
+	* Once a TPGGraph is trained, it is only executed from one of its roots.
+	* The FrozenTPGGraph stores everything needed for this execution in
+	* contiguous vectors: the vertices, indexed from 0 (the root) in
+	* breadth-first order, the outgoing edges of each team, stored
+	* consecutively in the order of the original outgoing TPGEdge, and the
+	* CompiledProgram of the Program of each edge. Program shared by several
+	* TPGEdge are stored only once.
+	*
+	* Since the FrozenTPGGraph has no link with the TPGGraph it was built
+	* from, the TPGGraph can be modified, or deleted, afterwards. However,
+	* the CompiledProgram reference the Instructions of the Environment, which
+	* must outlive the FrozenTPGGraph.
+	*
+	* A FrozenTPGGraph is executed with a FrozenTPGExecutionEngine.
+	*/
+	class FrozenTPGGraph {
+	public:
+		/**
+		* \brief Structure storing a vertex of a FrozenTPGGraph.
+		*/
+		typedef struct Vertex {
+			/// Is the vertex a leaf TPGAction, or a TPGTeam?
+			bool isAction;
+
+			/// Action ID of the TPGAction (0 for a TPGTeam).
+			uint64_t actionID;
+
+			/// Index of the first outgoing Edge of the vertex in the edges
+			/// vector.
+			uint64_t edgesOffset;
+
+			/// Number of outgoing Edge of the vertex.
+			uint64_t nbEdges;
+		} Vertex;
+
+		/**
+		* \brief Structure storing an edge of a FrozenTPGGraph.
+		*/
+		typedef struct Edge {
+			/// Index of the CompiledProgram of the edge in the programs
+			/// vector.
+			uint64_t programIndex;
+
+			/// Index of the destination Vertex in the vertices vector.
+			uint64_t destination;
+		} Edge;
+
+	protected:
+		/// Environment of the TPGGraph the FrozenTPGGraph was built from.
+		const Environment& env;
+
+		/// Vertices reachable from the root, which is at index 0.
+		std::vector<Vertex> vertices;
+
+		/// Outgoing edges of all vertices, in the order of the vertices.
+		std::vector<Edge> edges;
+
+		/// CompiledProgram of the edges.
+		std::vector<std::shared_ptr<const Program::CompiledProgram>> programs;
+
+	public:
+		/**
+		* \brief Constructor freezing the part of a TPGGraph reachable from
+		* the given root.
+		*
+		* \param[in] graph the TPGGraph to freeze.
+		* \param[in] root the TPGVertex from which the frozen part of the
+		*            TPGGraph is reachable.
+		* \throw std::runtime_error if the root does not belong to the
+		*        TPGGraph.
+		*/
+		FrozenTPGGraph(const TPGGraph& graph, const TPGVertex& root);
+
+		/**
+		* \brief Get the Environment of the FrozenTPGGraph.
+		*
+		* \return a const reference to the Environment of the TPGGraph the
+		*         FrozenTPGGraph was built from.
+		*/
+		const Environment& getEnvironment() const;
+
+		/**
+		* \brief Get the vertices of the FrozenTPGGraph.
+		*
+		* \return a const reference to the vertices, the root being at
+		*         index 0.
+		*/
+		const std::vector<Vertex>& getVertices() const;
+
+		/**
+		* \brief Get the edges of the FrozenTPGGraph.
+		*
+		* \return a const reference to the edges of all vertices.
+		*/
+		const std::vector<Edge>& getEdges() const;
+
+		/**
+		* \brief Get the CompiledProgram of the FrozenTPGGraph.
+		*
+		* \return a const reference to the CompiledProgram of all edges.
+		*/
+		const std::vector<std::shared_ptr<const Program::CompiledProgram>>& getPrograms() const;
+	};
+};
+
+#endif
@@ -81,12 +81,12 @@ namespace TPG {
 		/**
 		* \brief Get the shared_pointer to the Program.
 		*
-		* This method is voluntarily non-const to make sure that only the 
-		* TPGGraph containing the edge can use it.
+		* This method is used by the TPGGraph to share the Program of a
+		* TPGEdge with another TPGEdge, for example when cloning it.
 		*
 		* \return a copy of the program attribute.
 		*/
-		std::shared_ptr<Program::Program> getProgramSharedPointer();
+		std::shared_ptr<Program::Program> getProgramSharedPointer() const;
 
 		/**
 		* \brief Get the source TPGVertex of the TPGEdge.
@@ -38,6 +38,8 @@
 
 #include <set>
 #include <vector>
+#include <unordered_map>
+#include <utility>
 
 #include "archive.h"
 #include "program/programExecutionEngine.h"
@@ -66,6 +68,100 @@ namespace TPG {
 		*/
 		Program::ProgramExecutionEngine progExecutionEngine;
 
+		/**
+		* \brief Bids of the last TPGTeam evaluated with the
+		* evaluateTeamBids() method.
+		*
+		* Keeping this vector as an attribute avoids reallocating it for each
+		* evaluated TPGTeam.
+		*/
+		std::vector<std::pair<const TPGEdge*, double>> bids;
+
+		/**
+		* \brief Hash functor for the keys of the bidCache.
+		*/
+		struct BidCacheKeyHash {
+			/// Combine the Program pointer and the data sources hash.
+			size_t operator()(const std::pair<const Program::Program*, size_t>& key) const {
+				return std::hash<const Program::Program*>()(key.first) ^ key.second;
+			}
+		};
+
+		/**
+		* \brief Maximum number of bids memoized in the bidCache.
+		*
+		* A value of 0 deactivates the bidCache.
+		*/
+		const size_t bidCacheSize;
+
+		/**
+		* \brief Cache of the bids produced by Programs.
+		*
+		* Since the execution of a Program is deterministic, the bid produced
+		* by a Program only depends on the content of the data sources. This
+		* map associates a Program pointer and the combined hash of the data
+		* sources, as computed by Archive::getCombinedHash(), with the bid
+		* produced by the Program for these data sources. When several roots
+		* of a TPGGraph share Programs and are evaluated on the same inputs,
+		* each Program is thus executed only once per input.
+		*
+		* When the number of memoized bids reaches the bidCacheSize, the
+		* bidCache is cleared.
+		*/
+		std::unordered_map<std::pair<const Program::Program*, size_t>, double, BidCacheKeyHash> bidCache;
+
+		/**
+		* \brief Stamps of the excluded TPGVertex, indexed by
+		* TPGVertex::getIndex().
+		*
+		* A TPGVertex is excluded from the current evaluation if its slot
+		* holds the currentStamp and its pointer. Incrementing the
+		* currentStamp thus clears all exclusions in constant time, and
+		* checking whether the destination of a TPGEdge is excluded does not
+		* require browsing the excluded TPGVertex.
+		*/
+		std::vector<std::pair<uint64_t, const TPGVertex*>> excludedStamps;
+
+		/// Stamp of the TPGVertex excluded from the current evaluation.
+		uint64_t currentStamp = 0;
+
+		/// Clear the TPGVertex excluded from the current evaluation.
+		void clearExcluded();
+
+		/**
+		* \brief Exclude a TPGVertex from the current evaluation.
+		*
+		* \param[in] vertex the excluded TPGVertex.
+		*/
+		void exclude(const TPGVertex* vertex);
+
+		/**
+		* \brief Check whether a TPGVertex is excluded from the current
+		* evaluation.
+		*
+		* \param[in] vertex the checked TPGVertex.
+		* \return true if the TPGVertex was excluded since the last call to
+		* clearExcluded().
+		*/
+		bool isExcluded(const TPGVertex* vertex) const;
+
+		/**
+		* \brief Evaluate the outgoing TPGEdge of the TPGTeam not leading to
+		* an excluded TPGVertex.
+		*
+		* Same as evaluateTeamBids(), with the TPGVertex excluded with
+		* exclude().
+		*/
+		const std::vector<std::pair<const TPGEdge*, double>>& evaluateNonExcludedTeamBids(const TPGTeam& team);
+
+		/**
+		* \brief Get the TPGEdge of the TPGTeam providing the best bid among
+		* the TPGEdge not leading to an excluded TPGVertex.
+		*
+		* Same as evaluateTeam(), with the TPGVertex excluded with exclude().
+		*/
+		const TPG::TPGEdge& evaluateNonExcludedTeam(const TPGTeam& team);
+
 	public:
 		/**
 		* \brief Main constructor of the class.
@@ -76,8 +172,11 @@ namespace TPG {
 		*                 the Program Execution. By default, a NULL pointer is
 		*                 given, meaning that no recording of the execution
 		*                 will be made.
+		* \param[in] bidCacheSize maximum number of bids memoized by the
+		*                 TPGExecutionEngine. By default, bids are not
+		*                 memoized. See the bidCache attribute.
 		*/
-		TPGExecutionEngine(const Environment& env, Archive* arch = NULL) : progExecutionEngine(env), archive{ arch } {};
+		TPGExecutionEngine(const Environment& env, Archive* arch = NULL, size_t bidCacheSize = 0) : progExecutionEngine(env), archive{ arch }, bidCacheSize{ bidCacheSize } {};
 
 		/**
 		* \brief Set a new Archive for storing Program results.
@@ -86,6 +185,15 @@ namespace TPG {
 		*/
 		void setArchive(Archive* newArchive);
 
+		/**
+		* \brief Clear all bids memoized by the TPGExecutionEngine.
+		*
+		* Bids are memoized with the Program pointer as a key, hence this
+		* method must be called whenever a Program previously executed by the
+		* TPGExecutionEngine is modified, or deleted.
+		*/
+		void clearBidCache();
+
 		/**
 		* \brief Execute the Program associated to an Edge and returns the
 		* obtained double.
@@ -93,19 +201,50 @@ namespace TPG {
 		* If an Archive is associated to the TPGExecutionEngine, the Program result
 		* is recorded in it.
 		*
+		* If the bidCache is active and already contains the result of the
+		* Program for the current data sources, the Program is not executed
+		* and the memoized result is returned instead.
+		*
 		* \param[in] edge the const ref to the TPGEdge whose Program will be
 		* evaluated.
 		* \return the double value returned by the Program of the TPGEdge.
 		*/
 		double evaluateEdge(const TPGEdge& edge);
 
+		/**
+		* \brief Evaluate all the Program of the outgoing TPGEdge of the
+		*        TPGTeam and return their bids.
+		*
+		* This method evaluates, in a single pass, the Programs of all
+		* outgoing TPGEdge of the TPGTeam on the current content of the data
+		* sources, in the order of the outgoing TPGEdge list of the TPGTeam.
+		* Since all Programs of a TPGGraph share the same Environment, the
+		* compatibility of the data sources is checked only once, for the
+		* first Program.
+		* TPGEdge leading to a TPGVertex in the excluded set are not
+		* evaluated, and do not appear in the returned bids. Excluded
+		* TPGVertex are stamped once, so that checking the destination of
+		* each TPGEdge runs in constant time.
+		*
+		* If an Archive is associated to the TPGExecutionEngine, the Program
+		* results are recorded in it.
+		*
+		* \param[in] team the TPGTeam whose outgoing TPGEdge are evaluated.
+		* \param[in] excluded the TPGVertex pointers that must be avoided when
+		*            TPGEdge lead to them.
+		* \return a const reference to a vector of pairs associating each
+		*         evaluated TPGEdge with its bid. This vector is overwritten
+		*         by the next call to this method.
+		*/
+		const std::vector<std::pair<const TPGEdge*, double>>& evaluateTeamBids(const TPGTeam& team, const std::vector<const TPGVertex*>& excluded);
+
 		/**
 		* \brief Evaluate all the Program of the outgoing TPGEdge of the
 		*        TPGTeam.
 		*
 		* This method evaluates the Programs of all outgoing TPGEdge of the
-		* TPGTeam, and returns the reference to the TPGEdge providing the
-		* largest evaluation.
+		* TPGTeam with the evaluateTeamBids() method, and returns the
+		* reference to the TPGEdge providing the largest evaluation.
 		* TPGEdge leading to a TPGTeam in the excluded set will not be
 		* evaluated.
 		*
@@ -136,6 +275,39 @@ namespace TPG {
 		*         TPGGraph execution is at the end of the returned vector.
 		*/
 		const std::vector<const TPGVertex*> executeFromRoot(const TPGVertex& root);
+
+		/**
+		* \brief Execute the TPGGraph starting from the given TPGVertex for a
+		* batch of observations.
+		*
+		* The result of this method is identical to the result of calling
+		* executeFromRoot() successively for each observation, but
+		* observations are grouped per TPGTeam: at each step, observations
+		* currently on the same TPGTeam are grouped, and the CompiledProgram
+		* of each outgoing TPGEdge of this TPGTeam is executed once per group
+		* with Program::ProgramExecutionEngine::executeCompiledProgramBatch().
+		* Within a group, the CompiledProgram is still executed successively
+		* for each observation. Hence, each Program is fetched and set once
+		* per step for the whole group instead of once per observation. Bids memoized in the
+		* bidCache are reused, and bids are recorded in the Archive, if any,
+		* as with executeFromRoot().
+		*
+		* Each observation is a set of data sources compatible with the
+		* Environment of the TPGExecutionEngine (i.e. copies of its data
+		* sources). This compatibility is checked once for all observations
+		* when the method is called, and not for each execution of a
+		* Program. The data sources of the TPGExecutionEngine are left
+		* unchanged.
+		*
+		* \param[in] root the TPGVertex from which the execution will start.
+		* \param[in] observations the data sources of each observation.
+		* \return a vector containing the action ID of the TPGAction reached
+		*         for each observation, in the order of the observations.
+		* \throws std::runtime_error if an observation is incompatible with
+		*         the Environment of the TPGExecutionEngine, or if a TPGTeam
+		*         has no outgoing TPGEdge to evaluate (see evaluateTeam()).
+		*/
+		std::vector<uint64_t> executeBatchFromRoot(const TPGVertex& root, const std::vector<std::vector<std::reference_wrapper<const Data::DataHandler>>>& observations);
 	};
 };
 
@@ -38,6 +38,10 @@
 #define TPG_GRAPH_H
 
 #include <list>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
 
 #include "environment.h"
 #include "tpg/tpgVertex.h"
@@ -46,6 +50,9 @@
 #include "tpg/tpgEdge.h"
 
 namespace TPG {
+	// Declare class to make it usable as a return type.
+	class FrozenTPGGraph;
+
 	/**
 	* \brief Class for storing a Tangled-Program-Graph.
 	*/
@@ -83,7 +90,13 @@ namespace TPG {
 		{
 			using std::swap;
 			swap(a.vertices, b.vertices);
+			swap(a.nbVertices, b.nbVertices);
+			swap(a.vertexSet, b.vertexSet);
+			swap(a.rootVertices, b.rootVertices);
 			swap(a.edges, b.edges);
+			swap(a.edgeIndex, b.edgeIndex);
+			swap(a.programTable, b.programTable);
+			swap(a.nbDeduplicatedPrograms, b.nbDeduplicatedPrograms);
 		}
 
 
@@ -135,7 +148,7 @@ namespace TPG {
 		/**
 		* \brief Get the number of TPGVertex contained in the TPGGraph.
 		*
-		* \return the size of the vertices attribute.
+		* \return the number of non-NULL pointers in the vertices attribute.
 		*/
 		size_t getNbVertices() const;
 
@@ -153,6 +166,9 @@ namespace TPG {
 		/**
 		* \brief Get the number of rootVertices of the TPGGraph.
 		*
+		* Root vertices are maintained by the TPGGraph, hence this method runs
+		* in constant time.
+		*
 		* \return the number of TPGVertex in the graph with no incomingEdge.
 		*/
 		uint64_t getNbRootVertices() const;
@@ -169,10 +185,44 @@ namespace TPG {
 		*/
 		const std::vector<const TPGVertex*> getRootVertices() const;
 
+		/**
+		* \brief Freeze the part of the TPGGraph reachable from the given
+		* root into a FrozenTPGGraph.
+		*
+		* The returned FrozenTPGGraph is an immutable copy of the TPGGraph
+		* to be executed with a FrozenTPGExecutionEngine, for example once
+		* the training of the TPGGraph is over.
+		*
+		* \param[in] root the TPGVertex from which the frozen part of the
+		*            TPGGraph is reachable.
+		* \return the FrozenTPGGraph built from the given root.
+		* \throw std::runtime_error if the root does not belong to the
+		*        TPGGraph.
+		*/
+		FrozenTPGGraph freeze(const TPGVertex& root) const;
+
+		/**
+		* \brief Create a copy of the TPGGraph.
+		*
+		* The TPGVertex and TPGEdge of the TPGGraph are duplicated, in the
+		* same order, but the Program of the TPGEdge are shared between the
+		* TPGGraph and its copy, as when cloning a TPGEdge with cloneEdge().
+		* Since the Mutator::TPGMutator only modifies the Program it creates,
+		* a copy made between two generations of a training is a snapshot of
+		* the TPGGraph that remains valid when the TPGGraph is modified by
+		* the next generations, or deleted.
+		*
+		* \return the copy of the TPGGraph.
+		*/
+		TPGGraph clone() const;
+
 
 		/**
 		* \brief Check whether a given vertex exists in the TPGGraph.
 		*
+		* The given TPGVertex is not dereferenced, hence, this method can be
+		* used to check whether a previously removed TPGVertex still exists.
+		*
 		* \param[in] vertex the TPG::TPGVertex whose presence in the TPGGraph
 		* is checked.
 		* \return true if the vertex exists in the TPGGraph, false otherwise.
@@ -185,6 +235,13 @@ namespace TPG {
 		* If the edge is connected to TPGEdges within the graph, they are also
 		* removed and destroyed.
 		*
+		* The slot of the TPGVertex in the vertices attribute is emptied,
+		* without moving the other TPGVertex. When empty slots outnumber the
+		* TPGVertex of the TPGGraph, the vertices attribute is compacted, and
+		* the index of the remaining TPGVertex is updated. Hence, apart from
+		* the removal of the connected TPGEdge, this method runs in amortized
+		* constant time.
+		*
 		* \param[in] vertex a const reference to the TPGVertex to remove.
 		*/
 		void removeVertex(const TPGVertex& vertex);
@@ -280,6 +337,48 @@ namespace TPG {
 		*/
 		bool setEdgeSource(const TPGEdge& edge, const TPGVertex& newSrc);
 
+		/**
+		* \brief Share a single Program between all TPGEdge whose Program
+		* have the same effective code.
+		*
+		* Programs of the TPGEdge are looked up, in the order of the edges,
+		* in a table of the TPGGraph indexed by the hash of their effective
+		* code, as returned by Program::Program::getEffectiveCodeHash().
+		* When a Program with the same effective code is already in the
+		* table, the TPGEdge is associated to this Program instead. Hence,
+		* behaviorally identical Programs share a single instance, a single
+		* compiled program, and a single entry of the bid cache of a
+		* TPGExecutionEngine. Otherwise, the Program is added to the table.
+		*
+		* Introns of the Programs are updated with
+		* Program::Program::updateIntrons() before their lookup.
+		*
+		* Since Programs shared between TPGEdge must no longer be modified,
+		* this method should only be called once the Programs of the
+		* TPGGraph are mutated, for example after the population of the
+		* TPGGraph with a Mutator::TPGMutator.
+		*
+		* \return the number of TPGEdge whose Program was replaced with an
+		* identical one.
+		*/
+		uint64_t internPrograms();
+
+		/**
+		* \brief Get the number of distinct Program instances associated to
+		* the TPGEdge of the TPGGraph.
+		*
+		* \return the number of distinct Program instances.
+		*/
+		uint64_t getNbPrograms() const;
+
+		/**
+		* \brief Get the total number of Program replaced by an identical
+		* one with internPrograms() since the creation of the TPGGraph.
+		*
+		* \return the number of deduplicated Programs.
+		*/
+		uint64_t getNbDeduplicatedPrograms() const;
+
 	protected:
 
 		/// Environment of the TPGGraph
@@ -287,24 +386,99 @@ namespace TPG {
 
 		/**
 		* \brief Set of TPGVertex composing the TPGGraph.
+		*
+		* Vertices are stored contiguously, in the order of their addition,
+		* each TPGVertex being stored at its TPGVertex::getIndex().
+		* Slots of removed vertices contain a NULL pointer until the vector
+		* is compacted by compactVertices().
 		*/
-		std::list<TPGVertex*> vertices;
+		std::vector<TPGVertex*> vertices;
+
+		/// Number of non-NULL pointers in the vertices attribute.
+		uint64_t nbVertices = 0;
+
+		/**
+		* \brief Set of the TPGVertex of the TPGGraph.
+		*
+		* This set is used to check whether a TPGVertex belongs to the
+		* TPGGraph without dereferencing it, since the checked TPGVertex may
+		* already have been removed and destroyed.
+		*/
+		std::unordered_set<const TPGVertex*> vertexSet;
+
+		/**
+		* \brief Root TPGVertex of the TPGGraph, sorted by TPGVertex::getIndex().
+		*
+		* This map is updated whenever a TPGVertex or a TPGEdge is added,
+		* removed or modified, and contains all TPGVertex without incoming
+		* TPGEdge, in the order of the vertices attribute.
+		*/
+		std::map<uint64_t, const TPGVertex*> rootVertices;
+
+		/**
+		* \brief Add a TPGVertex to the vertices of the TPGGraph.
+		*
+		* \param[in] vertex pointer to the new TPGVertex, whose ownership is
+		* transferred to the TPGGraph.
+		*/
+		void addVertex(TPGVertex* vertex);
+
+		/**
+		* \brief Remove the empty slots from the vertices attribute.
+		*
+		* The order of the remaining TPGVertex is preserved, and their index
+		* and the rootVertices are updated accordingly.
+		*/
+		void compactVertices();
+
+		/**
+		* \brief Update the rootVertices after a change of the incoming edges
+		* of a TPGVertex.
+		*
+		* \param[in] vertex the TPGVertex whose incoming edges changed.
+		*/
+		void updateRootVertex(const TPGVertex* vertex);
 
 		/**
 		* \brief Set of TPGEdge composing the TPGGraph.
+		*
+		* TPGEdge are kept in a std::list, rather than in a vector with
+		* integer handles, because TPGVertex reference their TPGEdge by
+		* pointer, and because getEdges() returns this list. Finding and
+		* removing a TPGEdge nevertheless runs in constant time with the
+		* edgeIndex.
 		*/
 		std::list<TPGEdge> edges;
 
 		/**
-		* \brief Find the non-const iterator to a vertex of the graph from
+		* \brief Map associating each TPGEdge of the TPGGraph to its position
+		* in the edges attribute.
+		*
+		* This map is used to find or remove a TPGEdge in constant time.
+		*/
+		std::unordered_map<const TPGEdge*, std::list<TPGEdge>::iterator> edgeIndex;
+
+		/**
+		* \brief Table of the Programs interned with internPrograms(), indexed
+		* by the hash of their effective code.
+		*
+		* Programs are referenced with weak pointers so that the table does
+		* not keep alive Programs no longer associated to any TPGEdge.
+		*/
+		std::unordered_multimap<uint64_t, std::weak_ptr<Program::Program>> programTable;
+
+		/// Number of Programs replaced by internPrograms().
+		uint64_t nbDeduplicatedPrograms = 0;
+
+		/**
+		* \brief Find the non-const pointer to a vertex of the graph from
 		* its const pointer.
 		*
 		* \param[in] vertex the const pointer to the TPGVertex.
-		* \return the iterator on the vertices attribute, at the position of
-		*         the searched vertex pointer. If the given vertex pointer is
-		*         not in the vertices, then vertices.end() is returned.
+		* \return the non-const pointer to the TPGVertex if it belongs to the
+		*         TPGGraph, NULL otherwise.
 		*/
-		std::list<TPGVertex*>::iterator findVertex(const TPGVertex* vertex);
+		TPGVertex* findVertex(const TPGVertex* vertex);
 
 		/**
 		* \brief Find the non-const iterator to an edge of the graph from
@@ -312,8 +486,8 @@ namespace TPG {
 		*
 		* \param[in] edge the const pointer to the TPGEdge.
 		* \return the iterator on the edges attribute, at the position of
-		*         the searched edge pointer. If the given vertex pointer is
-		*         not in the vertices, then vertices.end() is returned.
+		*         the searched edge pointer. If the given edge pointer is
+		*         not in the edges, then edges.end() is returned.
 		*/
 		std::list<TPGEdge>::iterator findEdge(const TPGEdge* edge);
 	};
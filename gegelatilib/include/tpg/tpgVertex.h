@@ -36,30 +36,52 @@
 #ifndef TPG_VERTEX_H
 #define TPG_VERTEX_H
 
-#include <list>
+#include <cstdint>
+#include <vector>
 
 namespace TPG {
 	// Declare class to make it usable as an attribute.
 	class TPGEdge;
+	class TPGGraph;
 
 	/**
 	* \brief Abstract class representing the vertices of a TPGGraph
 	*/
 	class TPGVertex {
+		// The TPGGraph maintains the index of its TPGVertex.
+		friend class TPGGraph;
+
 	public:
 
 		/// Default polymorphic destructor
 		virtual ~TPGVertex() = default;
 
+		/**
+		* \brief Get the index of the TPGVertex within the vertices of the
+		* TPGGraph it belongs to.
+		*
+		* Indexes of the TPGVertex of a TPGGraph follow the order of the
+		* TPGGraph::getVertices() method, and are smaller than twice the
+		* number of vertices of the TPGGraph. The index of a TPGVertex only
+		* changes when the TPGGraph compacts its storage after the removal
+		* of vertices (see TPGGraph::removeVertex()). Hence, it can be used
+		* to index data associated to the vertices of a TPGGraph in a
+		* vector, as long as the TPGGraph is not modified.
+		*
+		* \return the index of the TPGVertex, or 0 if it does not belong to
+		* any TPGGraph.
+		*/
+		uint64_t getIndex() const;
+
 		/**
 		* \brief Get a const reference to incoming edges of this TPGVertex.
 		*/
-		const std::list<TPGEdge*>& getIncomingEdges() const;
+		const std::vector<TPGEdge*>& getIncomingEdges() const;
 
 		/**
 		* \brief Get a const reference to incoming edges of this TPGVertex.
 		*/
-		const std::list<TPGEdge*>& getOutgoingEdges() const;
+		const std::vector<TPGEdge*>& getOutgoingEdges() const;
 
 		/**
 		* \brief Method to add an incoming TPGEdge to the TPGVertex.
@@ -116,15 +138,22 @@ namespace TPG {
 		*/
 		TPGVertex() {};
 
+		/// Index of the TPGVertex, maintained by its TPGGraph.
+		uint64_t index = 0;
+
 		/**
 		* \brief Set of incoming TPGEdge of the TPGVertex.
+		*
+		* Edges are stored contiguously, in the order of their addition.
 		*/
-		std::list<TPG::TPGEdge*> incomingEdges;
+		std::vector<TPG::TPGEdge*> incomingEdges;
 
 		/**
 		* \brief Set of outgoing TPGEdge of the TPGVertex.
+		*
+		* Edges are stored contiguously, in the order of their addition.
 		*/
-		std::list<TPG::TPGEdge*> outgoingEdges;
+		std::vector<TPG::TPGEdge*> outgoingEdges;
 	};
 };
 
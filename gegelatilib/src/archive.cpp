@@ -34,6 +34,8 @@
  */
 
 #include <math.h>
+#include <cmath>
+#include <algorithm>
 
 #include "archive.h"
 
@@ -74,60 +76,89 @@ void Archive::addRecording(const Program::Program* const program, const std::vec
 		size_t hash = getCombinedHash(dHandler);
 
 		// Check if dataHandler copy is needed.
+		std::vector<std::reference_wrapper<const Data::DataHandler>> dHandlersCpy;
 		if (this->dataHandlers.find(hash) == this->dataHandlers.end()) {
 			// Store a copy of data handlers.
-			std::vector<std::reference_wrapper<const Data::DataHandler>> dHandlersCpy;
 			for (std::reference_wrapper<const Data::DataHandler> dh : dHandler) {
 				Data::DataHandler* dhCopy = dh.get().clone();
 				dHandlersCpy.push_back(*dhCopy);
 			}
-			// Create the map entry
-			this->dataHandlers.emplace(hash, std::move(dHandlersCpy));
 		}
 
-		// Create and stores the recording
-		ArchiveRecording recording{ program, hash, result };
-		this->recordings.push_back(recording);
+		this->insertRecording(program, hash, result, dHandlersCpy);
+	}
+}
+
+void Archive::insertRecording(const Program::Program* const program, size_t hash, double result, std::vector<std::reference_wrapper<const Data::DataHandler>>& dHandlerCopy)
+{
+	// Take ownership of the dataHandler copy if needed.
+	if (this->dataHandlers.find(hash) == this->dataHandlers.end()) {
+		// Create the map entry
+		this->dataHandlers.emplace(hash, std::move(dHandlerCopy));
+		dHandlerCopy.clear();
 
-		// Update the recordings per Program
-		auto iterNbRecordings = this->recordingsPerProgram.find(program);
-		if (iterNbRecordings != this->recordingsPerProgram.end()) {
-			iterNbRecordings->second.push_back(recording);
+		// Associate a slot to the hash
+		uint32_t slot = this->nbSlots;
+		if (!this->freeSlots.empty()) {
+			slot = this->freeSlots.back();
+			this->freeSlots.pop_back();
 		}
 		else {
-			this->recordingsPerProgram.insert({ program, {recording} });
+			this->nbSlots++;
 		}
+		this->slotPerHash.emplace(hash, slot);
+	}
+	this->nbRecordingsPerHash[hash]++;
 
-		// Check if Archive max size was reached (or exceeded)
-		while (this->recordings.size() > this->maxSize) {
+	// Create and stores the recording
+	ArchiveRecording recording{ program, hash, result };
+	this->recordings.push_back(recording);
 
-			// Get the recording (copy)
-			ArchiveRecording rec = this->recordings.front();
-			// Remove the first recording
-			this->recordings.pop_front();
+	// Update the recordings per Program
+	auto iterNbRecordings = this->recordingsPerProgram.find(program);
+	if (iterNbRecordings != this->recordingsPerProgram.end()) {
+		iterNbRecordings->second.push_back(recording);
+	}
+	else {
+		this->recordingsPerProgram.insert({ program, {recording} });
+	}
+	this->addProgramResult(recording);
 
-			// Check if this DataHandler (hash) is still used in other recordings
-			bool stillUsed = (std::find_if(this->recordings.begin(), this->recordings.end(),
-				[&rec](ArchiveRecording r) {return r.dataHash == rec.dataHash; })) != this->recordings.end();
+	// Check if Archive max size was reached (or exceeded)
+	while (this->recordings.size() > this->maxSize) {
 
-			// if not, remove it from the Archive also
-			if (!stillUsed) {
-				// Free memory of DataHandlers within the archive
-				for (std::reference_wrapper<const Data::DataHandler> toErase : this->dataHandlers.at(rec.dataHash)) {
-					delete& toErase.get();
-				}
+		// Get the recording (copy)
+		ArchiveRecording rec = this->recordings.front();
+		// Remove the first recording
+		this->recordings.pop_front();
 
-				// Remove the entry from the map
-				this->dataHandlers.erase(rec.dataHash);
-			}
+		// Update the recordingsPerProgram of the corresponding Program,
+		// and remove it if it was the last.
+		auto iter = this->recordingsPerProgram.find(rec.prog);
+		iter->second.pop_front();
+		if (iter->second.size() == 0) {
+			this->recordingsPerProgram.erase(iter);
+		}
+		this->removeProgramResult(rec);
+
+		// Check if this DataHandler (hash) is still used in other recordings
+		auto iterNbRecordingsPerHash = this->nbRecordingsPerHash.find(rec.dataHash);
+		iterNbRecordingsPerHash->second--;
+
+		// if not, remove it from the Archive also
+		if (iterNbRecordingsPerHash->second == 0) {
+			this->nbRecordingsPerHash.erase(iterNbRecordingsPerHash);
 
-			// Update the recordingsPerProgram of the corresponding Program,
-			// and remove it if it was the last.
-			auto iter = this->recordingsPerProgram.find(rec.prog);
-			iter->second.pop_front();
-			if (iter->second.size() == 0) {
-				this->recordingsPerProgram.erase(iter);
+			// Free memory of DataHandlers within the archive
+			for (std::reference_wrapper<const Data::DataHandler> toErase : this->dataHandlers.at(rec.dataHash)) {
+				delete& toErase.get();
 			}
+
+			// Remove the entry from the map, and free its slot
+			this->dataHandlers.erase(rec.dataHash);
+			auto iterSlot = this->slotPerHash.find(rec.dataHash);
+			this->freeSlots.push_back(iterSlot->second);
+			this->slotPerHash.erase(iterSlot);
 		}
 	}
 }
@@ -139,34 +170,56 @@ bool Archive::hasDataHandlers(const size_t& hash) const
 
 bool Archive::areProgramResultsUnique(const std::map<size_t, double>& hashesAndResults, double tau) const
 {
+	// Rebuild slots outdated by the removal of recordings.
+	if (this->hasDirtyPrograms.load(std::memory_order_acquire)) {
+		this->updateDirtyProgramResults();
+	}
+
+	// Scatter the given results in a dense array indexed by slots.
+	// Hashes absent from the Archive are irrelevant.
+	std::vector<uint8_t> hasResult(this->nbSlots, 0);
+	std::vector<double> results(this->nbSlots);
+	for (const auto& hashAndResult : hashesAndResults) {
+		auto iterSlot = this->slotPerHash.find(hashAndResult.first);
+		if (iterSlot != this->slotPerHash.end()) {
+			hasResult[iterSlot->second] = 1;
+			results[iterSlot->second] = hashAndResult.second;
+		}
+	}
+
 	// Check programs until one is equivalent or until all have been checked.
-	for (auto programRecordings : this->recordingsPerProgram) {
-		// check all recordings "presence" within the hashesAndResults map.
+	for (const auto& programResults : this->resultsPerProgram) {
+		const ProgramResults& columns = programResults.second;
+		const uint32_t* slots = columns.slots.data();
+		const double* minResults = columns.minResults.data();
+		const double* maxResults = columns.maxResults.data();
+		const size_t nbColumns = columns.slots.size();
+
+		// For each slot of the program, there are three possibilities
+		// 1- there is no result for this slot in the given results
+		//    > Nothing to do for this slot
+		// 2- there is a different result in the given results
+		//    > Put isIdentical to false and stop browsing the slots for this program.
+		// 3- there is an "identical" (within tau margin) result in the given results
+		//    > Put the isIdentical to true. If at the end of all slots the isIdentical is true
+		//    > The program bid behavior is marked as equivalent.
+		// Comparing with the minimum and maximum results of a slot is 
+		// equivalent to comparing with all recordings of this slot.
 		bool isIdentical = false;
-		for (const auto& recording : programRecordings.second) {
-			// For each recording there are three possibilities
-			// 1- there is no result for this hash in the Map
-			//    > Nothing to do for this recording
-			// 2- there is a different result in the Map
-			//    > Put isIdentical to false and stop browsing the recordings for this program.
-			// 3- there is an "identical" (within tau margin) result in the Map
-			//    > Put the isIdentical to true. If at the end of all recordings the isIdentical is true
-			//    > The program bid behavior is marked as equivalent.
-			auto iter = hashesAndResults.find(recording.dataHash);
-			if (iter != hashesAndResults.end()) {
-				// Cases 2 & 3
-				if (std::abs(iter->second - recording.result) <= tau) {
+		for (size_t i = 0; i < nbColumns; i++) {
+			const uint32_t slot = slots[i];
+			if (hasResult[slot]) {
+				// Cases 2 & 3 (comparisons with NaN are always false)
+				const double result = results[slot];
+				if (std::abs(result - minResults[i]) <= tau && std::abs(result - maxResults[i]) <= tau) {
 					// results are equivalent
 					isIdentical = true;
 				}
 				else {
 					isIdentical = false;
-					break; // break for recordings loop
+					break; // break for slots loop
 				}
 			}
-			else {
-				// Case 1 > do nothing
-			}
 		}
 
 		// If isIdentical is 1 => Programs have equivalent bidding behaviour
@@ -178,6 +231,125 @@ bool Archive::areProgramResultsUnique(const std::map<size_t, double>& hashesAndR
 	return true;
 }
 
+/**
+* \brief Merge a result with the minimum and maximum results of a slot.
+*
+* If any of the merged results is NaN, the minimum and maximum are NaN.
+*/
+static void mergeResult(double& minResult, double& maxResult, double result)
+{
+	if (std::isnan(result) || std::isnan(minResult)) {
+		minResult = maxResult = NAN;
+	}
+	else {
+		minResult = std::min(minResult, result);
+		maxResult = std::max(maxResult, result);
+	}
+}
+
+void Archive::addProgramResult(const ArchiveRecording& recording)
+{
+	ProgramResults& columns = this->resultsPerProgram[recording.prog];
+	const uint32_t slot = this->slotPerHash.at(recording.dataHash);
+
+	auto iter = columns.columnPerSlot.find(slot);
+	if (iter == columns.columnPerSlot.end()) {
+		columns.columnPerSlot.emplace(slot, columns.slots.size());
+		columns.slots.push_back(slot);
+		columns.minResults.push_back(recording.result);
+		columns.maxResults.push_back(recording.result);
+		columns.nbResults.push_back(1);
+		columns.isDirty.push_back(0);
+	}
+	else {
+		// (If the slot is dirty, it will be rebuilt with this result anyway)
+		size_t i = iter->second;
+		columns.nbResults[i]++;
+		mergeResult(columns.minResults[i], columns.maxResults[i], recording.result);
+	}
+}
+
+void Archive::removeProgramResult(const ArchiveRecording& recording)
+{
+	auto iterColumns = this->resultsPerProgram.find(recording.prog);
+	ProgramResults& columns = iterColumns->second;
+	const uint32_t slot = this->slotPerHash.at(recording.dataHash);
+	auto iterColumn = columns.columnPerSlot.find(slot);
+	size_t i = iterColumn->second;
+
+	columns.nbResults[i]--;
+	if (columns.nbResults[i] == 0) {
+		// Remove the slot by replacing it with the last one.
+		columns.columnPerSlot.erase(iterColumn);
+		if (i != columns.slots.size() - 1) {
+			columns.slots[i] = columns.slots.back();
+			columns.minResults[i] = columns.minResults.back();
+			columns.maxResults[i] = columns.maxResults.back();
+			columns.nbResults[i] = columns.nbResults.back();
+			columns.isDirty[i] = columns.isDirty.back();
+			columns.columnPerSlot[columns.slots[i]] = i;
+		}
+		columns.slots.pop_back();
+		columns.minResults.pop_back();
+		columns.maxResults.pop_back();
+		columns.nbResults.pop_back();
+		columns.isDirty.pop_back();
+
+		if (columns.slots.empty()) {
+			this->resultsPerProgram.erase(iterColumns);
+		}
+	}
+	else {
+		// The minimum and maximum results are rebuilt from the remaining
+		// recordings before the next unicity test.
+		columns.isDirty[i] = 1;
+		this->dirtyPrograms.insert(recording.prog);
+		this->hasDirtyPrograms.store(true, std::memory_order_release);
+	}
+}
+
+void Archive::updateDirtyProgramResults() const
+{
+	std::lock_guard<std::mutex> lock(this->dirtyProgramsMutex);
+	// Another thread may have done the rebuild while waiting for the lock.
+	if (!this->hasDirtyPrograms.load(std::memory_order_relaxed)) {
+		return;
+	}
+
+	for (const Program::Program* prog : this->dirtyPrograms) {
+		auto iterColumns = this->resultsPerProgram.find(prog);
+		if (iterColumns == this->resultsPerProgram.end()) {
+			// All recordings of the Program were removed.
+			continue;
+		}
+		ProgramResults& columns = iterColumns->second;
+
+		// Browse the recordings of the Program once for all its dirty slots.
+		std::vector<uint8_t> isRebuilt(columns.slots.size(), 0);
+		for (const ArchiveRecording& rec : this->recordingsPerProgram.at(prog)) {
+			const size_t i = columns.columnPerSlot.at(this->slotPerHash.at(rec.dataHash));
+			if (columns.isDirty[i]) {
+				if (!isRebuilt[i]) {
+					columns.minResults[i] = columns.maxResults[i] = rec.result;
+					isRebuilt[i] = 1;
+				}
+				else {
+					mergeResult(columns.minResults[i], columns.maxResults[i], rec.result);
+				}
+			}
+		}
+		std::fill(columns.isDirty.begin(), columns.isDirty.end(), 0);
+	}
+
+	this->dirtyPrograms.clear();
+	this->hasDirtyPrograms.store(false, std::memory_order_release);
+}
+
+size_t Archive::getMaxSize() const
+{
+	return this->maxSize;
+}
+
 size_t Archive::getNbRecordings() const
 {
 	return this->recordings.size();
@@ -188,7 +360,7 @@ size_t Archive::getNbDataHandlers() const
 	return this->dataHandlers.size();
 }
 
-const std::map<size_t, std::vector<std::reference_wrapper<const Data::DataHandler>>>& Archive::getDataHandlers() const
+const std::unordered_map<size_t, std::vector<std::reference_wrapper<const Data::DataHandler>>>& Archive::getDataHandlers() const
 {
 	return this->dataHandlers;
 }
@@ -203,6 +375,13 @@ void Archive::clear()
 	}
 
 	this->dataHandlers.clear();
+	this->nbRecordingsPerHash.clear();
 	this->recordings.clear();
 	this->recordingsPerProgram.clear();
+	this->slotPerHash.clear();
+	this->freeSlots.clear();
+	this->nbSlots = 0;
+	this->resultsPerProgram.clear();
+	this->dirtyPrograms.clear();
+	this->hasDirtyPrograms.store(false);
 }
@@ -0,0 +1,188 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2020) :
+ *
+ * Karol Desnos <kdesnos@insa-rennes.fr> (2020)
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+#include <stdexcept>
+#include <algorithm>
+
+#include "archiveRecordingBuffer.h"
+
+ArchiveRecordingBuffer::~ArchiveRecordingBuffer()
+{
+	this->clearBuffer();
+}
+
+void ArchiveRecordingBuffer::releaseSnapshot(size_t hash)
+{
+	auto iter = this->snapshots.find(hash);
+	iter->second.second--;
+	if (iter->second.second == 0) {
+		// Free memory of DataHandlers (if still owned)
+		for (std::reference_wrapper<const Data::DataHandler> toErase : iter->second.first) {
+			delete& toErase.get();
+		}
+		this->snapshots.erase(iter);
+	}
+}
+
+void ArchiveRecordingBuffer::startSegment(uint64_t id, size_t seed)
+{
+	if (this->nbSegments == this->segments.size()) {
+		this->segments.emplace_back();
+		this->segments.back().recordings.reserve(this->maxSize);
+	}
+
+	Segment& segment = this->segments.at(this->nbSegments);
+	segment.id = id;
+	segment.first = 0;
+	segment.recordings.clear();
+	this->nbSegments++;
+
+	this->setRandomSeed(seed);
+}
+
+void ArchiveRecordingBuffer::addRecording(const Program::Program* const program, const std::vector<std::reference_wrapper<const Data::DataHandler>>& dHandler, double result, bool forced)
+{
+	if (this->nbSegments == 0) {
+		throw std::runtime_error("A segment must be started before adding recordings to an ArchiveRecordingBuffer.");
+	}
+
+	// Archive according to probability (same process as in Archive)
+	if (forced || this->archivingProbability == 1.0 || this->rng.getDouble(0.0, 1.0) <= this->archivingProbability) {
+		if (this->maxSize == 0) {
+			return;
+		}
+
+		// get the combined hash
+		size_t hash = getCombinedHash(dHandler);
+
+		// Copy the dataHandlers, only if not already buffered.
+		auto iter = this->snapshots.find(hash);
+		if (iter == this->snapshots.end()) {
+			std::vector<std::reference_wrapper<const Data::DataHandler>> dHandlersCpy;
+			for (std::reference_wrapper<const Data::DataHandler> dh : dHandler) {
+				Data::DataHandler* dhCopy = dh.get().clone();
+				dHandlersCpy.push_back(*dhCopy);
+			}
+			iter = this->snapshots.emplace(hash, std::make_pair(std::move(dHandlersCpy), 0)).first;
+		}
+		iter->second.second++;
+
+		// Store the recording, overwriting the oldest if the segment is full.
+		Segment& segment = this->segments.at(this->nbSegments - 1);
+		BufferedRecording recording{ program, hash, result };
+		if (segment.recordings.size() < this->maxSize) {
+			segment.recordings.push_back(recording);
+		}
+		else {
+			BufferedRecording& oldest = segment.recordings.at(segment.first);
+			this->releaseSnapshot(oldest.dataHash);
+			oldest = recording;
+			segment.first = (segment.first + 1) % this->maxSize;
+		}
+	}
+}
+
+size_t ArchiveRecordingBuffer::getNbBufferedRecordings() const
+{
+	size_t nbRecordings = 0;
+	for (size_t idx = 0; idx < this->nbSegments; idx++) {
+		nbRecordings += this->segments.at(idx).recordings.size();
+	}
+	return nbRecordings;
+}
+
+void ArchiveRecordingBuffer::clearBuffer()
+{
+	for (auto& snapshot : this->snapshots) {
+		for (std::reference_wrapper<const Data::DataHandler> toErase : snapshot.second.first) {
+			delete& toErase.get();
+		}
+	}
+	this->snapshots.clear();
+
+	for (size_t idx = 0; idx < this->nbSegments; idx++) {
+		this->segments.at(idx).recordings.clear();
+	}
+	this->nbSegments = 0;
+}
+
+void ArchiveRecordingBuffer::merge(const std::vector<ArchiveRecordingBuffer*>& buffers, Archive& archive)
+{
+	// Gather segments of all buffers, with their buffer.
+	std::vector<std::pair<const Segment*, ArchiveRecordingBuffer*>> segments;
+	for (ArchiveRecordingBuffer* buffer : buffers) {
+		for (size_t idx = 0; idx < buffer->nbSegments; idx++) {
+			segments.push_back({ &buffer->segments.at(idx), buffer });
+		}
+	}
+	std::sort(segments.begin(), segments.end(),
+		[](const std::pair<const Segment*, ArchiveRecordingBuffer*>& a, const std::pair<const Segment*, ArchiveRecordingBuffer*>& b) {
+			return a.first->id < b.first->id;
+		});
+
+	// Scan the segments backward, starting from the last to identify the 
+	// last recordings to keep.
+	auto reverseIterator = segments.rbegin();
+	uint64_t nbRecordings = 0;
+	while (nbRecordings < archive.getMaxSize() && reverseIterator != segments.rend()) {
+		nbRecordings += reverseIterator->first->recordings.size();
+		reverseIterator++;
+	}
+
+	// Insert identified recordings into the archive
+	while (reverseIterator != segments.rbegin()) {
+		reverseIterator--;
+		const Segment& segment = *reverseIterator->first;
+		ArchiveRecordingBuffer& buffer = *reverseIterator->second;
+
+		// Skip recordings in the first segment if needed
+		size_t recordingIdx = 0;
+		if (nbRecordings > archive.getMaxSize()) {
+			recordingIdx = nbRecordings - archive.getMaxSize();
+			nbRecordings = archive.getMaxSize();
+		}
+
+		// Insert remaining recordings, from the oldest
+		for (; recordingIdx < segment.recordings.size(); recordingIdx++) {
+			const BufferedRecording& recording = segment.recordings.at((segment.first + recordingIdx) % segment.recordings.size());
+			archive.insertRecording(recording.prog, recording.dataHash, recording.result, buffer.snapshots.at(recording.dataHash).first);
+		}
+	}
+
+	// Clear all buffers
+	for (ArchiveRecordingBuffer* buffer : buffers) {
+		buffer->clearBuffer();
+	}
+}
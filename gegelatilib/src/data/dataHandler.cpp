@@ -62,3 +62,8 @@ uint64_t Data::DataHandler::scaleLocation(const uint64_t rawLocation, const std:
 {
 	return rawLocation % this->getAddressSpace(type);
 }
+
+const void* Data::DataHandler::getDataPointerAt(const std::type_info&, const size_t) const
+{
+	return nullptr;
+}
@@ -166,6 +166,24 @@ size_t Environment::getLargestAddressSpace() const
 	return this->largestAddressSpace;
 }
 
+std::vector<std::pair<size_t, size_t>> Environment::computeRegistersAccesses(const Environment& env)
+{
+	std::vector<std::pair<size_t, size_t>> accesses(env.nbInstructions * env.maxNbOperands, { 0, 0 });
+	for (uint64_t idxInstruction = 0; idxInstruction < env.nbInstructions; idxInstruction++) {
+		const Instructions::Instruction& instruction = env.instructionSet.getInstruction(idxInstruction);
+		for (uint64_t idxOperand = 0; idxOperand < instruction.getNbOperands(); idxOperand++) {
+			const std::type_info& type = instruction.getOperandTypes().at(idxOperand).get();
+			const size_t addressSpace = env.fakeRegisters.getAddressSpace(type);
+			if (addressSpace > 0) {
+				// Registers accessed by an operand are consecutive.
+				accesses[idxInstruction * env.maxNbOperands + idxOperand] = { addressSpace, env.fakeRegisters.getAddressesAccessed(type, 0).size() };
+			}
+		}
+	}
+
+	return accesses;
+}
+
 const LineSize& Environment::getLineSize() const
 {
 	return this->lineSize;
@@ -181,6 +199,14 @@ const Data::DataHandler& Environment::getFakeRegisters() const
 	return this->fakeRegisters;
 }
 
+const std::pair<size_t, size_t>& Environment::getRegistersAccess(uint64_t instructionIndex, uint64_t operandIndex) const
+{
+	if (operandIndex >= this->maxNbOperands) {
+		throw std::out_of_range("Attempting to access a non-existing operand.");
+	}
+	return this->registersAccesses.at(instructionIndex * this->maxNbOperands + operandIndex);
+}
+
 const Instructions::Set& Environment::getInstructionSet() const
 {
 	return this->instructionSet;
@@ -0,0 +1,125 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2020) :
+ *
+ * Karol Desnos <kdesnos@insa-rennes.fr> (2020)
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+#include <unordered_map>
+
+#include "tpg/tpgAction.h"
+#include "tpg/tpgEdge.h"
+#include "program/packedLines.h"
+
+#include "file/tpgGraphBinaryExporter.h"
+
+// "GEGELATI" read as a little-endian 64-bit word.
+const uint64_t File::TPGGraphBinaryExporter::formatMagic = 0x4954414C45474547;
+
+const uint64_t File::TPGGraphBinaryExporter::formatVersion = 2;
+
+void File::TPGGraphBinaryExporter::writeWord(uint64_t word)
+{
+	if (fwrite(&word, sizeof(uint64_t), 1, this->pFile) != 1) {
+		throw std::runtime_error("Could not write the binary content of the TPGGraph.");
+	}
+}
+
+void File::TPGGraphBinaryExporter::writeProgram(const Program::Program& program)
+{
+	const Program::PackedLines packedLines(program);
+
+	this->writeWord(packedLines.getNbLines());
+	this->writeWord(packedLines.getNbWords());
+	if (packedLines.getNbWords() > 0
+		&& fwrite(packedLines.getWords(), sizeof(uint64_t), packedLines.getNbWords(), this->pFile) != packedLines.getNbWords()) {
+		throw std::runtime_error("Could not write the binary content of the TPGGraph.");
+	}
+}
+
+void File::TPGGraphBinaryExporter::print()
+{
+	const std::vector<const TPG::TPGVertex*> vertices = this->tpg.getVertices();
+	const std::list<TPG::TPGEdge>& edges = this->tpg.getEdges();
+
+	// Index vertices and programs
+	std::unordered_map<const TPG::TPGVertex*, uint64_t> vertexIndexes;
+	for (const TPG::TPGVertex* vertex : vertices) {
+		vertexIndexes.emplace(vertex, vertexIndexes.size());
+	}
+	std::unordered_map<const Program::Program*, uint64_t> programIndexes;
+	std::vector<const Program::Program*> programs;
+	for (const TPG::TPGEdge& edge : edges) {
+		const Program::Program* program = &edge.getProgram();
+		if (programIndexes.emplace(program, programs.size()).second) {
+			programs.push_back(program);
+		}
+	}
+
+	// Header
+	const LineSize& lineSize = this->tpg.getEnvironment().getLineSize();
+	this->writeWord(formatMagic);
+	this->writeWord(formatVersion);
+	this->writeWord(lineSize.nbInstructionBits);
+	this->writeWord(lineSize.nbDestinationBits);
+	this->writeWord(lineSize.nbOperandsBits);
+	this->writeWord(lineSize.nbOperandDataSourceIndexBits);
+	this->writeWord(lineSize.nbOperandLocationBits);
+	this->writeWord(lineSize.nbParametersBits);
+	this->writeWord(lineSize.totalNbBits);
+	this->writeWord(vertices.size());
+	this->writeWord(programs.size());
+	this->writeWord(edges.size());
+
+	// Vertices
+	for (const TPG::TPGVertex* vertex : vertices) {
+		if (typeid(*vertex) == typeid(TPG::TPGAction)) {
+			this->writeWord(((const TPG::TPGAction*)vertex)->getActionID() + 1);
+		}
+		else {
+			this->writeWord(0);
+		}
+	}
+
+	// Programs
+	for (const Program::Program* program : programs) {
+		this->writeProgram(*program);
+	}
+
+	// Edges
+	for (const TPG::TPGEdge& edge : edges) {
+		this->writeWord(vertexIndexes.at(edge.getSource()));
+		this->writeWord(programIndexes.at(&edge.getProgram()));
+		this->writeWord(vertexIndexes.at(edge.getDestination()));
+	}
+
+	fflush(this->pFile);
+}
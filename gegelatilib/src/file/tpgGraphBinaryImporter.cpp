@@ -0,0 +1,218 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2020) :
+ *
+ * Karol Desnos <kdesnos@insa-rennes.fr> (2020)
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "program/packedLines.h"
+#include "file/tpgGraphBinaryExporter.h"
+
+#include "file/tpgGraphBinaryImporter.h"
+
+void File::TPGGraphBinaryImporter::openFile(const char* filePath)
+{
+#ifndef _WIN32
+	int fd = open(filePath, O_RDONLY);
+	struct stat fileStat;
+	if (fd < 0 || fstat(fd, &fileStat) != 0) {
+		if (fd >= 0) {
+			close(fd);
+		}
+		throw std::runtime_error("Could not open file " + std::string(filePath));
+	}
+	size_t size = (size_t)fileStat.st_size;
+	if (size % sizeof(uint64_t) != 0) {
+		close(fd);
+		throw std::runtime_error("Size of file " + std::string(filePath) + " is not a multiple of 64 bits.");
+	}
+	if (size > 0) {
+		void* address = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (address == MAP_FAILED) {
+			close(fd);
+			throw std::runtime_error("Could not map file " + std::string(filePath));
+		}
+		this->mapping = address;
+		this->mappingSize = size;
+		this->content = (const uint64_t*)address;
+	}
+	// The mapping remains valid after closing the file descriptor.
+	close(fd);
+	this->nbWords = size / sizeof(uint64_t);
+#else
+	std::ifstream file(filePath, std::ios::binary | std::ios::ate);
+	if (!file.is_open()) {
+		throw std::runtime_error("Could not open file " + std::string(filePath));
+	}
+	size_t size = (size_t)file.tellg();
+	if (size % sizeof(uint64_t) != 0) {
+		throw std::runtime_error("Size of file " + std::string(filePath) + " is not a multiple of 64 bits.");
+	}
+	this->buffer.resize(size / sizeof(uint64_t));
+	file.seekg(0);
+	file.read((char*)this->buffer.data(), size);
+	this->content = this->buffer.data();
+	this->nbWords = this->buffer.size();
+#endif
+	this->readIndex = 0;
+}
+
+void File::TPGGraphBinaryImporter::closeFile()
+{
+#ifndef _WIN32
+	if (this->mapping != nullptr) {
+		munmap(this->mapping, this->mappingSize);
+	}
+#endif
+	this->mapping = nullptr;
+	this->mappingSize = 0;
+	this->buffer.clear();
+	this->content = nullptr;
+	this->nbWords = 0;
+	this->readIndex = 0;
+}
+
+const uint64_t* File::TPGGraphBinaryImporter::readWords(size_t nb)
+{
+	if (nb > this->nbWords - this->readIndex) {
+		throw std::runtime_error("Unexpected end of the binary content of the TPGGraph.");
+	}
+	const uint64_t* words = this->content + this->readIndex;
+	this->readIndex += nb;
+	return words;
+}
+
+void File::TPGGraphBinaryImporter::readHeader()
+{
+	const uint64_t* header = this->readWords(2);
+	if (header[0] != TPGGraphBinaryExporter::formatMagic) {
+		throw std::runtime_error("The file does not contain a binary TPGGraph, or was exported on a platform with a different endianness.");
+	}
+	if (header[1] != TPGGraphBinaryExporter::formatVersion) {
+		throw std::runtime_error("Unsupported version " + std::to_string(header[1]) + " of the binary TPGGraph format.");
+	}
+
+	const LineSize& lineSize = this->tpg.getEnvironment().getLineSize();
+	const uint64_t* words = this->readWords(7);
+	if (words[0] != lineSize.nbInstructionBits || words[1] != lineSize.nbDestinationBits
+		|| words[2] != lineSize.nbOperandsBits || words[3] != lineSize.nbOperandDataSourceIndexBits
+		|| words[4] != lineSize.nbOperandLocationBits || words[5] != lineSize.nbParametersBits
+		|| words[6] != lineSize.totalNbBits) {
+		throw std::runtime_error("The LineSize of the binary TPGGraph differs from the one of the Environment of the TPGGraph.");
+	}
+}
+
+std::shared_ptr<Program::Program> File::TPGGraphBinaryImporter::readProgram()
+{
+	const Environment& env = this->tpg.getEnvironment();
+
+	std::shared_ptr<Program::Program> program = std::make_shared<Program::Program>(env);
+	const uint64_t* sizes = this->readWords(2);
+	const uint64_t nbLines = sizes[0];
+	const uint64_t nbLineWords = sizes[1];
+	const uint64_t* words = this->readWords(nbLineWords);
+	try {
+		const Program::PackedLines packedLines(env, nbLines, words, nbLineWords);
+		if (!packedLines.unpack(*program, true)) {
+			throw std::runtime_error("Invalid Line in the binary content of the TPGGraph.");
+		}
+	}
+	catch (std::invalid_argument&) {
+		throw std::runtime_error("Invalid Program size in the binary content of the TPGGraph.");
+	}
+	program->identifyIntrons();
+
+	return program;
+}
+
+void File::TPGGraphBinaryImporter::setNewFilePath(const char* newFilePath)
+{
+	this->closeFile();
+	this->openFile(newFilePath);
+}
+
+void File::TPGGraphBinaryImporter::importGraph()
+{
+	this->readIndex = 0;
+	this->tpg.clear();
+
+	this->readHeader();
+	const uint64_t* counts = this->readWords(3);
+	const uint64_t nbVertices = counts[0];
+	const uint64_t nbPrograms = counts[1];
+	const uint64_t nbEdges = counts[2];
+
+	// Vertices
+	std::vector<const TPG::TPGVertex*> vertices;
+	const uint64_t* vertexWords = this->readWords(nbVertices);
+	for (uint64_t i = 0; i < nbVertices; i++) {
+		if (vertexWords[i] == 0) {
+			vertices.push_back(&this->tpg.addNewTeam());
+		}
+		else {
+			vertices.push_back(&this->tpg.addNewAction(vertexWords[i] - 1));
+		}
+	}
+
+	// Programs
+	std::vector<std::shared_ptr<Program::Program>> programs;
+	for (uint64_t i = 0; i < nbPrograms; i++) {
+		programs.push_back(this->readProgram());
+	}
+
+	// Edges
+	if (nbEdges > this->nbWords / 3) {
+		throw std::runtime_error("Unexpected end of the binary content of the TPGGraph.");
+	}
+	const uint64_t* edgeWords = this->readWords(3 * nbEdges);
+	for (uint64_t i = 0; i < nbEdges; i++) {
+		const uint64_t* edge = edgeWords + 3 * i;
+		if (edge[0] >= nbVertices || edge[1] >= nbPrograms || edge[2] >= nbVertices) {
+			throw std::runtime_error("Invalid TPGEdge in the binary content of the TPGGraph.");
+		}
+		this->tpg.addNewEdge(*vertices[edge[0]], *vertices[edge[2]], programs[edge[1]]);
+	}
+
+	if (this->readIndex != this->nbWords) {
+		throw std::runtime_error("Unexpected content after the end of the binary TPGGraph.");
+	}
+}
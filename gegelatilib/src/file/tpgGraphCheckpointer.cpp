@@ -0,0 +1,100 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2020) :
+ *
+ * Karol Desnos <kdesnos@insa-rennes.fr> (2020)
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+#include <cstdio>
+
+#include "file/tpgGraphDotExporter.h"
+
+#include "file/tpgGraphCheckpointer.h"
+
+void File::TPGGraphCheckpointer::exportSnapshot()
+{
+	try {
+		const std::string tmpFilePath = this->filePath + ".tmp";
+		{
+			TPGGraphDotExporter exporter(tmpFilePath.c_str(), *this->snapshot);
+			exporter.print();
+		}
+
+		// Replace the checkpoint file.
+		if (std::rename(tmpFilePath.c_str(), this->filePath.c_str()) != 0) {
+			// Renaming over an existing file fails on some platforms.
+			std::remove(this->filePath.c_str());
+			if (std::rename(tmpFilePath.c_str(), this->filePath.c_str()) != 0) {
+				throw std::runtime_error("Could not replace checkpoint file " + this->filePath);
+			}
+		}
+		this->nbCheckpoints++;
+	}
+	catch (...) {
+		this->exportException = std::current_exception();
+	}
+
+	// Release the snapshot in the background thread too.
+	this->snapshot.reset();
+}
+
+File::TPGGraphCheckpointer::~TPGGraphCheckpointer()
+{
+	if (this->exportThread.joinable()) {
+		this->exportThread.join();
+	}
+}
+
+void File::TPGGraphCheckpointer::checkpoint(const TPG::TPGGraph& graph)
+{
+	this->wait();
+
+	this->snapshot.reset(new TPG::TPGGraph(graph.clone()));
+	this->exportThread = std::thread(&TPGGraphCheckpointer::exportSnapshot, this);
+}
+
+void File::TPGGraphCheckpointer::wait()
+{
+	if (this->exportThread.joinable()) {
+		this->exportThread.join();
+	}
+
+	if (this->exportException) {
+		std::exception_ptr exception = this->exportException;
+		this->exportException = nullptr;
+		std::rethrow_exception(exception);
+	}
+}
+
+uint64_t File::TPGGraphCheckpointer::getNbCheckpoints() const
+{
+	return this->nbCheckpoints;
+}
@@ -35,6 +35,8 @@
  */
 
 #include <inttypes.h>
+#include <cstdarg>
+#include <cstdio>
 
 #include "file/tpgGraphDotExporter.h"
 
@@ -80,12 +82,12 @@ void File::TPGGraphDotExporter::printTPGTeam(const TPG::TPGTeam& team)
 		color = "#66ddff";
 	}
 
-	fprintf(pFile, "%sT%" PRIu64 " [fillcolor=\"%s\"]\n", this->offset.c_str(), name, color.c_str());
+	this->write("%sT%" PRIu64 " [fillcolor=\"%s\"]\n", this->offset.c_str(), name, color.c_str());
 }
 
 uint64_t File::TPGGraphDotExporter::printTPGAction(const TPG::TPGAction& action)
 {
-	fprintf(pFile, "%sA%" PRIu64 " [fillcolor=\"#ff3366\" shape=box margin=0.03 width=0 height=0 label=\"%" PRIu64 "\"]\n", this->offset.c_str(), nbActions++, action.getActionID());
+	this->write("%sA%" PRIu64 " [fillcolor=\"#ff3366\" shape=box margin=0.03 width=0 height=0 label=\"%" PRIu64 "\"]\n", this->offset.c_str(), nbActions++, action.getActionID());
 	return nbActions - 1;
 }
 
@@ -97,22 +99,22 @@ void File::TPGGraphDotExporter::printTPGEdge(const TPG::TPGEdge& edge)
 	Program::Program& p = edge.getProgram();
 	if (this->findProgramID(edge.getProgram(), progID)) {
 		// First time thie Program is encountered
-		fprintf(pFile, "%sP%" PRIu64 " [fillcolor=\"#cccccc\" shape=point]\n", this->offset.c_str(), progID);
+		this->write("%sP%" PRIu64 " [fillcolor=\"#cccccc\" shape=point]\n", this->offset.c_str(), progID);
 		//print the program content : 
 		printProgram(p);
-		fprintf(pFile, "%sP%" PRIu64 " -> I%" PRIu64 "[style=invis]\n", this->offset.c_str(), progID, progID);
+		this->write("%sP%" PRIu64 " -> I%" PRIu64 "[style=invis]\n", this->offset.c_str(), progID, progID);
 		if (typeid(*edge.getDestination()) == typeid(TPG::TPGAction)) {
 			uint64_t actionID = printTPGAction(*(const TPG::TPGAction*)edge.getDestination());
-			fprintf(pFile, "%sT%" PRIu64 " -> P%" PRIu64 " -> A%" PRIu64 "\n", this->offset.c_str(), srcID, progID, actionID);
+			this->write("%sT%" PRIu64 " -> P%" PRIu64 " -> A%" PRIu64 "\n", this->offset.c_str(), srcID, progID, actionID);
 		}
 		else {
 			uint64_t destID = findVertexID(*edge.getDestination());
-			fprintf(pFile, "%sT%" PRIu64 " -> P%" PRIu64 " -> T%" PRIu64 "\n", this->offset.c_str(), srcID, progID, destID);
+			this->write("%sT%" PRIu64 " -> P%" PRIu64 " -> T%" PRIu64 "\n", this->offset.c_str(), srcID, progID, destID);
 		}
 	}
 	else
 	{
-		fprintf(pFile, "%sT%" PRIu64 " -> P%" PRIu64 "\n", this->offset.c_str(), srcID, progID);
+		this->write("%sT%" PRIu64 " -> P%" PRIu64 "\n", this->offset.c_str(), srcID, progID);
 	}
 }
 
@@ -120,39 +122,32 @@ void File::TPGGraphDotExporter::printProgram(const Program::Program& program)
 {
 	uint64_t progID;
 	this->findProgramID(program, progID);
-	std::string programContent = "";
+	this->write("%sI%" PRIu64 " [shape=box style=invis label=\"", this->offset.c_str(), progID);
 	for (int i = 0; i < program.getNbLines(); i++)
 	{
 		const Program::Line& l = program.getLine(i);
-		//instruction index
-		programContent += std::to_string(l.getInstructionIndex());
-		programContent += "|";
-		//instruction destination index
-		programContent += std::to_string(l.getDestinationIndex());
-		programContent += "&";
+		//instruction index and destination index
+		this->write("%" PRIu64 "|%" PRIu64 "&", l.getInstructionIndex(), l.getDestinationIndex());
 		//instruction parameters
 		for (int j = 0; j < l.getEnvironment().getMaxNbParameters(); j++)
 		{
 			const Parameter& p = l.getParameter(j);
-			programContent += std::to_string(p.i);
-			programContent += "|";
+			this->write("%d|", (int)p.i);
 		}
-		programContent += "$";
+		this->content += "$";
 		//instruction operands
 		for (int j = 0; j < l.getEnvironment().getMaxNbOperands(); j++)
 		{
 			std::pair<uint64_t, uint64_t> p = l.getOperand(j);
 			if (j != 0)
-				programContent += "#";
-			programContent += std::to_string(p.first);
-			programContent += "|";
-			programContent += std::to_string(p.second);
+				this->content += "#";
+			this->write("%" PRIu64 "|%" PRIu64, p.first, p.second);
 		}
 
-		programContent += "&#92;n";
+		this->content += "&#92;n";
 
 	}
-	fprintf(pFile, "%sI%" PRIu64 " [shape=box style=invis label=\"%s\"]\n", this->offset.c_str(), progID, programContent.c_str());
+	this->content += "\"]\n";
 }
 
 void File::TPGGraphDotExporter::printTPGGraphHeader()
@@ -162,10 +157,10 @@ void File::TPGGraphDotExporter::printTPGGraphHeader()
 	graph[pad = "0.212,0.055" bgcolor = lightgray]
 	node[style = filled label = ""]
 	*/
-	fprintf(pFile, "%sdigraph{\n", this->offset.c_str());
+	this->write("%sdigraph{\n", this->offset.c_str());
 	this->offset = "\t";
-	fprintf(pFile, "%sgraph[pad = \"0.212, 0.055\" bgcolor = lightgray]\n", this->offset.c_str());
-	fprintf(pFile, "%snode[shape=circle style = filled label = \"\"]\n", this->offset.c_str());
+	this->write("%sgraph[pad = \"0.212, 0.055\" bgcolor = lightgray]\n", this->offset.c_str());
+	this->write("%snode[shape=circle style = filled label = \"\"]\n", this->offset.c_str());
 	this->offset = "\t\t";
 }
 
@@ -181,24 +176,52 @@ void File::TPGGraphDotExporter::printTPGGraphFooter()
 	}
 
 	// Rank all the roots
-	fprintf(pFile, "%s{ rank= same ", this->offset.c_str());
+	this->write("%s{ rank= same ", this->offset.c_str());
 	// Team root ids
 	for (const TPG::TPGVertex* rootVertex : rootVertices) {
 		if (typeid(*rootVertex) == typeid(TPG::TPGTeam)) {
-			fprintf(pFile, "T%" PRIu64 " ", this->findVertexID(*rootVertex));
+			this->write("T%" PRIu64 " ", this->findVertexID(*rootVertex));
 		}
 	}
 	// Action root
 	for (auto rootActionId : rootActionIDs) {
-		fprintf(pFile, "A%" PRIu64 " ", rootActionId);
+		this->write("A%" PRIu64 " ", rootActionId);
 	}
-	fprintf(pFile, "}\n");
+	this->write("}\n");
 	this->offset = "";
-	fprintf(pFile, "%s}\n", this->offset.c_str());
+	this->write("%s}\n", this->offset.c_str());
 }
 
-void File::TPGGraphDotExporter::print()
+void File::TPGGraphDotExporter::write(const char* format, ...)
 {
+	va_list args;
+	va_start(args, format);
+	char buffer[256];
+	int size = vsnprintf(buffer, sizeof(buffer), format, args);
+	va_end(args);
+
+	if (size < 0) {
+		throw std::runtime_error("Could not format the dot content.");
+	}
+	if ((size_t)size < sizeof(buffer)) {
+		this->content.append(buffer, size);
+	}
+	else {
+		// Content too large for the local buffer: format it again directly
+		// in the content.
+		size_t offset = this->content.size();
+		this->content.resize(offset + size + 1);
+		va_start(args, format);
+		vsnprintf(&this->content[offset], size + 1, format, args);
+		va_end(args);
+		this->content.resize(offset + size);
+	}
+}
+
+void File::TPGGraphDotExporter::printToContent()
+{
+	this->content.clear();
+
 	// Print the graph header
 	this->printTPGGraphHeader();
 
@@ -214,14 +237,33 @@ void File::TPGGraphDotExporter::print()
 	this->programID.erase(this->programID.begin(), this->programID.end());
 
 	// Print all edges
-	auto edges = this->tpg.getEdges();
+	const std::list<TPG::TPGEdge>& edges = this->tpg.getEdges();
 	for (const TPG::TPGEdge& edge : edges) {
 		this->printTPGEdge(edge);
 	}
 
 	// Print footer
 	this->printTPGGraphFooter();
+}
 
-	// flush file
+void File::TPGGraphDotExporter::print()
+{
+	if (this->pFile == NULL) {
+		throw std::runtime_error("No file was opened for the TPGGraphDotExporter.");
+	}
+
+	this->printToContent();
+
+	// Write the whole content at once and flush file
+	if (fwrite(this->content.data(), 1, this->content.size(), this->pFile) != this->content.size()) {
+		throw std::runtime_error("Could not write the dot content of the TPGGraph.");
+	}
 	fflush(pFile);
 }
+
+const std::string& File::TPGGraphDotExporter::printToString()
+{
+	this->printToContent();
+
+	return this->content;
+}
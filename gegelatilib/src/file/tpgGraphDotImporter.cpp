@@ -34,155 +34,142 @@
  * knowledge of the CeCILL-C license and that you accept its terms.
  */
 
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+
 #include "file/tpgGraphDotImporter.h"
 
 
 const std::string File::TPGGraphDotImporter::lineSeparator("&#92;n");
-const std::string File::TPGGraphDotImporter::teamRegex("T([0-9]+)\\x20\\x5B.*\\x5D");
-const std::string File::TPGGraphDotImporter::programRegex("P([0-9]+)\\x20\\x5B.*\\x5D");
-const std::string File::TPGGraphDotImporter::instructionRegex("I([0-9]+)\\x20\\x5B.*label=\"(.*)\"\\x5D");
-const std::string File::TPGGraphDotImporter::actionRegex("A([0-9]+)\\x20\\x5B.*=\"([0-9]+)\"\\x5D");
-const std::string File::TPGGraphDotImporter::linkProgramInstructionRegex("P([0-9]+)\\x20->\\x20I([0-9]+).*");
-const std::string File::TPGGraphDotImporter::linkProgramActionRegex("T([0-9]+)\\x20->\\x20P([0-9]+)\\x20->\\x20A([0-9]+).*");
-const std::string File::TPGGraphDotImporter::linkProgramTeamRegex("T([0-9]+)\\x20->\\x20P([0-9]+)\\x20->\\x20T([0-9]+).*");
-const std::string File::TPGGraphDotImporter::addLinkProgramRegex("T([0-9]+)\\x20->\\x20P([0-9]+)");
-
-void File::TPGGraphDotImporter::readParameters(std::string& str, Program::Line& l)
+
+uint64_t File::TPGGraphDotImporter::parseUnsigned(const char*& cursor)
+{
+	if (*cursor < '0' || *cursor > '9') {
+		throw std::invalid_argument("Expected a number in the dot file.");
+	}
+	uint64_t value = 0;
+	while (*cursor >= '0' && *cursor <= '9') {
+		const uint64_t digit = (uint64_t)(*cursor - '0');
+		if (value > (UINT64_MAX - digit) / 10) {
+			throw std::out_of_range("Number out of range in the dot file.");
+		}
+		value = value * 10 + digit;
+		cursor++;
+	}
+	return value;
+}
+
+int64_t File::TPGGraphDotImporter::parseSigned(const char*& cursor)
+{
+	bool negative = (*cursor == '-');
+	if (negative || *cursor == '+') {
+		cursor++;
+	}
+	uint64_t value = parseUnsigned(cursor);
+	if (value > (uint64_t)INT64_MAX + ((negative) ? 1 : 0)) {
+		throw std::out_of_range("Number out of range in the dot file.");
+	}
+	return (negative) ? (int64_t)(0 - value) : (int64_t)value;
+}
+
+bool File::TPGGraphDotImporter::skipToken(const char*& cursor, const char* token)
 {
-	std::string::size_type pos = 0;
-	std::string::size_type pos2;
+	const char* iter = cursor;
+	while (*token != '\0') {
+		if (*iter != *token) {
+			return false;
+		}
+		iter++;
+		token++;
+	}
+	cursor = iter;
+	return true;
+}
 
+void File::TPGGraphDotImporter::readParameters(const char*& cursor, const char* end, Program::Line& l)
+{
 	uint64_t p_idx = 0;
 
-	int16_t p_value;
-	// parameters are stored in str with the following format :
-	// param1|param2|...|param_N
-	while (!str.empty())
+	// parameters are stored with the following format :
+	// param1|param2|...|param_N|
+	while (cursor < end)
 	{
-		pos2 = str.find("|");
-		p_value = std::stoi(str.substr(pos, pos2));
-		pos2++; 									// skip the '|'
-		str = str.substr(pos2, str.size());			// store the rest of the string and iterate
-		l.setParameter(p_idx, { p_value });
+		int64_t p_value = parseSigned(cursor);
+		if (p_value < INT16_MIN || p_value > INT16_MAX) {
+			throw std::out_of_range("Parameter out of range in the dot file.");
+		}
+		skipToken(cursor, "|");
+		l.setParameter(p_idx, { (int16_t)p_value });
 		p_idx++;
 	}
 }
 
-void File::TPGGraphDotImporter::readOperands(std::string& str, Program::Line& l)
+void File::TPGGraphDotImporter::readOperands(const char*& cursor, Program::Line& l)
 {
-	std::string::size_type pos = 0;
-	std::string::size_type pos2;
-	std::string::size_type pos3;
-
-	uint64_t o_idx = 0;
-	uint64_t dataIndex = 0;
-	uint64_t location = 0;
-
-	// operands are stored in str with the following format :
-	// op1_param1|op1_param2#...|param_N
-
-	for (int i = 0; i < this->tpg.getEnvironment().getMaxNbOperands(); ++i)
+	// operands are stored with the following format :
+	// op1_param1|op1_param2#...#opN_param1|opN_param2
+	for (uint64_t o_idx = 0; o_idx < this->tpg.getEnvironment().getMaxNbOperands(); ++o_idx)
 	{
-		pos2 = str.find("|");
-		dataIndex = std::stoi(str.substr(pos, pos2));
-		pos2++; 												// skip the '|'
-		pos3 = str.find("#");
-		location = std::stoi(str.substr(pos2, pos3 - pos2));
-		str = str.substr(pos3 + 1, str.size() - pos3);			// store the rest of the string and iterate
+		if (o_idx != 0 && !skipToken(cursor, "#")) {
+			throw std::invalid_argument("Expected an operand in the dot file.");
+		}
+		uint64_t dataIndex = parseUnsigned(cursor);
+		skipToken(cursor, "|");
+		uint64_t location = parseUnsigned(cursor);
 
 		l.setOperand(o_idx, dataIndex, location, true);
-		o_idx++;
 	}
 }
 
-void File::TPGGraphDotImporter::readLine(std::smatch& matches)
+void File::TPGGraphDotImporter::readLine(uint64_t program, const char* label, const char* end)
 {
 	// a line is stored in the .dot file with the following format
 	// inst_idx|dest_idx&param_1|param_2|...|param_n$op1_param1|op1_param2#...#opN_param1|opN_param2
-	if (!this->lastLine.empty() && !matches.empty())
+	auto p_it = programID.find(program);
+	if (p_it != programID.end() && label < end)
 	{
-		uint64_t prog_label = std::stoi(matches[1]);
-		std::string label = matches[2];
+		std::shared_ptr<Program::Program> p = p_it->second;
 
-		auto p_it = programID.find(prog_label);
-		if (p_it != programID.end() && !label.empty())
+		//as long as there are lines in the program, parse those lines
+		const char* cursor = label;
+		while (cursor < end)
 		{
-			std::shared_ptr<Program::Program> p = p_it->second;
-			//stores the whole program
-			std::string instruction;
-
-			//used to seek delimiters in the variable "instruction"
-			std::string::size_type pos;
-			std::string::size_type pos1;
-			std::string::size_type pos2;
-
-			//instruction index of a line
-			uint64_t instructionIdx;
-			//destination index of a line
-			uint64_t destinationIdx;
-			//store paramteres in a new string
-			std::string parameters;
-			//store operands in a new string 
-			std::string operands;
-
-			//as long as there are lines in the program, parse those lines
-			bool cont = true;
-			while (cont)
-			{
-				Program::Line& l = p.get()->addNewLine();
-				pos = label.find(this->lineSeparator);
-				instruction = label.substr(0, pos);
-				label = label.substr(pos + this->lineSeparator.size(), label.size());
-
-				//extract everything before pos (ie |)
-				//corresponds to instruction index
-				pos1 = instruction.find("|");
-				instructionIdx = std::stoi(instruction.substr(0, pos1));
-
-				//extract destination index;
-				pos2 = instruction.find("&");
-				pos1++; 															//skip the '|'
-				destinationIdx = std::stoi(instruction.substr(pos1, pos2 - pos1));	//extract and convert to int
-
-				//extract parameters as a string
-				pos1 = instruction.find("$");										//parameters are in between & and $
-				pos2++;																// skip the '&'
-				parameters = instruction.substr(pos2, pos1 - pos2);
-
-				//extract operands as a string
-				pos2 = instruction.size() - 1; 										//corresponds to the last index of the string.
-				pos1++;																//slip the '$'
-				operands = instruction.substr(pos1, instruction.size());
-
-				//add indexes to line 
-				l.setInstructionIndex(instructionIdx);
-				l.setDestinationIndex(destinationIdx);
-
-				//parse parameters
-				readParameters(parameters, l);
-
-				//parse operands
-				readOperands(operands, l);
-
-				if (label.size() <= 3)
-				{
-					cont = false;
-				}
+			Program::Line& l = p.get()->addNewLine();
+
+			// instruction index and destination index
+			uint64_t instructionIdx = parseUnsigned(cursor);
+			skipToken(cursor, "|");
+			uint64_t destinationIdx = parseUnsigned(cursor);
+			skipToken(cursor, "&");
+
+			//add indexes to line 
+			l.setInstructionIndex(instructionIdx);
+			l.setDestinationIndex(destinationIdx);
+
+			//parse parameters (in between & and $)
+			const char* parametersEnd = std::find(cursor, end, '$');
+			readParameters(cursor, parametersEnd, l);
+			skipToken(cursor, "$");
+
+			//parse operands
+			readOperands(cursor, l);
+
+			// skip the line separator
+			if (!skipToken(cursor, this->lineSeparator.c_str()) && cursor < end) {
+				throw std::invalid_argument("Unexpected characters after a Program line in the dot file.");
 			}
-			p->identifyIntrons();
 		}
+		p->identifyIntrons();
 	}
 }
 
-void File::TPGGraphDotImporter::readProgram(std::smatch& matches)
+void File::TPGGraphDotImporter::readProgram(uint64_t program)
 {
-	if (!this->lastLine.empty() && !matches.empty())
-	{
-		// Program definition : 
-		// P0 [fillcolor="#cccccc" shape=point]
-		this->programID.insert(std::pair<uint64_t, std::shared_ptr<Program::Program>>(std::stoi(matches[1]),
-			new Program::Program(this->tpg.getEnvironment())));
-	}
+	// Program definition : 
+	// P0 [fillcolor="#cccccc" shape=point]
+	this->programID.insert(std::pair<uint64_t, std::shared_ptr<Program::Program>>(program,
+		new Program::Program(this->tpg.getEnvironment())));
 }
 
 void File::TPGGraphDotImporter::dumpTPGGraphHeader()
@@ -194,119 +181,80 @@ void File::TPGGraphDotImporter::dumpTPGGraphHeader()
 	pFile.getline(buffer, MAX_READ_SIZE);
 }
 
-void File::TPGGraphDotImporter::readTeam(std::smatch& matches)
+void File::TPGGraphDotImporter::readTeam(uint64_t team)
 {
-	if (!this->lastLine.empty() && !matches.empty())
-	{
-		this->vertexID.insert(std::pair<uint64_t, const TPG::TPGVertex*>(std::stoi(matches[1]), &this->tpg.addNewTeam()));
-	}
+	this->vertexID.insert(std::pair<uint64_t, const TPG::TPGVertex*>(team, &this->tpg.addNewTeam()));
 }
 
-void File::TPGGraphDotImporter::readAction(std::smatch& matches)
+void File::TPGGraphDotImporter::readAction(uint64_t action_number, uint64_t action_label)
 {
-	if (!this->lastLine.empty() && !matches.empty())
+	//elmt points to the action with the same label as the action we are parsing
+	auto elmt = actionID.find(action_label);
+	if (elmt == actionID.end())
 	{
-		//the regex matches two groups (action number and action label)
-		uint64_t action_label = std::stoi(matches[2]);
-		uint64_t action_number = std::stoi(matches[1]);
-
-		//elmt points to the action with the same label as the action we are parsing
-		auto elmt = actionID.find(action_label);
-		if (elmt == actionID.end())
-		{
-			//create a new action and insert it if none was previously found
-			this->actionID.insert(std::pair<uint64_t, const TPG::TPGVertex*>(action_label, &this->tpg.addNewAction(action_label)));
-		}
-		this->actionLabel.insert(std::pair<uint64_t, uint64_t>(action_number, action_label));
+		//create a new action and insert it if none was previously found
+		this->actionID.insert(std::pair<uint64_t, const TPG::TPGVertex*>(action_label, &this->tpg.addNewAction(action_label)));
 	}
+	this->actionLabel.insert(std::pair<uint64_t, uint64_t>(action_number, action_label));
 }
 
-void File::TPGGraphDotImporter::readLinkTeamProgramAction(std::smatch& matches)
+void File::TPGGraphDotImporter::readLinkTeamProgramAction(uint64_t team_in, uint64_t program, uint64_t act_out)
 {
 	//Creating a edge from a team to an action
-	if (!this->lastLine.empty() && !matches.empty())
+	//get the action depending on its label
+	auto action_lab = this->actionLabel.find(act_out);
+	if (action_lab != this->actionLabel.end())
 	{
-		uint64_t team_in = std::stoi(matches[1]);
-		uint64_t program = std::stoi(matches[2]);
-		uint64_t act_out = std::stoi(matches[3]);
-
-		//get the action depending on its label
-		auto action_lab = this->actionLabel.find(act_out);
-		if (action_lab != this->actionLabel.end())
+		auto team_it = this->vertexID.find(team_in);
+		auto action_it = this->actionID.find(action_lab->second);
+		//find the program to add to the edge
+		auto p_it = programID.find(program);
+		if (team_it != vertexID.end() && action_it != this->actionID.end() && p_it != programID.end())
 		{
-			auto team_it = this->vertexID.find(team_in);
-			auto action_it = this->actionID.find(action_lab->second);
-			//find the program to add to the edge
-			auto p_it = programID.find(program);
-			if (team_it != vertexID.end() && action_it != this->actionID.end() && p_it != programID.end())
-			{
-				const TPG::TPGVertex* team = team_it->second;
-				const TPG::TPGVertex* action = action_it->second;
-				std::shared_ptr<Program::Program> p = p_it->second;
-				this->tpg.addNewEdge(*team, *action, p);
-			}
+			const TPG::TPGVertex* team = team_it->second;
+			const TPG::TPGVertex* action = action_it->second;
+			std::shared_ptr<Program::Program> p = p_it->second;
+			this->tpg.addNewEdge(*team, *action, p);
+			this->programDestination.emplace(program, action);
 		}
 	}
 }
 
-void File::TPGGraphDotImporter::readLinkTeamProgramTeam(std::smatch& matches)
+void File::TPGGraphDotImporter::readLinkTeamProgramTeam(uint64_t team_in, uint64_t program, uint64_t team_out)
 {
 	//creating a edge between two teams
-	if (!this->lastLine.empty() && !matches.empty())
-	{
-		uint64_t team_in = std::stoi(matches[1]);
-		uint64_t program = std::stoi(matches[2]);
-		uint64_t team_out = std::stoi(matches[3]);
-
-		//get the source and destination teams
-		auto t1_it = this->vertexID.find(team_in);
-		auto t2_it = this->vertexID.find(team_out);
+	//get the source and destination teams
+	auto t1_it = this->vertexID.find(team_in);
+	auto t2_it = this->vertexID.find(team_out);
 
-		//find the program
-		auto p_it = programID.find(program);
-		if (p_it != programID.end())
+	//find the program
+	auto p_it = programID.find(program);
+	if (p_it != programID.end())
+	{
+		std::shared_ptr<Program::Program> p = p_it->second;
+		if (t1_it != this->vertexID.end() && t2_it != this->vertexID.end())
 		{
-			std::shared_ptr<Program::Program> p = p_it->second;
-			if (t1_it != this->vertexID.end() && t2_it != this->vertexID.end())
-			{
-				const TPG::TPGVertex* team_i = t1_it->second;
-				const TPG::TPGVertex* team_o = t2_it->second;
-				this->tpg.addNewEdge(*team_i, *team_o, p);
-			}
+			const TPG::TPGVertex* team_i = t1_it->second;
+			const TPG::TPGVertex* team_o = t2_it->second;
+			this->tpg.addNewEdge(*team_i, *team_o, p);
+			this->programDestination.emplace(program, team_o);
 		}
 	}
 }
 
-void File::TPGGraphDotImporter::readLinkTeamProgram(std::smatch& matches)
+void File::TPGGraphDotImporter::readLinkTeamProgram(uint64_t team_in, uint64_t program)
 {
-	if (!this->lastLine.empty() && !matches.empty())
+	//find the destination of the first edge of the program
+	auto p_it = programID.find(program);
+	auto dest_it = this->programDestination.find(program);
+	if (p_it != programID.end() && dest_it != this->programDestination.end())
 	{
-		uint64_t team_in = std::stoi(matches[1]);
-		uint64_t program = std::stoi(matches[2]);
-
-		//find edge
-		const std::list<TPG::TPGEdge>& edges = this->tpg.getEdges();
-
-		//find one of the selected program edges : 
-		auto p_it = programID.find(program);
-		if (p_it != programID.end())
+		//then get the team : 
+		auto team_it = this->vertexID.find(team_in);
+		if (team_it != this->vertexID.end())
 		{
-			std::shared_ptr<Program::Program> p = p_it->second;
-
-			auto edge_it = std::find_if(edges.begin(), edges.end(),
-				[p](const TPG::TPGEdge& other) {
-					return (&(other.getProgram()) == p.get());
-				});
-			if (edge_it != edges.end())			//we got the corresponding edge : 
-			{
-				//then get the team : 
-				auto team_it = this->vertexID.find(team_in);
-				if (team_it != this->vertexID.end())
-				{
-					const TPG::TPGVertex* team = team_it->second;
-					this->tpg.addNewEdge(*team, *edge_it->getDestination(), p);
-				}
-			}
+			const TPG::TPGVertex* team = team_it->second;
+			this->tpg.addNewEdge(*team, *dest_it->second, p_it->second);
 		}
 	}
 }
@@ -315,6 +263,7 @@ void File::TPGGraphDotImporter::readLinkTeamProgram(std::smatch& matches)
 void File::TPGGraphDotImporter::importGraph()
 {
 	//force seek at the beginning of file.
+	pFile.clear();
 	pFile.seekg(0);
 
 	//clear every storing objects
@@ -323,6 +272,7 @@ void File::TPGGraphDotImporter::importGraph()
 	this->actionID.clear();
 	this->actionLabel.clear();
 	this->programID.clear();
+	this->programDestination.clear();
 
 	// skip header
 	this->dumpTPGGraphHeader();
@@ -336,64 +286,97 @@ void File::TPGGraphDotImporter::importGraph()
 
 bool File::TPGGraphDotImporter::readLineFromFile()
 {
-	char buffer[MAX_READ_SIZE];
-
-	std::regex testActionDeclare(this->actionRegex);
-	std::regex testTeamDeclare(this->teamRegex);
-	std::regex testProgramDeclare(this->programRegex);
-	std::regex testInstructionDeclare(this->instructionRegex);
-	std::regex testLinkPI(this->linkProgramInstructionRegex);
-	std::regex testLinkTPA(this->linkProgramActionRegex);
-	std::regex testLinkTPT(this->linkProgramTeamRegex);
-	std::regex testLinkTP(this->addLinkProgramRegex);
-
-	std::smatch matches;
-
-	if (!pFile.getline(buffer, MAX_READ_SIZE))
+	// Lines describing Programs have no length limit.
+	if (!std::getline(pFile, this->lastLine))
 		throw std::ifstream::failure("Couldn't read in the given file");
-	else
-	{
-		this->lastLine = buffer;
-	}
 
-	// check the line shape and parse it 
-	if (std::regex_search(this->lastLine, matches, testTeamDeclare))
-	{
-		readTeam(matches);
+	// Ignore indentation and trailing whitespaces.
+	const char* cursor = this->lastLine.c_str();
+	const char* end = cursor + this->lastLine.size();
+	while (*cursor == ' ' || *cursor == '\t') {
+		cursor++;
 	}
-	else if (std::regex_search(this->lastLine, matches, testActionDeclare))
-	{
-		readAction(matches);
+	while (end > cursor && (end[-1] == ' ' || end[-1] == '\t' || end[-1] == '\r')) {
+		end--;
 	}
-	else if (std::regex_search(this->lastLine, matches, testProgramDeclare))
-	{
-		readProgram(matches);
-	}
-	else if (std::regex_search(this->lastLine, matches, testInstructionDeclare))
-	{
-		readLine(matches);
-	}
-	else if (std::regex_search(this->lastLine, matches, testLinkPI))
-	{
-		// by definition, a program is linked to its instruction from its declaration.
-		// the link is used vor visualisation but doesn't require to be parsed
-		return true;
+
+	// check the line shape and parse it
+	const char kind = *cursor;
+	if (kind != 'T' && kind != 'A' && kind != 'P' && kind != 'I') {
+		return false;
 	}
-	else if (std::regex_search(this->lastLine, matches, testLinkTPA))
-	{
-		readLinkTeamProgramAction(matches);
+	cursor++;
+	if (*cursor < '0' || *cursor > '9') {
+		return false;
 	}
-	else if (std::regex_search(this->lastLine, matches, testLinkTPT))
-	{
-		readLinkTeamProgramTeam(matches);
+	const uint64_t id = parseUnsigned(cursor);
+	const bool isDeclaration = skipToken(cursor, " [") && end[-1] == ']';
+
+	switch (kind) {
+	case 'T':
+		if (isDeclaration) {
+			readTeam(id);
+		}
+		else if (skipToken(cursor, " -> P") && *cursor >= '0' && *cursor <= '9') {
+			uint64_t program = parseUnsigned(cursor);
+			if (skipToken(cursor, " -> A") && *cursor >= '0' && *cursor <= '9') {
+				readLinkTeamProgramAction(id, program, parseUnsigned(cursor));
+			}
+			else if (skipToken(cursor, " -> T") && *cursor >= '0' && *cursor <= '9') {
+				readLinkTeamProgramTeam(id, program, parseUnsigned(cursor));
+			}
+			else {
+				readLinkTeamProgram(id, program);
+			}
+		}
+		else {
+			return false;
+		}
+		break;
+	case 'A': {
+		// The action label is the last ="..." of the declaration.
+		if (!isDeclaration || end - cursor < 2 || end[-2] != '"') {
+			return false;
+		}
+		const char* labelEnd = end - 2;
+		const char* labelBegin = labelEnd;
+		while (labelBegin > cursor && labelBegin[-1] >= '0' && labelBegin[-1] <= '9') {
+			labelBegin--;
+		}
+		if (labelBegin == labelEnd || labelBegin - cursor < 2 || labelBegin[-1] != '"' || labelBegin[-2] != '=') {
+			return false;
+		}
+		readAction(id, parseUnsigned(labelBegin));
+		break;
 	}
-	else if (std::regex_search(this->lastLine, matches, testLinkTP))
-	{
-		readLinkTeamProgram(matches);
+	case 'P':
+		if (isDeclaration) {
+			readProgram(id);
+		}
+		else if (skipToken(cursor, " -> I") && *cursor >= '0' && *cursor <= '9') {
+			// by definition, a program is linked to its instruction from its declaration.
+			// the link is used vor visualisation but doesn't require to be parsed
+			return true;
+		}
+		else {
+			return false;
+		}
+		break;
+	case 'I': {
+		// The lines of the program are in the last label="..." of the
+		// declaration.
+		if (!isDeclaration || end - cursor < 2 || end[-2] != '"') {
+			return false;
+		}
+		const std::string labelToken("label=\"");
+		const char* labelEnd = end - 2;
+		const char* labelBegin = std::find_end(cursor, labelEnd, labelToken.begin(), labelToken.end());
+		if (labelBegin == labelEnd) {
+			return false;
+		}
+		readLine(id, labelBegin + labelToken.size(), labelEnd);
+		break;
 	}
-	else
-	{
-		return false;
 	}
 	return true;
 }
@@ -85,3 +85,8 @@ double Instruction::execute(
 		return 1.0;
 	}
 }
+
+Instruction::Kernel Instruction::getKernel() const
+{
+	return nullptr;
+}
@@ -137,7 +137,7 @@ std::multimap< std::shared_ptr<Learn::EvaluationResult>, const TPG::TPGVertex*>
 
 	// Create the TPGExecutionEngine for this evaluation.
 	// The engine uses the Archive only in training mode.
-	TPG::TPGExecutionEngine tee(this->env, (mode == LearningMode::TRAINING) ? &this->archive : NULL);
+	TPG::TPGExecutionEngine tee(this->env, (mode == LearningMode::TRAINING) ? &this->archive : NULL, this->params.bidCacheSize);
 
 	for (const TPG::TPGVertex* root : this->tpg.getRootVertices()) {
 		// Before each root evaluation, set a new seed for the archive in TRAINING Mode
@@ -158,6 +158,11 @@ void Learn::LearningAgent::trainOneGeneration(uint64_t generationNumber)
 	// Populate Sequentially
 	Mutator::TPGMutator::populateTPG(this->tpg, this->archive, this->params.mutation, this->rng, 1);
 
+	// Share identical Programs
+	if (this->programDeduplication) {
+		this->tpg.internPrograms();
+	}
+
 	// Evaluate
 	auto results = this->evaluateAllRoots(generationNumber, LearningMode::TRAINING);
 
@@ -207,6 +212,11 @@ uint64_t Learn::LearningAgent::train(volatile bool& altTraining, bool printProgr
 		trainOneGeneration(generationNumber);
 		generationNumber++;
 
+		// Save a snapshot of the TPGGraph in the background
+		if (this->checkpointPeriod > 0 && generationNumber % this->checkpointPeriod == 0) {
+			this->checkpointer->checkpoint(this->tpg);
+		}
+
 		// Print progressBar (homemade, probably not ideal)
 		if (printProgressBar) {
 			printf("\rTraining ["); // back
@@ -227,6 +237,11 @@ uint64_t Learn::LearningAgent::train(volatile bool& altTraining, bool printProgr
 		}
 	}
 
+	// Wait for the last checkpoint
+	if (this->checkpointPeriod > 0) {
+		this->checkpointer->wait();
+	}
+
 	if (printProgressBar) {
 		if (!altTraining) {
 			printf("\nTraining completed\n");
@@ -238,6 +253,23 @@ uint64_t Learn::LearningAgent::train(volatile bool& altTraining, bool printProgr
 	return generationNumber;
 }
 
+void Learn::LearningAgent::setCheckpoint(const char* filePath, uint64_t period)
+{
+	// Wait for the running export of the previous checkpointer.
+	this->checkpointer.reset();
+	this->checkpointPeriod = 0;
+
+	if (filePath != nullptr && period > 0) {
+		this->checkpointer.reset(new File::TPGGraphCheckpointer(filePath));
+		this->checkpointPeriod = period;
+	}
+}
+
+void Learn::LearningAgent::setProgramDeduplication(bool enable)
+{
+	this->programDeduplication = enable;
+}
+
 void Learn::LearningAgent::updateEvaluationRecords(std::multimap<std::shared_ptr<EvaluationResult>, const TPG::TPGVertex*> results)
 {
 	{ // Update resultsPerRoot 
@@ -35,9 +35,7 @@
 
 #include <algorithm>
 #include <iterator>
-#include <thread>
-#include <queue>
-#include <mutex>
+#include <memory>
 
 #include "mutator/rng.h"
 #include "mutator/tpgMutator.h"
@@ -54,7 +52,7 @@ std::multimap< std::shared_ptr<Learn::EvaluationResult>, const TPG::TPGVertex*>
 		// Sequential mode
 
 		// Create the TPGExecutionEngine
-		TPG::TPGExecutionEngine tee(this->env, (mode == LearningMode::TRAINING) ? &this->archive : NULL);
+		TPG::TPGExecutionEngine tee(this->env, (mode == LearningMode::TRAINING) ? &this->archive : NULL, this->params.bidCacheSize);
 
 		// Execute for all root
 		for (const TPG::TPGVertex* root : this->tpg.getRootVertices()) {
@@ -74,170 +72,98 @@ std::multimap< std::shared_ptr<Learn::EvaluationResult>, const TPG::TPGVertex*>
 	return results;
 }
 
-void Learn::ParallelLearningAgent::slaveEvalRootThread(uint64_t generationNumber, LearningMode mode,
-	std::queue<std::pair<uint64_t, const TPG::TPGVertex*>>& rootsToProcess, std::mutex& rootsToProcessMutex,
-	std::map<uint64_t, std::pair<std::shared_ptr<EvaluationResult>, const TPG::TPGVertex*>>& resultsPerRootMap, std::mutex& resultsPerRootMapMutex,
-	std::map<uint64_t, size_t>& archiveSeeds,
-	std::map<uint64_t, Archive*>& archiveMap, std::mutex& archiveMapMutex) {
-
-	// Clone learningEnvironment
-	LearningEnvironment* privateLearningEnvironment = this->learningEnvironment.clone();
-
-	// Create a TPGExecutionEngine
-	Environment privateEnv(this->env.getInstructionSet(), privateLearningEnvironment->getDataSources(), this->env.getNbRegisters());
-	TPG::TPGExecutionEngine tee(privateEnv, NULL);
-
-	// Pop a job
-	while (!rootsToProcess.empty()) { // Thread safe access to size
-		bool doProcess = false;
-		std::pair<uint64_t, const TPG::TPGVertex*> rootToProcess;
-		{ // Mutuel exclusion zone
-			std::lock_guard<std::mutex> lock(rootsToProcessMutex);
-			if (!rootsToProcess.empty()) { // Additional verification after lock
-				rootToProcess = rootsToProcess.front();
-				rootsToProcess.pop();
-				doProcess = true;
-			}
-		} // End of mutual exclusion zone
-
-		// Processing to do?
-		if (doProcess) {
-			doProcess = false;
-			//Dedicated archive for the root
-			Archive* temporaryArchive = NULL;
-			if (mode == LearningMode::TRAINING) {
-				temporaryArchive = new Archive(params.archiveSize, params.archivingProbability, archiveSeeds.at(rootToProcess.first));
-			}
-			tee.setArchive(temporaryArchive);
-
-			std::shared_ptr<EvaluationResult> avgScore = this->evaluateRoot(tee, *rootToProcess.second, generationNumber, mode, *privateLearningEnvironment);
-
-			{	// Store result Mutual exclusion zone
-				std::lock_guard<std::mutex> lock(resultsPerRootMapMutex);
-				resultsPerRootMap.emplace(rootToProcess.first, std::make_pair(avgScore, rootToProcess.second));
-			}
-
-			if (mode == LearningMode::TRAINING) {
-				{	// Insertion archiveMap update mutual exclusion zone
-					std::lock_guard<std::mutex> lock(archiveMapMutex);
-					archiveMap.insert({ rootToProcess.first, temporaryArchive });
-				}
-			}
-		}
+Learn::ParallelLearningAgent::EvaluationContext& Learn::ParallelLearningAgent::getEvaluationContext(uint64_t threadIdx)
+{
+	EvaluationContext& context = this->evaluationContexts.at(threadIdx);
+	if (context.tee == nullptr) {
+		// Clone learningEnvironment and create a TPGExecutionEngine
+		context.learningEnvironment.reset(this->learningEnvironment.clone());
+		context.environment.reset(new Environment(this->env.getInstructionSet(), context.learningEnvironment->getDataSources(), this->env.getNbRegisters()));
+		context.tee.reset(new TPG::TPGExecutionEngine(*context.environment, NULL, this->params.bidCacheSize));
+		context.archiveBuffer.reset(new ArchiveRecordingBuffer(this->params.archiveSize, this->params.archivingProbability));
+	}
+	else {
+		context.tee->clearBidCache();
+		context.archiveBuffer->clearBuffer();
 	}
 
-	// Clean up
-	delete privateLearningEnvironment;
+	return context;
 }
 
-void Learn::ParallelLearningAgent::mergeArchiveMap(std::map<uint64_t, Archive*>& archiveMap)
+void Learn::ParallelLearningAgent::clearEvaluationContexts()
 {
-	// Scan the archives backward, starting from the last to identify the 
-	// last params.archiveSize recordings to keep (or less).
-	auto reverseIterator = archiveMap.rbegin();
-
-	uint64_t nbRecordings = 0;
-	while (nbRecordings < this->params.archiveSize && reverseIterator != archiveMap.rend()) {
-		nbRecordings += reverseIterator->second->getNbRecordings();
-		reverseIterator++;
+	for (EvaluationContext& context : this->evaluationContexts) {
+		context.archiveBuffer.reset();
+		context.tee.reset();
+		context.environment.reset();
+		context.learningEnvironment.reset();
 	}
+}
 
-	// Insert identified recordings into this->archive
-	while (reverseIterator != archiveMap.rbegin()) {
-		reverseIterator--;
-
-		auto i = reverseIterator->first;
-
-		// Skip recordings in the first archive if needed
-		uint64_t recordingIdx = 0;
-		while (nbRecordings > this->params.archiveSize) {
-			recordingIdx++;
-			nbRecordings--;
-		}
+void Learn::ParallelLearningAgent::evaluateAllRootsInParallel(uint64_t generationNumber, LearningMode mode, std::multimap<std::shared_ptr<EvaluationResult>, const TPG::TPGVertex*>& results) {
+	// Each root is associated to its number in the list for enabling the 
+	// determinism of stochastic archive storage.
+	const std::vector<const TPG::TPGVertex*> roots = this->tpg.getRootVertices();
 
-		// Insert remaining recordings
-		while (recordingIdx < reverseIterator->second->getNbRecordings()) {
-			// Access in reverse order
-			const ArchiveRecording& recording = reverseIterator->second->at(recordingIdx);
-			// forced Insertion
-			this->archive.addRecording(recording.prog, reverseIterator->second->getDataHandlers().at(recording.dataHash), recording.result, true);
-			recordingIdx++;
+	// Draw the seeds for the Archive of each root
+	std::vector<size_t> archiveSeeds;
+	if (mode == LearningMode::TRAINING) {
+		for (uint64_t idx = 0; idx < roots.size(); idx++) {
+			archiveSeeds.push_back(this->rng.getUnsignedInt64(0, UINT64_MAX));
 		}
 	}
 
-	// delete all archives
-	reverseIterator = archiveMap.rbegin();
-	while (reverseIterator != archiveMap.rend()) {
-		delete reverseIterator->second;
-		reverseIterator++;
-	}
-}
+	// Results of each root, indexed by root number.
+	std::vector<std::shared_ptr<EvaluationResult>> resultsPerRoot(roots.size());
 
-void Learn::ParallelLearningAgent::evaluateAllRootsInParallel(uint64_t generationNumber, LearningMode mode, std::multimap<std::shared_ptr<EvaluationResult>, const TPG::TPGVertex*>& results) {
-	// Create and fill the queue for distributing work among threads
-	// each root is associated to its number in the list for enabling the 
-	// determinism of stochastic archive storage.
-	std::queue<std::pair<uint64_t, const TPG::TPGVertex*>> rootsToProcess;
-	uint64_t idx = 0;
+	// Flag indicating whether the EvaluationContext of each thread was
+	// prepared for this call. (std::vector<bool> is not used since its 
+	// elements cannot be written concurrently.)
+	std::vector<uint8_t> contextReady(this->threadPool.getNbThreads(), false);
 
-	// Fill also a map for seeding the Archive for each root
-	std::map<uint64_t, size_t> archiveSeeds;
+	this->threadPool.parallelFor(roots.size(), [&, this](uint64_t rootIdx, uint64_t threadIdx) {
+		EvaluationContext& context = (contextReady.at(threadIdx)) ? this->evaluationContexts.at(threadIdx) : this->getEvaluationContext(threadIdx);
+		contextReady.at(threadIdx) = true;
+		TPG::TPGExecutionEngine& tee = *context.tee;
 
-	for (const TPG::TPGVertex* root : this->tpg.getRootVertices()) {
-		rootsToProcess.push({ idx , root });
+		// Dedicated segment of the thread archive buffer for the root
 		if (mode == LearningMode::TRAINING) {
-			archiveSeeds.insert({ idx, this->rng.getUnsignedInt64(0, UINT64_MAX) });
+			context.archiveBuffer->startSegment(rootIdx, archiveSeeds.at(rootIdx));
+			tee.setArchive(context.archiveBuffer.get());
+		}
+		else {
+			tee.setArchive(NULL);
 		}
-		idx++;
-	}
-
-	// Create Archive Map
-	std::map<uint64_t, Archive*> archiveMap;
-	// Create Map for results
-	std::map<uint64_t, std::pair<std::shared_ptr<EvaluationResult>, const TPG::TPGVertex*>> resultsPerRootMap;
-
-	// Create mutexes
-	std::mutex rootsToProcessMutex;
-	std::mutex resultsPerRootMutex;
-	std::mutex archiveMapMutex;
-
-	// Create the threads
-	std::vector<std::thread> threads;
-	for (auto i = 0; i < (this->maxNbThreads - 1); i++) {
-		threads.emplace_back(std::thread(&ParallelLearningAgent::slaveEvalRootThread, this,
-			generationNumber, mode,
-			std::ref(rootsToProcess), std::ref(rootsToProcessMutex),
-			std::ref(resultsPerRootMap), std::ref(resultsPerRootMutex),
-			std::ref(archiveSeeds),
-			std::ref(archiveMap), std::ref(archiveMapMutex)
-		));
-	}
-
-	// Work in the main thread also
-	this->slaveEvalRootThread(generationNumber, mode,
-		rootsToProcess, rootsToProcessMutex,
-		resultsPerRootMap, resultsPerRootMutex,
-		archiveSeeds,
-		archiveMap, archiveMapMutex);
 
-	// Join the threads
-	for (auto& thread : threads) {
-		thread.join();
-	}
+		resultsPerRoot.at(rootIdx) = this->evaluateRoot(tee, *roots.at(rootIdx), generationNumber, mode, *context.learningEnvironment);
+		});
 
 	// Merge the results
-	for (auto& resultPerRoot : resultsPerRootMap) {
-		results.emplace(resultPerRoot.second);
+	for (uint64_t idx = 0; idx < roots.size(); idx++) {
+		results.emplace(resultsPerRoot.at(idx), roots.at(idx));
 	}
 
-	// Merge the archives
-	this->mergeArchiveMap(archiveMap);
+	// Merge the archive buffers of threads involved in the evaluation
+	if (mode == LearningMode::TRAINING) {
+		std::vector<ArchiveRecordingBuffer*> archiveBuffers;
+		for (uint64_t threadIdx = 0; threadIdx < contextReady.size(); threadIdx++) {
+			if (contextReady.at(threadIdx)) {
+				archiveBuffers.push_back(this->evaluationContexts.at(threadIdx).archiveBuffer.get());
+			}
+		}
+		ArchiveRecordingBuffer::merge(archiveBuffers, this->archive);
+	}
 }
 
 void Learn::ParallelLearningAgent::trainOneGeneration(uint64_t generationNumber)
 {
 	// Populate Sequentially
-	Mutator::TPGMutator::populateTPG(this->tpg, this->archive, this->params.mutation, this->rng, this->maxNbThreads);
+	Mutator::TPGMutator::populateTPG(this->tpg, this->archive, this->params.mutation, this->rng, this->threadPool);
+
+	// Share identical Programs
+	if (this->programDeduplication) {
+		this->tpg.internPrograms();
+	}
 
 	// Evaluate
 	auto results = this->evaluateAllRoots(generationNumber, LearningMode::TRAINING);
@@ -125,7 +125,7 @@ bool Mutator::ProgramMutator::mutateProgram(Program::Program& p, const MutationP
 
 	// Identify introns
 	if (anyMutation) {
-		p.identifyIntrons();
+		p.updateIntrons();
 	}
 
 	return anyMutation;
@@ -37,9 +37,9 @@
 #include <algorithm>
 #include <numeric>
 #include <vector>
-#include <thread>
-#include <mutex>
-#include <queue>
+#include <set>
+#include <unordered_map>
+#include <map>
 
 #include "archive.h"
 
@@ -140,21 +140,15 @@ void Mutator::TPGMutator::initRandomTPG(TPG::TPGGraph& graph, const Mutator::Mut
 void Mutator::TPGMutator::removeRandomEdge(TPG::TPGGraph& graph, const TPG::TPGTeam& team, Mutator::RNG& rng) {
 	// Pick an outgoing edge randomly, 
 	// Copy the set 
-	std::list<TPG::TPGEdge*> pickableEdges = team.getOutgoingEdges();
+	std::vector<TPG::TPGEdge*> pickableEdges = team.getOutgoingEdges();
 	auto isTPGAction = [](const TPG::TPGEdge* edge)->bool {
 		return typeid(*edge->getDestination()) == typeid(TPG::TPGAction);
 	};
 
 	// if there is a unique TPGAction among the edges, exclude it from the pickable edges
 	if (std::count_if(pickableEdges.begin(), pickableEdges.end(), isTPGAction) == 1) {
-		for (auto iter = pickableEdges.begin(); iter != pickableEdges.end();) {
-			if (isTPGAction(*iter)) {
-				iter = pickableEdges.erase(iter);
-			}
-			else {
-				iter++;
-			}
-		}
+		// cf erase-remove idiom
+		pickableEdges.erase(std::remove_if(pickableEdges.begin(), pickableEdges.end(), isTPGAction), pickableEdges.end());
 	}
 
 	// Pick a random edge
@@ -302,16 +296,38 @@ void Mutator::TPGMutator::mutateTPGTeam(TPG::TPGGraph& graph,
 
 void Mutator::TPGMutator::mutateProgramBehaviorAgainstArchive(std::shared_ptr<Program::Program>& newProg, const Mutator::MutationParameters& params, const Archive& archive, Mutator::RNG& rng)
 {
+	const auto& archivedDataHandlers = archive.getDataHandlers();
+	Program::ProgramExecutionEngine pee(*newProg);
+	std::map<size_t, double> hashesAndResults;
+
+	// Effective codes whose behavior was already found not unique, indexed
+	// by their hash.
+	std::unordered_map<uint64_t, std::vector<std::vector<uint64_t>>> rejectedEffectiveCodes;
+
 	bool allUnique;
 	// Mutate behavior until it changes (against the archive).
 	do {
 		// Mutate until something is mutated (i.e. the function returns true)
 		while (!Mutator::ProgramMutator::mutateProgram(*newProg, params, rng));
+
+		// If the effective code of the Program is the same as a rejected
+		// one (e.g. after a neutral mutation of introns), its results are
+		// unchanged: skip the execution on the archive.
+		// The hash is maintained by the mutation in O(nbLines), and the
+		// effective code is only built to confirm a match of the hash.
+		const uint64_t effectiveCodeHash = newProg->getEffectiveCodeHash();
+		auto rejectedBucket = rejectedEffectiveCodes.find(effectiveCodeHash);
+		if (rejectedBucket != rejectedEffectiveCodes.end()) {
+			const std::vector<uint64_t> effectiveCode = newProg->getEffectiveCode();
+			if (std::find(rejectedBucket->second.begin(), rejectedBucket->second.end(), effectiveCode) != rejectedBucket->second.end()) {
+				allUnique = false;
+				continue;
+			}
+		}
+
 		// Check for uniqueness in archive
-		auto archivedDataHandlers = archive.getDataHandlers();
-		std::map<size_t, double> hashesAndResults;
-		Program::ProgramExecutionEngine pee(*newProg);
-		for (std::pair<size_t, std::vector<std::reference_wrapper<const Data::DataHandler>>> archiveDatahandler : archivedDataHandlers) {
+		hashesAndResults.clear();
+		for (const auto& archiveDatahandler : archivedDataHandlers) {
 			// Execute the mutated program on the archive data handlers
 			pee.setDataSources(archiveDatahandler.second);
 			double result = pee.executeProgram();
@@ -320,72 +336,44 @@ void Mutator::TPGMutator::mutateProgramBehaviorAgainstArchive(std::shared_ptr<Pr
 
 		// If the result is not unique, do another mutation.
 		allUnique = archive.areProgramResultsUnique(hashesAndResults);
+		if (!allUnique) {
+			rejectedEffectiveCodes[effectiveCodeHash].push_back(newProg->getEffectiveCode());
+		}
 	} while (!allUnique);
 }
 
 void Mutator::TPGMutator::mutateNewProgramBehaviors(const uint64_t& maxNbThreads, std::list<std::shared_ptr<Program::Program>>& newPrograms, Mutator::RNG& rng, const Mutator::MutationParameters& params, const Archive& archive)
+{
+	ThreadPool threadPool(maxNbThreads);
+	mutateNewProgramBehaviors(threadPool, newPrograms, rng, params, archive);
+}
+
+void Mutator::TPGMutator::mutateNewProgramBehaviors(ThreadPool& threadPool, std::list<std::shared_ptr<Program::Program>>& newPrograms, Mutator::RNG& rng, const Mutator::MutationParameters& params, const Archive& archive)
 {
 	// This is a computing intensive part of the mutation process
 	// Hence the parallelization.
-	if (maxNbThreads <= 1) {
-		// Sequential (kept for determinism check mostly)
-		for (std::shared_ptr<Program::Program> newProg : newPrograms) {
-			Mutator::RNG privateRNG(rng.getUnsignedInt64(0, UINT64_MAX));
-			mutateProgramBehaviorAgainstArchive(newProg, params, archive, privateRNG);
-		}
+	// Create job list with Program pointers and seed
+	// (seeds are drawn in order to keep the process deterministic)
+	std::vector<std::pair<std::shared_ptr<Program::Program>, uint64_t>> programsToMutate;
+	programsToMutate.reserve(newPrograms.size());
+	for (std::shared_ptr<Program::Program> newProg : newPrograms) {
+		programsToMutate.push_back({ newProg, rng.getUnsignedInt64(0, UINT64_MAX) });
 	}
-	else {
-		// Parallel
-		// Create job list with Program pointers and seed
-		std::queue<std::pair<std::shared_ptr<Program::Program>, uint64_t>> programsToMutate;
-		for (std::shared_ptr<Program::Program> newProg : newPrograms) {
-			programsToMutate.push({ newProg, rng.getUnsignedInt64(0, UINT64_MAX) });
-		}
-
-		std::mutex mutexMutation;
-
-		// Function executed in threads
-		auto parallelWorker = [&programsToMutate, &mutexMutation, &params, &archive]() {
-			Mutator::RNG privateRNG;
-			// While there is work to be done
-			bool jobDone;
-			do {
-				std::pair<std::shared_ptr<Program::Program>, uint64_t> job;
-				jobDone = false;
-				{	// get one job critical section
-					std::lock_guard lock(mutexMutation);
-					if (programsToMutate.size() != 0) {
-						jobDone = true;
-						job = programsToMutate.front();
-						programsToMutate.pop();
-					}
-				}
-
-				//  Do the job (if any)
-				if (jobDone) {
-					privateRNG.setSeed(job.second);
-					mutateProgramBehaviorAgainstArchive(job.first, params, archive, privateRNG);
-				}
-			} while (jobDone);
-		};
-
-		// Start threads
-		std::vector<std::thread> threads;
-		for (auto idx = 0; idx < maxNbThreads - 1; idx++) {
-			threads.emplace_back(std::thread(parallelWorker));
-		}
 
-		// Work in the main thread also
-		parallelWorker();
-
-		// Join the threads
-		for (auto& thread : threads) {
-			thread.join();
-		}
-	}
+	threadPool.parallelFor(programsToMutate.size(), [&programsToMutate, &params, &archive](uint64_t taskIdx, uint64_t) {
+		auto& job = programsToMutate.at(taskIdx);
+		Mutator::RNG privateRNG(job.second);
+		mutateProgramBehaviorAgainstArchive(job.first, params, archive, privateRNG);
+		});
 }
 
 void Mutator::TPGMutator::populateTPG(TPG::TPGGraph& graph, const Archive& archive, const Mutator::MutationParameters& params, Mutator::RNG& rng, uint64_t maxNbThreads)
+{
+	ThreadPool threadPool(maxNbThreads);
+	populateTPG(graph, archive, params, rng, threadPool);
+}
+
+void Mutator::TPGMutator::populateTPG(TPG::TPGGraph& graph, const Archive& archive, const Mutator::MutationParameters& params, Mutator::RNG& rng, ThreadPool& threadPool)
 {
 	// Get current vertex set (copy)
 	auto vertices(graph.getVertices());
@@ -453,5 +441,5 @@ void Mutator::TPGMutator::populateTPG(TPG::TPGGraph& graph, const Archive& archi
 	}
 
 	// Mutate the new Programs
-	mutateNewProgramBehaviors(maxNbThreads, newPrograms, rng, params, archive);
+	mutateNewProgramBehaviors(threadPool, newPrograms, rng, params, archive);
 }
@@ -0,0 +1,110 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2020) :
+ *
+ * Karol Desnos <kdesnos@insa-rennes.fr> (2020)
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+#include <stdexcept>
+#include <string>
+
+#include "data/dataHandler.h"
+#include "program/program.h"
+#include "program/compiledProgram.h"
+
+Program::CompiledProgram::CompiledProgram(const Program& prog)
+{
+	const Environment& env = prog.getEnvironment();
+
+	// Introns are not lowered.
+	for (uint64_t lineIdx : prog.getEffectiveLineIndexes()) {
+		const ::Program::Line& line = prog.getLine(lineIdx);
+		Line compiledLine{ nullptr, nullptr, line.getDestinationIndex(), this->operands.size(), 0, this->parameters.size(), 0, nullptr };
+
+		try {
+			// throw std::out_of_range if the index of the line is too large.
+			const Instructions::Instruction& instruction = env.getInstructionSet().getInstruction(line.getInstructionIndex());
+
+			// Can the kernel of the instruction be used for all operands?
+			bool directAccess = true;
+
+			for (uint64_t i = 0; i < instruction.getNbOperands(); i++) {
+				const std::pair<uint64_t, uint64_t>& operandIndexes = line.getOperand(i);
+				const std::type_info& operandType = instruction.getOperandTypes().at(i).get();
+
+				// Registers are at index 0, other data sources follow.
+				const Data::DataHandler& dataSource = (operandIndexes.first == 0) ?
+					env.getFakeRegisters() : env.getDataSources().at(operandIndexes.first - 1).get(); // Throws std::out_of_range
+
+				if (dataSource.getAddressSpace(operandType) == 0) {
+					throw std::invalid_argument("Data type " + std::string(operandType.name()) + " cannot be accessed in the data source " + std::to_string(operandIndexes.first) + ".");
+				}
+
+				const uint64_t operandLocation = dataSource.scaleLocation(operandIndexes.second, operandType);
+				this->operands.push_back({ operandIndexes.first, operandLocation, &operandType });
+				directAccess &= (dataSource.getDataPointerAt(operandType, operandLocation) != nullptr);
+			}
+
+			for (uint64_t i = 0; i < instruction.getNbParameters(); i++) {
+				this->parameters.push_back(line.getParameter(i)); // throw std::out_of_range
+			}
+
+			compiledLine.instruction = &instruction;
+			compiledLine.kernel = (directAccess) ? instruction.getKernel() : nullptr;
+			compiledLine.nbOperands = instruction.getNbOperands();
+			compiledLine.nbParameters = instruction.getNbParameters();
+		}
+		catch (...) {
+			// Discard what was lowered for this line and keep the exception
+			// for the execution.
+			this->operands.resize(compiledLine.operandsOffset);
+			this->parameters.erase(this->parameters.begin() + compiledLine.parametersOffset, this->parameters.end());
+			compiledLine.fault = std::current_exception();
+		}
+
+		this->lines.push_back(compiledLine);
+	}
+}
+
+const std::vector<Program::CompiledProgram::Line>& Program::CompiledProgram::getLines() const
+{
+	return this->lines;
+}
+
+const Program::CompiledProgram::Operand* Program::CompiledProgram::getOperands(const Line& line) const
+{
+	return this->operands.data() + line.operandsOffset;
+}
+
+const Parameter* Program::CompiledProgram::getParameters(const Line& line) const
+{
+	return this->parameters.data() + line.parametersOffset;
+}
@@ -0,0 +1,204 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2020) :
+ *
+ * Karol Desnos <kdesnos@insa-rennes.fr> (2020)
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+#include <stdexcept>
+
+#include "program/packedLines.h"
+
+uint64_t Program::PackedLines::getNbBitsFor(uint64_t nbValues)
+{
+	uint64_t nbBits = 0;
+	while (nbBits < 64 && (uint64_t(1) << nbBits) < nbValues) {
+		nbBits++;
+	}
+	return nbBits;
+}
+
+Program::PackedLines::PackedLines(const Environment& env) :
+	environment{ env },
+	nbInstructionBits{ getNbBitsFor(env.getNbInstructions()) },
+	nbDestinationBits{ getNbBitsFor(env.getNbRegisters()) },
+	nbDataSourceBits{ env.getLineSize().nbOperandDataSourceIndexBits },
+	nbLocationBits{ env.getLineSize().nbOperandLocationBits },
+	nbLineBits{ env.getLineSize().totalNbBits },
+	nbLines{ 0 }
+{
+	// The LineSize only gives the sum of the instructionIndex and
+	// destinationIndex widths reliably, hence their recomputation.
+	if (this->nbInstructionBits + this->nbDestinationBits != env.getLineSize().nbInstructionBits + env.getLineSize().nbDestinationBits) {
+		throw std::logic_error("Line fields widths are inconsistent with the LineSize of the Environment.");
+	}
+}
+
+Program::PackedLines::PackedLines(const Program& program) : PackedLines(program.getEnvironment())
+{
+	const uint64_t nbOperands = this->environment.getMaxNbOperands();
+	const uint64_t nbParameters = this->environment.getMaxNbParameters();
+
+	// New words are zero-initialized
+	this->nbLines = program.getNbLines();
+	this->words.resize((this->nbLines * this->nbLineBits + 63) / 64, 0);
+
+	bool success = true;
+	for (uint64_t lineIdx = 0; lineIdx < this->nbLines; lineIdx++) {
+		const Line& line = program.getLine(lineIdx);
+		uint64_t offset = lineIdx * this->nbLineBits;
+		success &= this->writeBits(offset, this->nbInstructionBits, line.getInstructionIndex());
+		offset += this->nbInstructionBits;
+		success &= this->writeBits(offset, this->nbDestinationBits, line.getDestinationIndex());
+		offset += this->nbDestinationBits;
+		for (uint64_t i = 0; i < nbOperands; i++) {
+			const std::pair<uint64_t, uint64_t>& operand = line.getOperand(i);
+			success &= this->writeBits(offset, this->nbDataSourceBits, operand.first);
+			offset += this->nbDataSourceBits;
+			success &= this->writeBits(offset, this->nbLocationBits, operand.second);
+			offset += this->nbLocationBits;
+		}
+		for (uint64_t i = 0; i < nbParameters; i++) {
+			this->writeBits(offset, sizeof(Parameter) * 8, (uint16_t)line.getParameter(i).i);
+			offset += sizeof(Parameter) * 8;
+		}
+	}
+
+	if (!success) {
+		throw std::out_of_range("Line value can not be encoded with the LineSize of the Environment.");
+	}
+}
+
+Program::PackedLines::PackedLines(const Environment& env, uint64_t nbLines, const uint64_t* buffer, uint64_t nbWords) : PackedLines(env)
+{
+	// The first test prevents overflows when computing the number of bits.
+	if ((this->nbLineBits != 0 && nbLines > nbWords * 64 / this->nbLineBits)
+		|| nbWords != (this->nbLineBits * nbLines + 63) / 64) {
+		throw std::invalid_argument("Number of words is inconsistent with the number of lines.");
+	}
+
+	this->nbLines = nbLines;
+	this->words.assign(buffer, buffer + nbWords);
+	// Clear padding bits
+	const uint64_t nbUsedBits = (this->nbLineBits * nbLines) % 64;
+	if (nbUsedBits != 0) {
+		this->words.back() &= (uint64_t(1) << nbUsedBits) - 1;
+	}
+}
+
+uint64_t Program::PackedLines::readBits(uint64_t bitOffset, uint64_t nbBits) const
+{
+	if (nbBits == 0) {
+		return 0;
+	}
+
+	const uint64_t wordIdx = bitOffset / 64;
+	const uint64_t shift = bitOffset % 64;
+	uint64_t value = this->words[wordIdx] >> shift;
+	if (shift + nbBits > 64) {
+		value |= this->words[wordIdx + 1] << (64 - shift);
+	}
+
+	return (nbBits < 64) ? value & ((uint64_t(1) << nbBits) - 1) : value;
+}
+
+bool Program::PackedLines::writeBits(uint64_t bitOffset, uint64_t nbBits, uint64_t value)
+{
+	const uint64_t mask = (nbBits < 64) ? (uint64_t(1) << nbBits) - 1 : ~uint64_t(0);
+	if ((value & ~mask) != 0) {
+		return false;
+	}
+	if (nbBits == 0) {
+		return true;
+	}
+
+	const uint64_t wordIdx = bitOffset / 64;
+	const uint64_t shift = bitOffset % 64;
+	this->words[wordIdx] = (this->words[wordIdx] & ~(mask << shift)) | (value << shift);
+	if (shift + nbBits > 64) {
+		const uint64_t highMask = mask >> (64 - shift);
+		this->words[wordIdx + 1] = (this->words[wordIdx + 1] & ~highMask) | (value >> (64 - shift));
+	}
+
+	return true;
+}
+
+const Environment& Program::PackedLines::getEnvironment() const
+{
+	return this->environment;
+}
+
+uint64_t Program::PackedLines::getNbLines() const
+{
+	return this->nbLines;
+}
+
+uint64_t Program::PackedLines::getNbWords() const
+{
+	return this->words.size();
+}
+
+const uint64_t* Program::PackedLines::getWords() const
+{
+	return this->words.data();
+}
+
+bool Program::PackedLines::unpack(Program& program, const bool check) const
+{
+	if (&program.getEnvironment() != &this->environment) {
+		throw std::runtime_error("Environment of the Program differs from the one of the PackedLines.");
+	}
+
+	const uint64_t nbOperands = this->environment.getMaxNbOperands();
+	const uint64_t nbParameters = this->environment.getMaxNbParameters();
+
+	bool valid = true;
+	for (uint64_t lineIdx = 0; lineIdx < this->nbLines; lineIdx++) {
+		Line& line = program.addNewLine();
+		uint64_t offset = lineIdx * this->nbLineBits;
+		valid &= line.setInstructionIndex(this->readBits(offset, this->nbInstructionBits), check);
+		offset += this->nbInstructionBits;
+		valid &= line.setDestinationIndex(this->readBits(offset, this->nbDestinationBits), check);
+		offset += this->nbDestinationBits;
+		for (uint64_t i = 0; i < nbOperands; i++) {
+			const uint64_t dataIndex = this->readBits(offset, this->nbDataSourceBits);
+			offset += this->nbDataSourceBits;
+			valid &= line.setOperand(i, dataIndex, this->readBits(offset, this->nbLocationBits), check);
+			offset += this->nbLocationBits;
+		}
+		for (uint64_t i = 0; i < nbParameters; i++) {
+			line.setParameter(i, (int16_t)this->readBits(offset, sizeof(Parameter) * 8));
+			offset += sizeof(Parameter) * 8;
+		}
+	}
+
+	return valid;
+}
@@ -37,22 +37,51 @@
 #include <stdexcept>
 #include <new>
 #include <algorithm>
-#include <set>
 #include <typeinfo>
 
+#include "data/hash.h"
 #include "data/primitiveTypeArray.h"
 
 #include "parameter.h"
 #include "program/program.h"
 
 Program::Program::~Program() {
-	while (!lines.empty()) {
-		Line* line = lines.back().first;
-		delete line;
-		lines.pop_back();
+	// Memory of lines is freed in bulk with the lineBlocks.
+	for (Line* line : this->lines) {
+		line->~Line();
 	}
 }
 
+size_t Program::Program::getLineSlotSize(const Environment& env)
+{
+	const size_t alignment = std::max(alignof(Line), alignof(std::pair<uint64_t, uint64_t>));
+	const size_t size = LINE_DATA_OFFSET + Line::getDataSize(env);
+	return ((size + alignment - 1) / alignment) * alignment;
+}
+
+char* Program::Program::allocateLineSlot(uint64_t nbSlots)
+{
+	if (!this->freeLineSlots.empty()) {
+		char* slot = this->freeLineSlots.back();
+		this->freeLineSlots.pop_back();
+		return slot;
+	}
+
+	if (this->lastLineBlockSize == this->lastLineBlockCapacity) {
+		this->lastLineBlockCapacity = std::max(nbSlots, MIN_NB_LINE_SLOTS_PER_BLOCK);
+		this->lastLineBlockSize = 0;
+		this->lineBlocks.emplace_back(new char[this->lastLineBlockCapacity * this->lineSlotSize]);
+	}
+
+	return this->lineBlocks.back().get() + (this->lastLineBlockSize++) * this->lineSlotSize;
+}
+
+void Program::Program::destroyLine(Line* line)
+{
+	line->~Line();
+	this->freeLineSlots.push_back((char*)line);
+}
+
 Program::Line& Program::Program::addNewLine() {
 	return this->addNewLine(this->getNbLines());
 }
@@ -62,18 +91,49 @@ Program::Line& Program::Program::addNewLine(const uint64_t idx)
 	if (idx > this->getNbLines()) {
 		throw std::out_of_range("Attempting to insert a line beyond the program end.");
 	}
-	// Allocate the zero-filled memory 
-	Line* newLine = new Line(this->environment);
+	this->invalidateCompiledProgram();
+
+	// Construct the zero-filled line in place. The number of lines of the
+	// Program is given as the minimum size of a new block, to allocate
+	// blocks geometrically.
+	char* slot = this->allocateLineSlot(this->getNbLines());
+	Line* newLine = new (slot) Line(this->environment, slot + LINE_DATA_OFFSET);
+	this->lines.insert(lines.begin() + idx, newLine);
 	// new line is not marked as an intron by default
-	this->lines.insert(lines.begin() + idx, { newLine, false });
+	this->introns.insert(introns.begin() + idx, false);
+	this->updateEffectiveLineIndexes();
+
+	// Dirty lines following the new one are shifted.
+	if (this->dirtyLinesBegin < this->dirtyLinesEnd && this->dirtyLinesEnd > idx) {
+		this->dirtyLinesEnd++;
+	}
+	this->usefulRegisters.insert(this->usefulRegisters.begin() + idx * this->nbRegisterWords, this->nbRegisterWords, 0);
+	this->modifiedLines.insert(this->modifiedLines.begin() + idx, true);
+	this->markModifiedLine(idx);
 
 	return *newLine;
 }
 
 void Program::Program::removeLine(const uint64_t idx)
 {
-	delete this->lines.at(idx).first; // throws std::out_of_range on bad index.
+	this->destroyLine(this->lines.at(idx)); // throws std::out_of_range on bad index.
+	this->invalidateCompiledProgram();
+	if (this->intronsIdentified && !this->modifiedLines[idx] && !this->introns[idx]) {
+		this->effectiveLinesModified = true;
+	}
 	this->lines.erase(this->lines.begin() + idx);
+	this->introns.erase(this->introns.begin() + idx);
+	this->updateEffectiveLineIndexes();
+
+	this->modifiedLines.erase(this->modifiedLines.begin() + idx);
+	this->usefulRegisters.erase(this->usefulRegisters.begin() + idx * this->nbRegisterWords,
+		this->usefulRegisters.begin() + (idx + 1) * this->nbRegisterWords);
+	// Dirty lines following the removed one are shifted, and the liveness of
+	// lines preceding it may change.
+	if (this->dirtyLinesBegin < this->dirtyLinesEnd && this->dirtyLinesEnd > idx + 1) {
+		this->dirtyLinesEnd--;
+	}
+	this->markDirtyLine(idx);
 }
 
 void Program::Program::swapLines(const uint64_t idx0, const uint64_t idx1)
@@ -83,6 +143,14 @@ void Program::Program::swapLines(const uint64_t idx0, const uint64_t idx1)
 	}
 
 	std::iter_swap(this->lines.begin() + idx0, this->lines.begin() + idx1);
+	if (this->introns[idx0] != this->introns[idx1]) {
+		std::vector<bool>::swap(this->introns[idx0], this->introns[idx1]);
+		this->updateEffectiveLineIndexes();
+	}
+	std::vector<bool>::swap(this->modifiedLines[idx0], this->modifiedLines[idx1]);
+	this->markModifiedLine(idx0);
+	this->markModifiedLine(idx1);
+	this->invalidateCompiledProgram();
 }
 
 const Environment& Program::Program::getEnvironment() const {
@@ -96,73 +164,246 @@ size_t Program::Program::getNbLines() const
 
 const Program::Line& Program::Program::getLine(uint64_t index) const
 {
-	return *this->lines.at(index).first; // throws std::out_of_range on bad index.
+	return *this->lines.at(index); // throws std::out_of_range on bad index.
 }
 
 Program::Line& Program::Program::getLine(uint64_t index)
 {
-	return *this->lines.at(index).first; // throws std::out_of_range on bad index.
+	Line& line = *this->lines.at(index); // throws std::out_of_range on bad index.
+	this->invalidateCompiledProgram();
+	this->markModifiedLine(index);
+	return line;
 }
 
 bool Program::Program::isIntron(uint64_t index) const
 {
-	return this->lines.at(index).second; // throws std::out_of_range on bad index.
+	return this->introns.at(index); // throws std::out_of_range on bad index.
+}
+
+const std::vector<uint64_t>& Program::Program::getEffectiveLineIndexes() const
+{
+	return this->effectiveLineIndexes;
+}
+
+void Program::Program::updateEffectiveLineIndexes()
+{
+	this->effectiveLineIndexes.clear();
+	for (uint64_t idx = 0; idx < this->introns.size(); idx++) {
+		if (!this->introns[idx]) {
+			this->effectiveLineIndexes.push_back(idx);
+		}
+	}
+}
+
+void Program::Program::markDirtyLine(uint64_t idx)
+{
+	if (this->dirtyLinesBegin >= this->dirtyLinesEnd) {
+		this->dirtyLinesBegin = idx;
+		this->dirtyLinesEnd = idx + 1;
+	}
+	else {
+		this->dirtyLinesBegin = std::min(this->dirtyLinesBegin, idx);
+		this->dirtyLinesEnd = std::max(this->dirtyLinesEnd, idx + 1);
+	}
+}
+
+void Program::Program::markModifiedLine(uint64_t idx)
+{
+	// Modifying a non-intron line modifies the effective code.
+	if (this->intronsIdentified && !this->modifiedLines[idx] && !this->introns[idx]) {
+		this->effectiveLinesModified = true;
+	}
+	this->modifiedLines[idx] = true;
+	this->markDirtyLine(idx);
+}
+
+void Program::Program::clearModifications()
+{
+	this->modifiedLines.assign(this->lines.size(), false);
+	this->dirtyLinesBegin = 0;
+	this->dirtyLinesEnd = 0;
+	this->effectiveLinesModified = false;
+}
+
+bool Program::Program::processLineLiveness(const Line& line, uint64_t* useful) const
+{
+	// Check if the line output is within useful registers
+	const uint64_t destinationIndex = line.getDestinationIndex();
+	if (destinationIndex >= this->environment.getNbRegisters() || ((useful[destinationIndex / 64] >> (destinationIndex % 64)) & 1) == 0) {
+		// The line does not contribute to the result of the Program.
+		return false;
+	}
+
+	// Remove the destination register from the useful registers
+	useful[destinationIndex / 64] &= ~(uint64_t(1) << (destinationIndex % 64));
+
+	// Add register operands to the useful registers
+	const uint64_t instructionIndex = line.getInstructionIndex();
+	const Instructions::Instruction& instruction = this->environment.getInstructionSet().getInstruction(instructionIndex);
+	for (uint64_t idxOperand = 0; idxOperand < instruction.getNbOperands(); idxOperand++) {
+		// Is the operand a register (i.e. its index is 0)
+		const std::pair<uint64_t, uint64_t>& operand = line.getOperand(idxOperand);
+		if (operand.first == 0) {
+			const std::pair<size_t, size_t>& access = this->environment.getRegistersAccess(instructionIndex, idxOperand);
+			if (access.first > 0) {
+				const uint64_t firstRegister = operand.second % access.first;
+				for (uint64_t registerIdx = firstRegister; registerIdx < firstRegister + access.second; registerIdx++) {
+					useful[registerIdx / 64] |= uint64_t(1) << (registerIdx % 64);
+				}
+			}
+		}
+	}
+
+	return true;
 }
 
 uint64_t Program::Program::identifyIntrons()
 {
-	// Create fake registers to identify accessed addresses.
-	const Data::DataHandler& fakeRegisters = this->environment.getFakeRegisters();
+	// Intron flags are about to change.
+	this->invalidateCompiledProgram();
+
 	// Number of introns within the Program.
 	uint64_t nbIntrons = 0;
-	// Set of useful register
-	std::set<uint64_t> usefulRegisters;
-	// Start with only register 0
-	usefulRegisters.insert(0);
+	// Set of useful registers, starting with only register 0
+	std::vector<uint64_t> useful(this->nbRegisterWords, 0);
+	useful[0] = 1;
 
 	// Scan program lines backward
-	auto backIter = this->lines.rbegin();
-	while (backIter != this->lines.rend()) {
-		// Check if the currentLine output is within usefulRegisters
-		Line* currentLine = backIter->first;
-		uint64_t destinationIndex = currentLine->getDestinationIndex();
-		auto destinationRegister = usefulRegisters.find(destinationIndex);
-		if (destinationRegister != usefulRegisters.end()) {
-			// The Line is useful (i.e. not an introns)
-			backIter->second = false;
-
-			// Remove the destination register from the list of useful operands
-			usefulRegisters.erase(*destinationRegister);
-
-			// Add register operands to the list of useful registers
-			const Instructions::Instruction& instruction = this->environment.getInstructionSet().getInstruction(currentLine->getInstructionIndex());
-			size_t nbOperands = instruction.getNbOperands();
-			for (auto idxOperand = 0; idxOperand < nbOperands; idxOperand++) {
-				// Is the operand a register (i.e. its index is 0)
-				if (currentLine->getOperand(idxOperand).first == 0) {
-					// The operand is a register, add the accessed register to
-					// the list of useful registers.
-					const std::type_info& operandType = instruction.getOperandTypes().at(idxOperand);
-					uint64_t location = currentLine->getOperand(idxOperand).second;
-					uint64_t registerIdx = location % fakeRegisters.getAddressSpace(operandType);
-					std::vector<size_t> accessedAddresses = fakeRegisters.getAddressesAccessed(operandType, registerIdx);
-					for (size_t accessedAddress : accessedAddresses) {
-						usefulRegisters.insert(accessedAddress);
-					}
-				}
-			}
+	this->usefulRegisters.resize(this->lines.size() * this->nbRegisterWords);
+	for (uint64_t lineIdx = this->lines.size(); lineIdx > 0; lineIdx--) {
+		std::copy(useful.begin(), useful.end(), this->usefulRegisters.begin() + (lineIdx - 1) * this->nbRegisterWords);
+		const bool isUseful = this->processLineLiveness(*this->lines[lineIdx - 1], useful.data());
+		this->introns[lineIdx - 1] = !isUseful;
+		nbIntrons += (isUseful) ? 0 : 1;
+	}
+
+	this->intronsIdentified = true;
+	this->clearModifications();
+	this->updateEffectiveLineIndexes();
+	this->updateEffectiveCodeHash();
+
+	return nbIntrons;
+}
+
+bool Program::Program::updateIntrons()
+{
+	if (!this->intronsIdentified) {
+		this->identifyIntrons();
+		return true;
+	}
+
+	// Nothing to update: keep the compiled program.
+	if (this->dirtyLinesBegin >= this->dirtyLinesEnd && !this->effectiveLinesModified) {
+		return false;
+	}
+
+	// Intron flags are about to change.
+	this->invalidateCompiledProgram();
+
+	bool effectiveCodeChanged = this->effectiveLinesModified;
+	const uint64_t nbLines = this->lines.size();
+	if (this->dirtyLinesBegin < this->dirtyLinesEnd && nbLines > 0) {
+		// Registers useful after the last dirty line are computed from the
+		// first clean line following it, if any.
+		const uint64_t lastDirtyLine = std::min<uint64_t>(this->dirtyLinesEnd, nbLines) - 1;
+		std::vector<uint64_t> useful(this->nbRegisterWords, 0);
+		if (lastDirtyLine + 1 < nbLines) {
+			std::copy_n(this->usefulRegisters.begin() + (lastDirtyLine + 1) * this->nbRegisterWords, this->nbRegisterWords, useful.begin());
+			this->processLineLiveness(*this->lines[lastDirtyLine + 1], useful.data());
 		}
 		else {
-			// The destination of the line is not within useful registers
-			// the line does not contribute to the result of the Program
-			// it is an intron.
-			backIter->second = true;
-			nbIntrons++;
+			useful[0] = 1;
+		}
+
+		// Scan program lines backward, until the liveness of a clean line
+		// is unchanged.
+		for (uint64_t lineIdx = lastDirtyLine + 1; lineIdx > 0; lineIdx--) {
+			auto storedUseful = this->usefulRegisters.begin() + (lineIdx - 1) * this->nbRegisterWords;
+			if (lineIdx - 1 < this->dirtyLinesBegin && std::equal(useful.begin(), useful.end(), storedUseful)) {
+				break;
+			}
+			std::copy(useful.begin(), useful.end(), storedUseful);
+
+			const bool wasIntron = this->introns[lineIdx - 1];
+			const bool isUseful = this->processLineLiveness(*this->lines[lineIdx - 1], useful.data());
+			this->introns[lineIdx - 1] = !isUseful;
+			if (this->modifiedLines[lineIdx - 1]) {
+				// Modified lines that were not introns were already
+				// accounted for.
+				effectiveCodeChanged |= isUseful;
+			}
+			else {
+				effectiveCodeChanged |= (isUseful == wasIntron);
+			}
 		}
+	}
 
-		backIter++;
+	this->clearModifications();
+	this->updateEffectiveLineIndexes();
+	if (effectiveCodeChanged) {
+		this->updateEffectiveCodeHash();
 	}
 
-	return nbIntrons;
+	return effectiveCodeChanged;
 }
 
+template <class Visitor> void Program::Program::browseEffectiveCode(Visitor visitor) const
+{
+	const Instructions::Set& instructionSet = this->environment.getInstructionSet();
+	for (uint64_t lineIdx : this->effectiveLineIndexes) {
+		const Line& currentLine = *this->lines[lineIdx];
+		const Instructions::Instruction& instruction = instructionSet.getInstruction(currentLine.getInstructionIndex());
+		visitor(currentLine.getInstructionIndex());
+		visitor(currentLine.getDestinationIndex());
+		for (uint64_t idxOperand = 0; idxOperand < instruction.getNbOperands(); idxOperand++) {
+			visitor(currentLine.getOperand(idxOperand).first);
+			visitor(currentLine.getOperand(idxOperand).second);
+		}
+		for (uint64_t idxParam = 0; idxParam < instruction.getNbParameters(); idxParam++) {
+			visitor((uint16_t)(int16_t)currentLine.getParameter(idxParam));
+		}
+	}
+}
+
+std::vector<uint64_t> Program::Program::getEffectiveCode() const
+{
+	std::vector<uint64_t> effectiveCode;
+	this->browseEffectiveCode([&effectiveCode](uint64_t value) { effectiveCode.push_back(value); });
+
+	return effectiveCode;
+}
+
+void Program::Program::updateEffectiveCodeHash()
+{
+	Data::Hash<uint64_t> hasher;
+	uint64_t hash = hasher(0);
+	// Chaining the hasher keeps the hash sensitive to the order of values.
+	this->browseEffectiveCode([&hash, &hasher](uint64_t value) { hash = hasher(hash ^ hasher(value)); });
+	this->effectiveCodeHash = hash;
+}
+
+uint64_t Program::Program::getEffectiveCodeHash() const
+{
+	return this->effectiveCodeHash;
+}
+
+std::shared_ptr<const Program::CompiledProgram> Program::Program::getCompiledProgram() const
+{
+	std::lock_guard<std::mutex> lock(this->compiledProgramMutex);
+	if (this->compiledProgram == nullptr) {
+		this->compiledProgram = std::make_shared<const CompiledProgram>(*this);
+	}
+	return this->compiledProgram;
+}
+
+std::shared_ptr<const Program::CompiledProgram> Program::Program::getCompiledProgramIfAny() const
+{
+	std::lock_guard<std::mutex> lock(this->compiledProgramMutex);
+	return this->compiledProgram;
+}
+
+void Program::Program::invalidateCompiledProgram()
+{
+	std::lock_guard<std::mutex> lock(this->compiledProgramMutex);
+	this->compiledProgram = nullptr;
+}
@@ -34,29 +34,35 @@
  * knowledge of the CeCILL-C license and that you accept its terms.
  */
 
+#include <algorithm>
+
 #include "program/line.h"
 #include "program/programExecutionEngine.h"
 
 void Program::ProgramExecutionEngine::setProgram(const Program& prog) {
 	// Check dataSource are similar in all point to the program environment
-	// '-1' on this->dataSources is to ignore registers
-	if (this->dataSourcesAndRegisters.size() - 1 != prog.getEnvironment().getDataSources().size()) {
-		throw std::runtime_error("Data sources characteristics for Program Execution differ from Program reference Environment.");
-	}
-	for (size_t i = 0; i < this->dataSourcesAndRegisters.size() - 1; i++) {
-		// check data source characteristics
-		auto& iDataSrc = this->dataSourcesAndRegisters.at(i + (size_t)1).get();
-		auto& envDataSrc = prog.getEnvironment().getDataSources().at(i).get();
-		// Assume that dataSource must be (at least) a copy of each other to simplify the comparison
-		// This is characterise by the two data sources having the same id
-		if (iDataSrc.getId() != envDataSrc.getId()) {
+	// (unless this environment was already checked)
+	if (&prog.getEnvironment() != this->checkedEnvironment) {
+		// '-1' on this->dataSources is to ignore registers
+		if (this->dataSourcesAndRegisters.size() - 1 != prog.getEnvironment().getDataSources().size()) {
 			throw std::runtime_error("Data sources characteristics for Program Execution differ from Program reference Environment.");
-			// If this pose a problem one day, an additional more 
-			// complex check could be used as a last resort when ids 
-			// of DataHandlers are different: checking equality of the 
-			// lists of provided data types and the equality address 
-			// space size for each data type.
 		}
+		for (size_t i = 0; i < this->dataSourcesAndRegisters.size() - 1; i++) {
+			// check data source characteristics
+			auto& iDataSrc = this->dataSourcesAndRegisters.at(i + (size_t)1).get();
+			auto& envDataSrc = prog.getEnvironment().getDataSources().at(i).get();
+			// Assume that dataSource must be (at least) a copy of each other to simplify the comparison
+			// This is characterise by the two data sources having the same id
+			if (iDataSrc.getId() != envDataSrc.getId()) {
+				throw std::runtime_error("Data sources characteristics for Program Execution differ from Program reference Environment.");
+				// If this pose a problem one day, an additional more 
+				// complex check could be used as a last resort when ids 
+				// of DataHandlers are different: checking equality of the 
+				// lists of provided data types and the equality address 
+				// space size for each data type.
+			}
+		}
+		this->checkedEnvironment = &prog.getEnvironment();
 	}
 
 	// Set the program
@@ -69,6 +75,13 @@ void Program::ProgramExecutionEngine::setProgram(const Program& prog) {
 	this->programCounter = 0;
 }
 
+void Program::ProgramExecutionEngine::bindDataSources(const std::vector<std::reference_wrapper<const Data::DataHandler>>& dataSrc)
+{
+	for (size_t idx = 0; idx < dataSrc.size(); idx++) {
+		this->dataSourcesAndRegisters[idx + 1] = dataSrc[idx];
+	}
+}
+
 const std::vector<std::reference_wrapper<const Data::DataHandler>>& Program::ProgramExecutionEngine::getDataSources() const
 {
 	return this->dataSources;
@@ -76,11 +89,10 @@ const std::vector<std::reference_wrapper<const Data::DataHandler>>& Program::Pro
 
 const bool Program::ProgramExecutionEngine::next()
 {
-	// While the next line is an intron
-	// increment the program counter.
-	do {
-		this->programCounter++;
-	} while (this->programCounter < this->program->getNbLines() && this->program->isIntron(this->programCounter));
+	// Jump to the first non-intron line following the program counter.
+	const std::vector<uint64_t>& effectiveLines = this->program->getEffectiveLineIndexes();
+	auto nextLine = std::upper_bound(effectiveLines.begin(), effectiveLines.end(), this->programCounter);
+	this->programCounter = (nextLine != effectiveLines.end()) ? *nextLine : this->program->getNbLines();
 	return this->programCounter < this->program->getNbLines();
 }
 
@@ -141,36 +153,93 @@ void Program::ProgramExecutionEngine::executeCurrentLine()
 
 double Program::ProgramExecutionEngine::executeProgram(const bool ignoreException)
 {
-	// Reset registers and programCounter
-	this->registers.resetData();
-	this->programCounter = 0;
+	// Get the lowered program (built on first execution)
+	const std::shared_ptr<const CompiledProgram> compiledProgram = this->program->getCompiledProgram();
 
-	// Iterate over the lines of the Program
-	bool hasNext = this->program->getNbLines() > 0;
+	double result = this->executeCompiledProgram(*compiledProgram, ignoreException);
 
-	// Skip first lines if they are introns.
-	if (hasNext && this->program->isIntron(0)) {
-		hasNext = this->next();
-	}
+	// Leave the programCounter at the end of the Program.
+	this->programCounter = this->program->getNbLines();
 
-	// Execute useful lines
-	while (hasNext) {
+	return result;
+}
+
+double Program::ProgramExecutionEngine::executeCompiledProgram(const CompiledProgram& compiledProgram, const bool ignoreException)
+{
+	// Reset registers
+	this->registers.resetData();
 
+	// Execute useful lines
+	for (const CompiledProgram::Line& line : compiledProgram.getLines()) {
 		try {
-			// Execute the current line
-			this->executeCurrentLine();
+			// Rethrow exception caught when lowering the line, if any.
+			if (line.fault) {
+				std::rethrow_exception(line.fault);
+			}
+
+			double result;
+			const CompiledProgram::Operand* lineOperands = compiledProgram.getOperands(line);
+			if (line.kernel != nullptr) {
+				// Fetch raw pointers to operands, whose types were checked
+				// when lowering the program.
+				this->operandPointers.clear();
+				for (size_t i = 0; i < line.nbOperands; i++) {
+					const CompiledProgram::Operand& operand = lineOperands[i];
+					const Data::DataHandler& dataSource = this->dataSourcesAndRegisters[operand.dataSourceIndex];
+					this->operandPointers.push_back(dataSource.getDataPointerAt(*operand.type, operand.location));
+				}
+
+				result = line.kernel(*line.instruction, this->operandPointers.data(), compiledProgram.getParameters(line));
+			}
+			else {
+				// Fetch operands
+				this->operands.clear();
+				for (size_t i = 0; i < line.nbOperands; i++) {
+					const CompiledProgram::Operand& operand = lineOperands[i];
+					const Data::DataHandler& dataSource = this->dataSourcesAndRegisters[operand.dataSourceIndex];
+					this->operands.push_back(dataSource.getDataAt(*operand.type, operand.location));
+				}
+
+				// Fetch parameters
+				this->parameters.clear();
+				const Parameter* lineParameters = compiledProgram.getParameters(line);
+				for (size_t i = 0; i < line.nbParameters; i++) {
+					this->parameters.push_back(lineParameters[i]);
+				}
+
+				result = line.instruction->execute(this->parameters, this->operands);
+			}
+
+			this->registers.setDataAt(typeid(double), line.destinationIndex, result);
 		}
-		catch (std::out_of_range e) {
+		catch (std::out_of_range&) {
 			if (!ignoreException) {
 				throw; // rethrow
 			}
 		}
-
-		// Increment the programCounter.
-		hasNext = this->next();
-	};
+	}
 
 	// Returns the 0-indexed register. 
 	// cast to primitiveType<double> to enable cast to double.
 	return *(this->registers.getDataAt(typeid(double), 0).getSharedPointer<const double>());
 }
+
+void Program::ProgramExecutionEngine::executeCompiledProgramBatch(const CompiledProgram& compiledProgram, const std::vector<const std::vector<std::reference_wrapper<const Data::DataHandler>>*>& dataSourcesBatch,
+	std::vector<double>& results, const bool ignoreException)
+{
+	results.clear();
+	results.reserve(dataSourcesBatch.size());
+
+	try {
+		for (const std::vector<std::reference_wrapper<const Data::DataHandler>>* dataSrc : dataSourcesBatch) {
+			this->bindDataSources(*dataSrc);
+			results.push_back(this->executeCompiledProgram(compiledProgram, ignoreException));
+		}
+	}
+	catch (...) {
+		this->bindDataSources(this->dataSources);
+		throw;
+	}
+
+	this->bindDataSources(this->dataSources);
+}
@@ -0,0 +1,194 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2020) :
+ *
+ * Karol Desnos <kdesnos@insa-rennes.fr> (2020)
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+#include <stdexcept>
+
+#include "threadPool.h"
+
+ThreadPool::ThreadPool(uint64_t nbThreads) : nbThreads{ (nbThreads > 1) ? nbThreads : 1 }, deques(this->nbThreads)
+{
+	for (uint64_t idx = 1; idx < this->nbThreads; idx++) {
+		this->workers.emplace_back(&ThreadPool::workerLoop, this, idx);
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		this->stop = true;
+	}
+	this->jobStarted.notify_all();
+
+	for (auto& worker : this->workers) {
+		worker.join();
+	}
+}
+
+uint64_t ThreadPool::getNbThreads() const
+{
+	return this->nbThreads;
+}
+
+void ThreadPool::parallelFor(uint64_t nbTasks, const Task& task)
+{
+	if (nbTasks > UINT32_MAX) {
+		throw std::length_error("Number of tasks of a parallelFor must fit on 32 bits.");
+	}
+
+	if (nbTasks == 0) {
+		return;
+	}
+
+	std::lock_guard<std::mutex> callLock(this->parallelForMutex);
+
+	// Split tasks in contiguous blocks, one per thread.
+	for (uint64_t threadIdx = 0; threadIdx < this->nbThreads; threadIdx++) {
+		uint64_t begin = nbTasks * threadIdx / this->nbThreads;
+		uint64_t end = nbTasks * (threadIdx + 1) / this->nbThreads;
+		this->deques.at(threadIdx).range.store((begin << 32) | end, std::memory_order_relaxed);
+	}
+	this->task = &task;
+	this->exception = nullptr;
+
+	// Wake up the workers (if any)
+	if (!this->workers.empty()) {
+		{
+			std::lock_guard<std::mutex> lock(this->mutex);
+			this->jobId++;
+			this->nbBusyWorkers = this->workers.size();
+		}
+		this->jobStarted.notify_all();
+	}
+
+	// Work in the calling thread also
+	this->processTasks(0);
+
+	// Wait for the workers
+	if (!this->workers.empty()) {
+		std::unique_lock<std::mutex> lock(this->mutex);
+		this->jobEnded.wait(lock, [this]() { return this->nbBusyWorkers == 0; });
+	}
+
+	this->task = nullptr;
+	if (this->exception) {
+		std::rethrow_exception(this->exception);
+	}
+}
+
+void ThreadPool::workerLoop(uint64_t threadIdx)
+{
+	uint64_t lastJobId = 0;
+	while (true) {
+		{	// Wait for a new job
+			std::unique_lock<std::mutex> lock(this->mutex);
+			this->jobStarted.wait(lock, [this, lastJobId]() { return this->stop || this->jobId != lastJobId; });
+			if (this->stop) {
+				return;
+			}
+			lastJobId = this->jobId;
+		}
+
+		this->processTasks(threadIdx);
+
+		{	// Notify the end of the job
+			std::lock_guard<std::mutex> lock(this->mutex);
+			this->nbBusyWorkers--;
+		}
+		this->jobEnded.notify_one();
+	}
+}
+
+void ThreadPool::processTasks(uint64_t threadIdx)
+{
+	auto execute = [this, threadIdx](uint64_t taskIdx) {
+		try {
+			(*this->task)(taskIdx, threadIdx);
+		}
+		catch (...) {
+			std::lock_guard<std::mutex> lock(this->exceptionMutex);
+			if (!this->exception) {
+				this->exception = std::current_exception();
+			}
+		}
+	};
+
+	uint64_t taskIdx;
+
+	// Process own tasks first
+	while (popFront(this->deques.at(threadIdx), taskIdx)) {
+		execute(taskIdx);
+	}
+
+	// Steal tasks from other threads
+	for (uint64_t offset = 1; offset < this->nbThreads; offset++) {
+		TaskDeque& victim = this->deques.at((threadIdx + offset) % this->nbThreads);
+		while (popBack(victim, taskIdx)) {
+			execute(taskIdx);
+		}
+	}
+}
+
+bool ThreadPool::popFront(TaskDeque& deque, uint64_t& taskIdx)
+{
+	uint64_t range = deque.range.load(std::memory_order_acquire);
+	uint64_t begin, end;
+	do {
+		begin = range >> 32;
+		end = range & UINT32_MAX;
+		if (begin >= end) {
+			return false;
+		}
+	} while (!deque.range.compare_exchange_weak(range, ((begin + 1) << 32) | end, std::memory_order_acq_rel, std::memory_order_acquire));
+
+	taskIdx = begin;
+	return true;
+}
+
+bool ThreadPool::popBack(TaskDeque& deque, uint64_t& taskIdx)
+{
+	uint64_t range = deque.range.load(std::memory_order_acquire);
+	uint64_t begin, end;
+	do {
+		begin = range >> 32;
+		end = range & UINT32_MAX;
+		if (begin >= end) {
+			return false;
+		}
+	} while (!deque.range.compare_exchange_weak(range, (begin << 32) | (end - 1), std::memory_order_acq_rel, std::memory_order_acquire));
+
+	taskIdx = end - 1;
+	return true;
+}
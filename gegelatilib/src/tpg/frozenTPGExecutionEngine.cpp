@@ -0,0 +1,179 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2020) :
+ *
+ * Karol Desnos <kdesnos@insa-rennes.fr> (2020)
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+#include <stdexcept>
+#include <algorithm>
+
+#include "tpg/frozenTPGExecutionEngine.h"
+
+TPG::FrozenTPGExecutionEngine::FrozenTPGExecutionEngine(const FrozenTPGGraph& graph) : graph{ graph }, registers(graph.getEnvironment().getNbRegisters()), visitStamps(graph.getVertices().size(), 0)
+{
+	// The registers belong to the engine: their storage can be written.
+	this->registerData = (double*)((const Data::DataHandler&)this->registers).getDataPointerAt(typeid(double), 0);
+
+	// Index the operand pointers of each CompiledProgram.
+	const std::vector<std::shared_ptr<const Program::CompiledProgram>>& programs = this->graph.getPrograms();
+	size_t nbOperands = 0;
+	for (const std::shared_ptr<const Program::CompiledProgram>& program : programs) {
+		this->programOperandsOffsets.push_back(nbOperands);
+		for (const Program::CompiledProgram::Line& line : program->getLines()) {
+			nbOperands += line.nbOperands;
+		}
+	}
+	this->operandPointers.resize(nbOperands, nullptr);
+
+	this->bindDataSources(this->graph.getEnvironment().getDataSources());
+}
+
+void TPG::FrozenTPGExecutionEngine::bindDataSources(const std::vector<std::reference_wrapper<const Data::DataHandler>>& dataSrc)
+{
+	// Check the compatibility of the data sources with the Environment
+	const std::vector<std::reference_wrapper<const Data::DataHandler>>& envDataSrc = this->graph.getEnvironment().getDataSources();
+	if (dataSrc.size() != envDataSrc.size()) {
+		throw std::runtime_error("Data sources characteristics for FrozenTPGGraph Execution differ from its Environment.");
+	}
+	for (size_t i = 0; i < dataSrc.size(); i++) {
+		if (dataSrc.at(i).get().getId() != envDataSrc.at(i).get().getId()) {
+			throw std::runtime_error("Data sources characteristics for FrozenTPGGraph Execution differ from its Environment.");
+		}
+	}
+
+	this->dataSourcesAndRegisters.clear();
+	this->dataSourcesAndRegisters.push_back(this->registers);
+	this->dataSourcesAndRegisters.insert(this->dataSourcesAndRegisters.end(), dataSrc.begin(), dataSrc.end());
+
+	// Resolve the operand pointers of lines executed with a kernel.
+	const std::vector<std::shared_ptr<const Program::CompiledProgram>>& programs = this->graph.getPrograms();
+	for (size_t programIdx = 0; programIdx < programs.size(); programIdx++) {
+		const Program::CompiledProgram& program = *programs[programIdx];
+		for (const Program::CompiledProgram::Line& line : program.getLines()) {
+			if (line.kernel != nullptr) {
+				const Program::CompiledProgram::Operand* lineOperands = program.getOperands(line);
+				const void** linePointers = this->operandPointers.data() + this->programOperandsOffsets[programIdx] + line.operandsOffset;
+				for (size_t i = 0; i < line.nbOperands; i++) {
+					const Program::CompiledProgram::Operand& operand = lineOperands[i];
+					linePointers[i] = this->dataSourcesAndRegisters[operand.dataSourceIndex].get().getDataPointerAt(*operand.type, operand.location);
+				}
+			}
+		}
+	}
+}
+
+double TPG::FrozenTPGExecutionEngine::executeProgram(uint64_t programIndex)
+{
+	const Program::CompiledProgram& program = *this->graph.getPrograms()[programIndex];
+	const void* const* programPointers = this->operandPointers.data() + this->programOperandsOffsets[programIndex];
+
+	// Reset registers
+	std::fill(this->registerData, this->registerData + this->graph.getEnvironment().getNbRegisters(), 0.0);
+
+	for (const Program::CompiledProgram::Line& line : program.getLines()) {
+		// Rethrow exception caught when lowering the line, if any.
+		if (line.fault) {
+			std::rethrow_exception(line.fault);
+		}
+
+		double result;
+		if (line.kernel != nullptr) {
+			result = line.kernel(*line.instruction, programPointers + line.operandsOffset, program.getParameters(line));
+		}
+		else {
+			// Fetch operands
+			this->operands.clear();
+			const Program::CompiledProgram::Operand* lineOperands = program.getOperands(line);
+			for (size_t i = 0; i < line.nbOperands; i++) {
+				const Program::CompiledProgram::Operand& operand = lineOperands[i];
+				this->operands.push_back(this->dataSourcesAndRegisters[operand.dataSourceIndex].get().getDataAt(*operand.type, operand.location));
+			}
+
+			// Fetch parameters
+			this->parameters.clear();
+			const Parameter* lineParameters = program.getParameters(line);
+			for (size_t i = 0; i < line.nbParameters; i++) {
+				this->parameters.push_back(lineParameters[i]);
+			}
+
+			result = line.instruction->execute(this->parameters, this->operands);
+		}
+
+		this->registerData[line.destinationIndex] = result;
+	}
+
+	return this->registerData[0];
+}
+
+uint64_t TPG::FrozenTPGExecutionEngine::executeFromRoot()
+{
+	const std::vector<FrozenTPGGraph::Vertex>& vertices = this->graph.getVertices();
+	const std::vector<FrozenTPGGraph::Edge>& edges = this->graph.getEdges();
+
+	this->currentStamp++;
+	// Browse the graph until an action is reached.
+	uint64_t vertexIdx = 0;
+	while (!vertices[vertexIdx].isAction) {
+		const FrozenTPGGraph::Vertex& team = vertices[vertexIdx];
+		this->visitStamps[vertexIdx] = this->currentStamp;
+
+		// Find the best bid
+		// (in case of equality, the last evaluated edge wins)
+		bool hasBid = false;
+		double bestBid = 0.0;
+		uint64_t bestDestination = 0;
+		for (uint64_t edgeIdx = team.edgesOffset; edgeIdx < team.edgesOffset + team.nbEdges; edgeIdx++) {
+			const FrozenTPGGraph::Edge& edge = edges[edgeIdx];
+			if (this->visitStamps[edge.destination] == this->currentStamp) {
+				continue;
+			}
+
+			double bid = this->executeProgram(edge.programIndex);
+			if (!hasBid || bid >= bestBid) {
+				hasBid = true;
+				bestBid = bid;
+				bestDestination = edge.destination;
+			}
+		}
+
+		if (!hasBid) {
+			// This should not happen in a correctly constructed TPG, since every team
+			// should be connected to at least one action, thus eventually breaking
+			// any potential cycles.
+			throw std::runtime_error("No outgoing edge to evaluate in the team.");
+		}
+
+		vertexIdx = bestDestination;
+	}
+
+	return vertices[vertexIdx].actionID;
+}
@@ -0,0 +1,117 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2020) :
+ *
+ * Karol Desnos <kdesnos@insa-rennes.fr> (2020)
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+#include <deque>
+#include <stdexcept>
+#include <unordered_map>
+
+#include "tpg/tpgAction.h"
+#include "tpg/tpgTeam.h"
+#include "tpg/tpgEdge.h"
+
+#include "tpg/frozenTPGGraph.h"
+
+TPG::FrozenTPGGraph::FrozenTPGGraph(const TPGGraph& graph, const TPGVertex& root) : env{ graph.getEnvironment() }
+{
+	if (!graph.hasVertex(root)) {
+		throw std::runtime_error("The root to freeze does not belong to the TPGGraph.");
+	}
+
+	// Index of the TPGVertex and Program already frozen.
+	std::unordered_map<const TPGVertex*, uint64_t> vertexIndexes;
+	std::unordered_map<const Program::Program*, uint64_t> programIndexes;
+
+	// Vertices are frozen in breadth-first order, their outgoing edges being
+	// stored when they are popped from the queue.
+	std::deque<const TPGVertex*> queue;
+	auto freezeVertex = [&](const TPGVertex* vertex) -> uint64_t {
+		auto iter = vertexIndexes.find(vertex);
+		if (iter != vertexIndexes.end()) {
+			return iter->second;
+		}
+		const uint64_t index = this->vertices.size();
+		const bool isAction = (typeid(*vertex) == typeid(TPGAction));
+		this->vertices.push_back({ isAction, (isAction) ? ((const TPGAction*)vertex)->getActionID() : 0, 0, 0 });
+		vertexIndexes.emplace(vertex, index);
+		queue.push_back(vertex);
+		return index;
+	};
+
+	freezeVertex(&root);
+	for (uint64_t vertexIdx = 0; !queue.empty(); vertexIdx++) {
+		const TPGVertex* vertex = queue.front();
+		queue.pop_front();
+
+		const std::vector<TPGEdge*>& outgoingEdges = vertex->getOutgoingEdges();
+		this->vertices.at(vertexIdx).edgesOffset = this->edges.size();
+		this->vertices.at(vertexIdx).nbEdges = outgoingEdges.size();
+
+		for (const TPGEdge* edge : outgoingEdges) {
+			const Program::Program* program = &edge->getProgram();
+			auto iter = programIndexes.find(program);
+			uint64_t programIndex;
+			if (iter == programIndexes.end()) {
+				programIndex = this->programs.size();
+				programIndexes.emplace(program, programIndex);
+				this->programs.push_back(program->getCompiledProgram());
+			}
+			else {
+				programIndex = iter->second;
+			}
+
+			this->edges.push_back({ programIndex, freezeVertex(edge->getDestination()) });
+		}
+	}
+}
+
+const Environment& TPG::FrozenTPGGraph::getEnvironment() const
+{
+	return this->env;
+}
+
+const std::vector<TPG::FrozenTPGGraph::Vertex>& TPG::FrozenTPGGraph::getVertices() const
+{
+	return this->vertices;
+}
+
+const std::vector<TPG::FrozenTPGGraph::Edge>& TPG::FrozenTPGGraph::getEdges() const
+{
+	return this->edges;
+}
+
+const std::vector<std::shared_ptr<const Program::CompiledProgram>>& TPG::FrozenTPGGraph::getPrograms() const
+{
+	return this->programs;
+}
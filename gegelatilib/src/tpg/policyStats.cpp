@@ -101,17 +101,12 @@ void TPG::PolicyStats::analyzeProgram(const Program::Program* prog)
 	this->nbLinesPerProgram.push_back(prog->getNbLines());
 
 	// Count the number of intron lines
-	size_t nbIntronLines = 0;
-	for (auto lineIdx = 0; lineIdx < prog->getNbLines(); lineIdx++) {
-		if (!prog->isIntron(lineIdx)) {
-			const Program::Line& line = prog->getLine(lineIdx);
-			this->analyzeLine(&line);
-		}
-		else {
-			nbIntronLines++;
-		}
+	const std::vector<uint64_t>& effectiveLines = prog->getEffectiveLineIndexes();
+	for (uint64_t lineIdx : effectiveLines) {
+		const Program::Line& line = prog->getLine(lineIdx);
+		this->analyzeLine(&line);
 	}
-	this->nbIntronPerProgram.push_back(nbIntronLines);
+	this->nbIntronPerProgram.push_back(prog->getNbLines() - effectiveLines.size());
 }
 
 void TPG::PolicyStats::analyzeTPGTeam(const TPG::TPGTeam* team)
@@ -46,7 +46,7 @@ void TPG::TPGEdge::setProgram(const std::shared_ptr<Program::Program> prog) cons
 	this->program = prog;
 }
 
-std::shared_ptr<Program::Program> TPG::TPGEdge::getProgramSharedPointer()
+std::shared_ptr<Program::Program> TPG::TPGEdge::getProgramSharedPointer() const
 {
 	return this->program;
 }
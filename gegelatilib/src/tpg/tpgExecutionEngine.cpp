@@ -38,6 +38,7 @@
 #include <algorithm>
 
 #include "tpg/tpgEdge.h"
+#include "tpg/tpgAction.h"
 #include "program/programExecutionEngine.h"
 
 #include "tpg/tpgExecutionEngine.h"
@@ -47,16 +48,45 @@ void TPG::TPGExecutionEngine::setArchive(Archive* newArchive)
 	this->archive = newArchive;
 }
 
+void TPG::TPGExecutionEngine::clearBidCache()
+{
+	this->bidCache.clear();
+}
+
 double TPG::TPGExecutionEngine::evaluateEdge(const TPGEdge& edge)
 {
 	// Get the program
 	Program::Program& prog = edge.getProgram();
 
-	// Set the progExecutionEngine to the program
-	this->progExecutionEngine.setProgram(prog);
+	double result;
+	bool isMemoized = false;
+	std::pair<const Program::Program*, size_t> key;
+
+	// Look for the result in the bidCache
+	if (this->bidCacheSize > 0) {
+		key = { &prog, Archive::getCombinedHash(this->progExecutionEngine.getDataSources()) };
+		auto iter = this->bidCache.find(key);
+		if (iter != this->bidCache.end()) {
+			result = iter->second;
+			isMemoized = true;
+		}
+	}
+
+	if (!isMemoized) {
+		// Set the progExecutionEngine to the program
+		this->progExecutionEngine.setProgram(prog);
+
+		// Execute the program.
+		result = this->progExecutionEngine.executeProgram();
 
-	// Execute the program.
-	double result = this->progExecutionEngine.executeProgram();
+		// Memoize the result
+		if (this->bidCacheSize > 0) {
+			if (this->bidCache.size() >= this->bidCacheSize) {
+				this->bidCache.clear();
+			}
+			this->bidCache.emplace(key, result);
+		}
+	}
 
 	// Put the result in the archive before returning it.
 	if (this->archive != NULL) {
@@ -66,45 +96,82 @@ double TPG::TPGExecutionEngine::evaluateEdge(const TPGEdge& edge)
 	return result;
 }
 
-const TPG::TPGEdge& TPG::TPGExecutionEngine::evaluateTeam(const TPGTeam& team, const std::vector<const TPGVertex*>& excluded)
+void TPG::TPGExecutionEngine::clearExcluded()
 {
-	// Copy outgoing edge list 
-	std::list<TPG::TPGEdge*> outgoingEdges = team.getOutgoingEdges();
-
-	// Remove all edges leading to excluded TPGTeam
-	std::list<TPG::TPGEdge*>::iterator iter = outgoingEdges.begin();
-	while (iter != outgoingEdges.end()) {
-		if (std::find(excluded.begin(), excluded.end(), (*iter)->getDestination()) != excluded.end()) {
-			outgoingEdges.erase(iter++);
-		}
-		else {
-			iter++;
+	this->currentStamp++;
+}
+
+void TPG::TPGExecutionEngine::exclude(const TPGVertex* vertex)
+{
+	if (vertex->getIndex() >= this->excludedStamps.size()) {
+		this->excludedStamps.resize(vertex->getIndex() + 1, { 0, nullptr });
+	}
+	this->excludedStamps[vertex->getIndex()] = { this->currentStamp, vertex };
+}
+
+bool TPG::TPGExecutionEngine::isExcluded(const TPGVertex* vertex) const
+{
+	return vertex->getIndex() < this->excludedStamps.size()
+		&& this->excludedStamps[vertex->getIndex()].first == this->currentStamp
+		&& this->excludedStamps[vertex->getIndex()].second == vertex;
+}
+
+const std::vector<std::pair<const TPG::TPGEdge*, double>>& TPG::TPGExecutionEngine::evaluateNonExcludedTeamBids(const TPGTeam& team)
+{
+	this->bids.clear();
+
+	// Evaluate all TPGEdge not leading to excluded TPGVertex
+	for (const TPGEdge* edge : team.getOutgoingEdges()) {
+		if (!this->isExcluded(edge->getDestination())) {
+			this->bids.emplace_back(edge, this->evaluateEdge(*edge));
 		}
 	}
 
+	return this->bids;
+}
+
+const std::vector<std::pair<const TPG::TPGEdge*, double>>& TPG::TPGExecutionEngine::evaluateTeamBids(const TPGTeam& team, const std::vector<const TPGVertex*>& excluded)
+{
+	this->clearExcluded();
+	for (const TPGVertex* vertex : excluded) {
+		this->exclude(vertex);
+	}
+
+	return this->evaluateNonExcludedTeamBids(team);
+}
+
+const TPG::TPGEdge& TPG::TPGExecutionEngine::evaluateNonExcludedTeam(const TPGTeam& team)
+{
+	const std::vector<std::pair<const TPGEdge*, double>>& teamBids = this->evaluateNonExcludedTeamBids(team);
+
 	// Throw an error if no edge remains
-	if (outgoingEdges.size() == 0) {
+	if (teamBids.size() == 0) {
 		// This should not happen in a correctly constructed TPG, since every team
 		// should be connected to at least one action, thus eventually breaking
 		// any potential cycles.
 		throw std::runtime_error("No outgoing edge to evaluate in the TPGTeam.");
 	}
 
-	// Evaluate all remaining TPGEdge
-	// First
-	TPGEdge* bestEdge = *outgoingEdges.begin();
-	double bestBid = this->evaluateEdge(*bestEdge);
-	// Others
-	for (auto iter = ++outgoingEdges.begin(); iter != outgoingEdges.end(); iter++) {
-		TPGEdge* edge = *iter;
-		double bid = this->evaluateEdge(*edge);
-		if (bid >= bestBid) {
-			bestEdge = edge;
-			bestBid = bid;
+	// Find the best bid
+	// (in case of equality, the last evaluated TPGEdge wins)
+	auto bestBid = teamBids.begin();
+	for (auto iter = teamBids.begin() + 1; iter != teamBids.end(); iter++) {
+		if (iter->second >= bestBid->second) {
+			bestBid = iter;
 		}
 	}
 
-	return *bestEdge;
+	return *bestBid->first;
+}
+
+const TPG::TPGEdge& TPG::TPGExecutionEngine::evaluateTeam(const TPGTeam& team, const std::vector<const TPGVertex*>& excluded)
+{
+	this->clearExcluded();
+	for (const TPGVertex* vertex : excluded) {
+		this->exclude(vertex);
+	}
+
+	return this->evaluateNonExcludedTeam(team);
 }
 
 const std::vector<const TPG::TPGVertex*> TPG::TPGExecutionEngine::executeFromRoot(const TPGVertex& root)
@@ -113,15 +180,194 @@ const std::vector<const TPG::TPGVertex*> TPG::TPGExecutionEngine::executeFromRoo
 
 	std::vector<const TPGVertex*> visitedVertices;
 	visitedVertices.push_back(currentVertex);
+	this->clearExcluded();
+	this->exclude(currentVertex);
 
 	// Browse the TPG until a TPGAction is reached.
 	while (typeid(*currentVertex) == typeid(TPG::TPGTeam)) {
 		// Get the next edge
-		const TPGEdge& edge = this->evaluateTeam(*(TPGTeam*)currentVertex, visitedVertices);
+		const TPGEdge& edge = this->evaluateNonExcludedTeam(*(TPGTeam*)currentVertex);
 		// update currentVertex and backup in visitedVertex.
 		currentVertex = edge.getDestination();
 		visitedVertices.push_back(currentVertex);
+		this->exclude(currentVertex);
 	}
 
 	return visitedVertices;
 }
+
+std::vector<uint64_t> TPG::TPGExecutionEngine::executeBatchFromRoot(const TPGVertex& root, const std::vector<std::vector<std::reference_wrapper<const Data::DataHandler>>>& observations)
+{
+	const size_t nbObservations = observations.size();
+
+	// Check the compatibility of all observations once and for all.
+	const std::vector<std::reference_wrapper<const Data::DataHandler>>& dataSources = this->progExecutionEngine.getDataSources();
+	for (const std::vector<std::reference_wrapper<const Data::DataHandler>>& observation : observations) {
+		bool isCompatible = (observation.size() == dataSources.size());
+		for (size_t i = 0; isCompatible && i < observation.size(); i++) {
+			isCompatible = (observation.at(i).get().getId() == dataSources.at(i).get().getId());
+		}
+		if (!isCompatible) {
+			throw std::runtime_error("Data sources characteristics of an observation differ from those of the TPGExecutionEngine.");
+		}
+	}
+
+	// Hash of each observation, computed once for all lookups in the
+	// bidCache.
+	std::vector<size_t> observationHashes;
+	if (this->bidCacheSize > 0) {
+		observationHashes.reserve(nbObservations);
+		for (const std::vector<std::reference_wrapper<const Data::DataHandler>>& observation : observations) {
+			observationHashes.push_back(Archive::getCombinedHash(observation));
+		}
+	}
+
+	// Vertices traversed for each observation, starting from the root.
+	std::vector<std::vector<const TPGVertex*>> visitedVertices(nbObservations, { &root });
+
+	// Best bids of each observation for the current step.
+	std::vector<std::pair<const TPGEdge*, double>> bestBids(nbObservations);
+
+	// Groups of observations being on the same TPGTeam.
+	std::vector<std::pair<const TPGTeam*, std::vector<size_t>>> groups;
+	std::unordered_map<const TPGVertex*, size_t> groupIndexes;
+
+	// For each observation of a group, and each outgoing TPGEdge of its
+	// TPGTeam, whether the TPGEdge leads to a TPGVertex already visited.
+	std::vector<bool> excludedEdges;
+
+	// Observations of a group bidding on a TPGEdge, their bids, and the
+	// data sources of those whose bid is not memoized.
+	std::vector<size_t> edgeObservations;
+	std::vector<double> edgeBids;
+	std::vector<size_t> executedBids;
+	std::vector<const std::vector<std::reference_wrapper<const Data::DataHandler>>*> executedDataSources;
+	std::vector<double> executedResults;
+
+	// Browse the TPG until a TPGAction is reached for all observations.
+	while (true) {
+		// Group observations whose current vertex is a team, in the order of
+		// observations.
+		groups.clear();
+		groupIndexes.clear();
+		for (size_t obsIdx = 0; obsIdx < nbObservations; obsIdx++) {
+			const TPGVertex* currentVertex = visitedVertices.at(obsIdx).back();
+			if (typeid(*currentVertex) == typeid(TPG::TPGTeam)) {
+				auto iter = groupIndexes.find(currentVertex);
+				if (iter == groupIndexes.end()) {
+					groupIndexes.emplace(currentVertex, groups.size());
+					groups.push_back({ (const TPGTeam*)currentVertex, { obsIdx } });
+				}
+				else {
+					groups.at(iter->second).second.push_back(obsIdx);
+				}
+			}
+		}
+
+		if (groups.empty()) {
+			break;
+		}
+
+		// Evaluate each group
+		for (const auto& group : groups) {
+			for (size_t obsIdx : group.second) {
+				bestBids.at(obsIdx) = { nullptr, 0.0 };
+			}
+
+			// Mark the outgoing edges leading to vertices visited by each
+			// observation.
+			const std::vector<TPGEdge*>& outgoingEdges = group.first->getOutgoingEdges();
+			const size_t nbEdges = outgoingEdges.size();
+			excludedEdges.assign(group.second.size() * nbEdges, false);
+			for (size_t groupIdx = 0; groupIdx < group.second.size(); groupIdx++) {
+				this->clearExcluded();
+				for (const TPGVertex* vertex : visitedVertices.at(group.second.at(groupIdx))) {
+					this->exclude(vertex);
+				}
+				for (size_t edgeIdx = 0; edgeIdx < nbEdges; edgeIdx++) {
+					excludedEdges[groupIdx * nbEdges + edgeIdx] = this->isExcluded(outgoingEdges.at(edgeIdx)->getDestination());
+				}
+			}
+
+			for (size_t edgeIdx = 0; edgeIdx < nbEdges; edgeIdx++) {
+				const TPGEdge* edge = outgoingEdges.at(edgeIdx);
+				Program::Program& prog = edge->getProgram();
+
+				// Observations of the group not excluding the edge destination,
+				// and their memoized bids.
+				edgeObservations.clear();
+				edgeBids.clear();
+				executedBids.clear();
+				executedDataSources.clear();
+				for (size_t groupIdx = 0; groupIdx < group.second.size(); groupIdx++) {
+					if (excludedEdges[groupIdx * nbEdges + edgeIdx]) {
+						continue;
+					}
+
+					const size_t obsIdx = group.second.at(groupIdx);
+
+					edgeObservations.push_back(obsIdx);
+					edgeBids.push_back(0.0);
+					auto iter = (this->bidCacheSize > 0) ? this->bidCache.find({ &prog, observationHashes.at(obsIdx) }) : this->bidCache.end();
+					if (iter != this->bidCache.end()) {
+						edgeBids.back() = iter->second;
+					}
+					else {
+						executedBids.push_back(edgeBids.size() - 1);
+						executedDataSources.push_back(&observations.at(obsIdx));
+					}
+				}
+
+				// Execute the compiled Program once for all remaining
+				// observations. (setProgram checks the Environment of the
+				// Program only if it differs from the previous one.)
+				if (!executedDataSources.empty()) {
+					this->progExecutionEngine.setProgram(prog);
+					this->progExecutionEngine.executeCompiledProgramBatch(*prog.getCompiledProgram(), executedDataSources, executedResults);
+					for (size_t i = 0; i < executedBids.size(); i++) {
+						edgeBids.at(executedBids.at(i)) = executedResults.at(i);
+						if (this->bidCacheSize > 0) {
+							if (this->bidCache.size() >= this->bidCacheSize) {
+								this->bidCache.clear();
+							}
+							this->bidCache.emplace(std::make_pair(&prog, observationHashes.at(edgeObservations.at(executedBids.at(i)))), executedResults.at(i));
+						}
+					}
+				}
+
+				for (size_t i = 0; i < edgeObservations.size(); i++) {
+					const size_t obsIdx = edgeObservations.at(i);
+					const double bid = edgeBids.at(i);
+
+					// Put the result in the archive.
+					if (this->archive != NULL) {
+						this->archive->addRecording(&prog, observations.at(obsIdx), bid);
+					}
+
+					// (in case of equality, the last evaluated TPGEdge wins)
+					std::pair<const TPGEdge*, double>& bestBid = bestBids.at(obsIdx);
+					if (bestBid.first == nullptr || bid >= bestBid.second) {
+						bestBid = { edge, bid };
+					}
+				}
+			}
+
+			// Follow the best edge.
+			for (size_t obsIdx : group.second) {
+				if (bestBids.at(obsIdx).first == nullptr) {
+					throw std::runtime_error("No outgoing edge to evaluate in the TPGTeam.");
+				}
+				visitedVertices.at(obsIdx).push_back(bestBids.at(obsIdx).first->getDestination());
+			}
+		}
+	}
+
+	// Collect action IDs
+	std::vector<uint64_t> actionIDs;
+	actionIDs.reserve(nbObservations);
+	for (const std::vector<const TPGVertex*>& vertices : visitedVertices) {
+		actionIDs.push_back(((const TPGAction*)vertices.back())->getActionID());
+	}
+
+	return actionIDs;
+}
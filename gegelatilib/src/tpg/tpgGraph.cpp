@@ -37,8 +37,11 @@
 #include <algorithm>
 #include <stdexcept>
 #include <type_traits>
+#include <iterator>
+#include <unordered_set>
 
 #include "tpg/tpgGraph.h"
+#include "tpg/frozenTPGGraph.h"
 
 TPG::TPGGraph::~TPGGraph()
 {
@@ -59,8 +62,9 @@ TPG::TPGGraph& TPG::TPGGraph::operator=(TPGGraph model)
 void TPG::TPGGraph::clear()
 {
 	// Remove all vertices
+	// (Empty slots at the end of the vertices are removed by removeVertex)
 	while (this->vertices.size() > 0) {
-		this->removeVertex(*this->vertices.front());
+		this->removeVertex(*this->vertices.back());
 	}
 }
 
@@ -69,81 +73,167 @@ const Environment& TPG::TPGGraph::getEnvironment() const
 	return this->env;
 }
 
+void TPG::TPGGraph::addVertex(TPGVertex* vertex)
+{
+	vertex->index = this->vertices.size();
+	this->vertices.push_back(vertex);
+	this->nbVertices++;
+	this->vertexSet.insert(vertex);
+	// A new vertex has no incoming edge.
+	this->rootVertices.emplace(vertex->index, vertex);
+}
+
+void TPG::TPGGraph::compactVertices()
+{
+	uint64_t nbKept = 0;
+	for (TPGVertex* vertex : this->vertices) {
+		if (vertex != NULL) {
+			vertex->index = nbKept;
+			this->vertices[nbKept] = vertex;
+			nbKept++;
+		}
+	}
+	this->vertices.resize(nbKept);
+
+	// Re-index the root vertices (their order is unchanged)
+	std::map<uint64_t, const TPGVertex*> newRootVertices;
+	for (const auto& rootVertex : this->rootVertices) {
+		newRootVertices.emplace_hint(newRootVertices.end(), rootVertex.second->getIndex(), rootVertex.second);
+	}
+	this->rootVertices.swap(newRootVertices);
+}
+
+void TPG::TPGGraph::updateRootVertex(const TPGVertex* vertex)
+{
+	uint64_t index = vertex->getIndex();
+	if (vertex->getIncomingEdges().size() == 0) {
+		this->rootVertices.emplace(index, vertex);
+	}
+	else {
+		this->rootVertices.erase(index);
+	}
+}
+
 const TPG::TPGTeam& TPG::TPGGraph::addNewTeam() {
-	this->vertices.push_back(new TPG::TPGTeam());
+	this->addVertex(new TPG::TPGTeam());
 	return (const TPGTeam&)(*this->vertices.back());
 }
 
 const TPG::TPGAction& TPG::TPGGraph::addNewAction(uint64_t actionID)
 {
-	this->vertices.push_back(new TPG::TPGAction(actionID));
+	this->addVertex(new TPG::TPGAction(actionID));
 	return (const TPGAction&)(*this->vertices.back());
 }
 
 size_t TPG::TPGGraph::getNbVertices() const
 {
-	return this->vertices.size();
+	return this->nbVertices;
 }
 
 const std::vector<const TPG::TPGVertex*> TPG::TPGGraph::getVertices() const
 {
-	std::vector<const TPG::TPGVertex*> result(this->vertices.size());
-	std::copy(this->vertices.begin(), this->vertices.end(), result.begin());
+	std::vector<const TPG::TPGVertex*> result;
+	result.reserve(this->nbVertices);
+	for (const TPGVertex* vertex : this->vertices) {
+		if (vertex != NULL) {
+			result.push_back(vertex);
+		}
+	}
 	return result;
 }
 
 uint64_t TPG::TPGGraph::getNbRootVertices() const
 {
-	return std::count_if(this->vertices.begin(), this->vertices.end(),
-		[](const TPGVertex* vertex) {
-			return vertex->getIncomingEdges().size() == 0;
-		});
+	return this->rootVertices.size();
 }
 
 const std::vector<const TPG::TPGVertex*> TPG::TPGGraph::getRootVertices() const
 {
 	std::vector<const TPG::TPGVertex*> result;
-	std::copy_if(this->vertices.begin(), this->vertices.end(), std::back_inserter(result),
-		[](TPGVertex* vertex) {
-			return vertex->getIncomingEdges().size() == 0;
-		});
+	result.reserve(this->rootVertices.size());
+	for (const auto& rootVertex : this->rootVertices) {
+		result.push_back(rootVertex.second);
+	}
 	return result;
 }
 
+TPG::FrozenTPGGraph TPG::TPGGraph::freeze(const TPGVertex& root) const
+{
+	return FrozenTPGGraph(*this, root);
+}
+
+TPG::TPGGraph TPG::TPGGraph::clone() const
+{
+	TPGGraph copy(this->env);
+
+	// Duplicate vertices, in the same order
+	std::unordered_map<const TPGVertex*, const TPGVertex*> vertexCopies;
+	for (const TPGVertex* vertex : this->getVertices()) {
+		if (typeid(*vertex) == typeid(TPGAction)) {
+			vertexCopies.emplace(vertex, &copy.addNewAction(((const TPGAction*)vertex)->getActionID()));
+		}
+		else {
+			vertexCopies.emplace(vertex, &copy.addNewTeam());
+		}
+	}
+
+	// Duplicate edges, sharing their Program
+	for (const TPGEdge& edge : this->edges) {
+		copy.addNewEdge(*vertexCopies.at(edge.getSource()), *vertexCopies.at(edge.getDestination()),
+			edge.getProgramSharedPointer());
+	}
+
+	// Programs are shared, and so are their interning entries.
+	copy.programTable = this->programTable;
+
+	return copy;
+}
+
 bool TPG::TPGGraph::hasVertex(const TPG::TPGVertex& vertex) const
 {
-	return std::find(this->vertices.cbegin(), this->vertices.cend(), &vertex) != this->vertices.cend();
+	// The vertex may be destroyed: it must not be dereferenced.
+	return this->vertexSet.count(&vertex) != 0;
 }
 
 void TPG::TPGGraph::removeVertex(const TPGVertex& vertex)
 {
 	// Remove the vertex based on a pointer comparison.
-	auto iterator = this->findVertex(&vertex);
-	if (iterator != this->vertices.end()) {
+	TPGVertex* vertexPtr = this->findVertex(&vertex);
+	if (vertexPtr != NULL) {
 		// Remove all connected edges.
 		// copy inEdges set for removal 
 		// (because iterating on the modified set is not a good idea). 
-		std::list<TPGEdge*> inEdgesToRemove = (*iterator)->getIncomingEdges();
+		std::vector<TPGEdge*> inEdgesToRemove = vertexPtr->getIncomingEdges();
 		for (auto inEdge : inEdgesToRemove) {
 			this->removeEdge(*inEdge);
 		}
 		// copy outEdges set for removal 
-		std::list<TPGEdge*> outEdgesToRemove = (*iterator)->getOutgoingEdges();
+		std::vector<TPGEdge*> outEdgesToRemove = vertexPtr->getOutgoingEdges();
 		for (auto outEdge : outEdgesToRemove) {
 			this->removeEdge(*outEdge);
 		}
+		// Empty the slot of the vertex, keeping the order of the others.
+		this->rootVertices.erase(vertexPtr->getIndex());
+		this->vertices[vertexPtr->getIndex()] = NULL;
+		this->nbVertices--;
+		this->vertexSet.erase(vertexPtr);
+		// Drop empty slots at the end of the vertices, and compact the
+		// vertices when empty slots outnumber them.
+		while (this->vertices.size() > 0 && this->vertices.back() == NULL) {
+			this->vertices.pop_back();
+		}
+		if (this->vertices.size() > 2 * this->nbVertices) {
+			this->compactVertices();
+		}
 		// Free the memory of the vertex
-		delete* iterator;
-		// Remove the pointer from the list.
-		this->vertices.erase(iterator);
+		delete vertexPtr;
 	}
 }
 
 const TPG::TPGVertex& TPG::TPGGraph::cloneVertex(const TPGVertex& vertex)
 {
 	// Check that the vertex to clone exists in the graph
-	auto vertexIterator = this->findVertex(&vertex);
-	if (vertexIterator == this->vertices.end()) {
+	if (!this->hasVertex(vertex)) {
 		throw std::runtime_error("The vertex to clone does not exist in the TPGGraph.");
 	}
 
@@ -170,15 +260,9 @@ const TPG::TPGVertex& TPG::TPGGraph::cloneVertex(const TPGVertex& vertex)
 const TPG::TPGEdge& TPG::TPGGraph::addNewEdge(const TPGVertex& src, const TPGVertex& dest, const std::shared_ptr<Program::Program> prog)
 {
 	// Check the TPGVertex existence within the graph.
-	auto srcVertex = std::find_if(this->vertices.begin(), this->vertices.end(),
-		[&src](TPG::TPGVertex* other) {
-			return other == &src;
-		});
-	auto dstVertex = std::find_if(this->vertices.begin(), this->vertices.end(),
-		[&dest](TPG::TPGVertex* other) {
-			return other == &dest;
-		});
-	if (dstVertex == this->vertices.end() || srcVertex == this->vertices.end()) {
+	TPGVertex* srcVertex = this->findVertex(&src);
+	TPGVertex* dstVertex = this->findVertex(&dest);
+	if (dstVertex == NULL || srcVertex == NULL) {
 		throw std::runtime_error("Attempting to add a TPGEdge between vertices not present in the TPGGraph.");
 	}
 
@@ -189,14 +273,16 @@ const TPG::TPGEdge& TPG::TPGGraph::addNewEdge(const TPGVertex& src, const TPGVer
 	// Add the edged to the Vertices
 	try {
 		// (May throw if an outgoing edge is added to an action)
-		(*srcVertex)->addOutgoingEdge(&newEdge);
+		srcVertex->addOutgoingEdge(&newEdge);
 	}
 	catch (std::runtime_error e) {
 		// Remove the edge before re-throwing
 		this->edges.pop_back();
 		throw e;
 	}
-	(*dstVertex)->addIncomingEdge(&newEdge);
+	dstVertex->addIncomingEdge(&newEdge);
+	this->updateRootVertex(dstVertex);
+	this->edgeIndex.emplace(&newEdge, std::prev(this->edges.end()));
 
 	// return the new edge
 	return newEdge;
@@ -210,19 +296,18 @@ const std::list<TPG::TPGEdge>& TPG::TPGGraph::getEdges() const
 void TPG::TPGGraph::removeEdge(const TPGEdge& edge)
 {
 	// Get the edge (if it is in the graph)
-	auto iterator = std::find_if(this->edges.begin(), this->edges.end(),
-		[&edge](TPG::TPGEdge& other) {
-			return &edge == &other;
-		});
+	auto iterator = this->findEdge(&edge);
 
 	// Disconnect the edge from the vertices
 	if (iterator == this->edges.end()) {
 		throw std::runtime_error("Cannot erase a edge that does not belong to the graph");
 	}
 
-	(*this->findVertex(iterator->getSource()))->removeOutgoingEdge(&(*iterator));
-	(*this->findVertex(iterator->getDestination()))->removeIncomingEdge(&(*iterator));
+	this->findVertex(iterator->getSource())->removeOutgoingEdge(&(*iterator));
+	this->findVertex(iterator->getDestination())->removeIncomingEdge(&(*iterator));
+	this->updateRootVertex(iterator->getDestination());
 	// Remove the edge
+	this->edgeIndex.erase(&(*iterator));
 	this->edges.erase(iterator);
 }
 
@@ -242,18 +327,20 @@ bool TPG::TPGGraph::setEdgeDestination(const TPGEdge& edge, const TPGVertex& new
 	// Find the edge and vertex
 	auto iterNewDestination = findVertex(&newDest);
 	auto iterEdge = findEdge(&edge);
-	if (iterNewDestination != this->vertices.end() && iterEdge != this->edges.end()) {
+	if (iterNewDestination != NULL && iterEdge != this->edges.end()) {
 		// Unregister the edge from the old destination
 		const TPG::TPGVertex* oldDestination = iterEdge->getDestination();
 		auto iterOldDest = findVertex(oldDestination);
 		// finding the vertex should not fail. Otherwise, the exception for 
 		// next line would be well deserved since it means an edge in the 
 		// graph is connected to a vertex not in the graph.
-		(*iterOldDest)->removeIncomingEdge(&*iterEdge);
+		iterOldDest->removeIncomingEdge(&*iterEdge);
 		// Register the edge to the new destination
-		(*iterNewDestination)->addIncomingEdge(&*iterEdge);
+		iterNewDestination->addIncomingEdge(&*iterEdge);
+		this->updateRootVertex(iterOldDest);
+		this->updateRootVertex(iterNewDestination);
 		// Set the destination
-		iterEdge->setDestination(*iterNewDestination);
+		iterEdge->setDestination(iterNewDestination);
 		return true;
 	}
 	else {
@@ -266,18 +353,18 @@ bool TPG::TPGGraph::setEdgeSource(const TPGEdge& edge, const TPGVertex& newSrc)
 	// Find the edge and vertex
 	auto iterNewSrc = findVertex(&newSrc);
 	auto iterEdge = findEdge(&edge);
-	if (iterNewSrc != this->vertices.end() && iterEdge != this->edges.end()) {
+	if (iterNewSrc != NULL && iterEdge != this->edges.end()) {
 		// Unregister the edge from the old source
 		const TPG::TPGVertex* oldSrc = iterEdge->getSource();
 		auto iterOldSrc = findVertex(oldSrc);
 		// finding the vertex should not fail. Otherwise, the exception for 
 		// next line would be well deserved since it means an edge in the 
 		// graph is connected to a vertex not in the graph.
-		(*iterOldSrc)->removeOutgoingEdge(&*iterEdge);
+		iterOldSrc->removeOutgoingEdge(&*iterEdge);
 		// Register the edge to the new source
-		(*iterNewSrc)->addOutgoingEdge(&*iterEdge);
+		iterNewSrc->addOutgoingEdge(&*iterEdge);
 		// Set the destination
-		iterEdge->setSource(*(iterNewSrc));
+		iterEdge->setSource(iterNewSrc);
 		return true;
 	}
 	else {
@@ -285,13 +372,76 @@ bool TPG::TPGGraph::setEdgeSource(const TPGEdge& edge, const TPGVertex& newSrc)
 	}
 }
 
-std::list<TPG::TPGVertex*>::iterator TPG::TPGGraph::findVertex(const TPG::TPGVertex* vertex) {
-	return std::find(this->vertices.begin(), this->vertices.end(), vertex);
+uint64_t TPG::TPGGraph::internPrograms()
+{
+	// Forget Programs no longer associated to any edge.
+	for (auto iter = this->programTable.begin(); iter != this->programTable.end();) {
+		iter = (iter->second.expired()) ? this->programTable.erase(iter) : std::next(iter);
+	}
+
+	uint64_t nbReplaced = 0;
+	for (TPGEdge& edge : this->edges) {
+		std::shared_ptr<Program::Program> prog = edge.getProgramSharedPointer();
+		prog->updateIntrons();
+		const uint64_t hash = prog->getEffectiveCodeHash();
+
+		// Look for an interned Program with the same effective code.
+		// Effective codes are compared in case of a hash collision, and the
+		// effective code of the edge Program is built at most once.
+		std::shared_ptr<Program::Program> internedProg;
+		std::vector<uint64_t> effectiveCode;
+		bool effectiveCodeBuilt = false;
+		auto range = this->programTable.equal_range(hash);
+		for (auto iter = range.first; iter != range.second && internedProg == nullptr; iter++) {
+			std::shared_ptr<Program::Program> candidate = iter->second.lock();
+			if (candidate == prog) {
+				internedProg = candidate;
+			}
+			else if (candidate != nullptr) {
+				if (!effectiveCodeBuilt) {
+					effectiveCode = prog->getEffectiveCode();
+					effectiveCodeBuilt = true;
+				}
+				if (candidate->getEffectiveCode() == effectiveCode) {
+					internedProg = candidate;
+				}
+			}
+		}
+
+		if (internedProg == nullptr) {
+			this->programTable.emplace(hash, prog);
+		}
+		else if (internedProg != prog) {
+			edge.setProgram(internedProg);
+			nbReplaced++;
+		}
+	}
+
+	this->nbDeduplicatedPrograms += nbReplaced;
+	return nbReplaced;
+}
+
+uint64_t TPG::TPGGraph::getNbPrograms() const
+{
+	std::unordered_set<const Program::Program*> programs;
+	for (const TPGEdge& edge : this->edges) {
+		programs.insert(&edge.getProgram());
+	}
+	return programs.size();
+}
+
+uint64_t TPG::TPGGraph::getNbDeduplicatedPrograms() const
+{
+	return this->nbDeduplicatedPrograms;
+}
+
+TPG::TPGVertex* TPG::TPGGraph::findVertex(const TPG::TPGVertex* vertex) {
+	// Vertices of the graph are owned (and modifiable) by the graph.
+	return (this->hasVertex(*vertex)) ? (TPGVertex*)vertex : NULL;
 }
 
 std::list<TPG::TPGEdge>::iterator TPG::TPGGraph::findEdge(const TPGEdge* edge)
 {
-	return std::find_if(this->edges.begin(), this->edges.end(),
-		[&edge](TPG::TPGEdge& other) {return &other == edge; }
-	);
+	auto iter = this->edgeIndex.find(edge);
+	return (iter != this->edgeIndex.end()) ? iter->second : this->edges.end();
 }
@@ -37,12 +37,17 @@
 
 #include "tpg/tpgVertex.h"
 
-const std::list<TPG::TPGEdge*>& TPG::TPGVertex::getIncomingEdges() const
+uint64_t TPG::TPGVertex::getIndex() const
+{
+	return this->index;
+}
+
+const std::vector<TPG::TPGEdge*>& TPG::TPGVertex::getIncomingEdges() const
 {
 	return this->incomingEdges;
 }
 
-const std::list<TPG::TPGEdge*>& TPG::TPGVertex::getOutgoingEdges() const
+const std::vector<TPG::TPGEdge*>& TPG::TPGVertex::getOutgoingEdges() const
 {
 	return this->outgoingEdges;
 }
@@ -62,7 +67,7 @@ void TPG::TPGVertex::removeIncomingEdge(TPG::TPGEdge* edge)
 {
 	// No need to do special checks on the given pointer.
 	// at worse, nothing happens.
-	this->incomingEdges.remove(edge);
+	this->incomingEdges.erase(std::remove(this->incomingEdges.begin(), this->incomingEdges.end(), edge), this->incomingEdges.end());
 }
 
 void TPG::TPGVertex::addOutgoingEdge(TPG::TPGEdge* edge)
@@ -77,5 +82,5 @@ void TPG::TPGVertex::addOutgoingEdge(TPG::TPGEdge* edge)
 
 void TPG::TPGVertex::removeOutgoingEdge(TPG::TPGEdge* edge)
 {
-	this->outgoingEdges.remove(edge);
+	this->outgoingEdges.erase(std::remove(this->outgoingEdges.begin(), this->outgoingEdges.end(), edge), this->outgoingEdges.end());
 }
@@ -45,6 +45,7 @@
 #include "mutator/rng.h"
 
 #include "archive.h"
+#include "archiveRecordingBuffer.h"
 
 class ArchiveTest : public ::testing::Test {
 protected:
@@ -145,6 +146,32 @@ TEST_F(ArchiveTest, AddRecordingWithProbabilityTests) {
 	ASSERT_EQ(archive.getNbRecordings(), 4) << "Number or recordings in the archive is incorrect with a known seed.";
 }
 
+TEST_F(ArchiveTest, AddRecordingEviction) {
+	Archive archive(100, 1.0);
+	Data::PrimitiveTypeArray<int>& d = (Data::PrimitiveTypeArray<int>&)vect.at(1).get();
+
+	// Fill the archive with recordings cycling over 30 DataHandlers values,
+	// so that all values are referenced by several recordings.
+	for (int i = 0; i < 1000; i++) {
+		d.setDataAt(typeid(int), 0, i % 30);
+		archive.addRecording(p, vect, (double)i);
+	}
+	ASSERT_EQ(archive.getNbRecordings(), 100) << "Number or recordings in the archive is incorrect.";
+	ASSERT_EQ(archive.getNbDataHandlers(), 30) << "Number or dataHandlers copied in the archive is incorrect.";
+
+	// Evict all recordings referencing 20 of the 30 DataHandlers values.
+	for (int i = 0; i < 100; i++) {
+		d.setDataAt(typeid(int), 0, 1000 + i % 10);
+		archive.addRecording(p, vect, (double)i);
+	}
+	ASSERT_EQ(archive.getNbRecordings(), 100) << "Number or recordings in the archive is incorrect.";
+	ASSERT_EQ(archive.getNbDataHandlers(), 10) << "DataHandlers no longer referenced should be removed from the archive.";
+	for (int i = 0; i < 30; i++) {
+		d.setDataAt(typeid(int), 0, i);
+		ASSERT_FALSE(archive.hasDataHandlers(Archive::getCombinedHash(vect))) << "Evicted DataHandlers should not be in the archive.";
+	}
+}
+
 TEST_F(ArchiveTest, At) {
 	// For these test, force archivingProbability to 0.5
 	// Use a known seed
@@ -206,6 +233,84 @@ TEST_F(ArchiveTest, areProgramResultsUnique) {
 	ASSERT_FALSE(archive.areProgramResultsUnique(hashesAndResults3, 0.21)) << "Within margin fake program bidding behavior not detected as such.";
 }
 
+TEST_F(ArchiveTest, areProgramResultsUniqueAfterEviction) {
+	Archive archive(20);
+	Data::PrimitiveTypeArray<int>& d = (Data::PrimitiveTypeArray<int>&)vect.at(1).get();
+	Program::Program p2(*e);
+	Program::Program p3(*e);
+	const Program::Program* programs[] = { p, &p2, &p3 };
+
+	// Reference implementation, browsing all recordings of the archive.
+	auto referenceUnique = [&archive](const std::map<size_t, double>& hashesAndResults, double tau) {
+		std::map<const Program::Program*, std::vector<const ArchiveRecording*>> recordingsPerProgram;
+		for (uint64_t idx = 0; idx < archive.getNbRecordings(); idx++) {
+			recordingsPerProgram[archive.at(idx).prog].push_back(&archive.at(idx));
+		}
+		for (auto& programRecordings : recordingsPerProgram) {
+			bool isIdentical = false;
+			for (auto recording : programRecordings.second) {
+				auto iter = hashesAndResults.find(recording->dataHash);
+				if (iter != hashesAndResults.end()) {
+					isIdentical = std::abs(iter->second - recording->result) <= tau;
+					if (!isIdentical) break;
+				}
+			}
+			if (isIdentical) return false;
+		}
+		return true;
+	};
+
+	// Add many recordings, with several results for a same program and 
+	// hash, and evictions.
+	Mutator::RNG rng(0);
+	for (int i = 0; i < 200; i++) {
+		d.setDataAt(typeid(int), 0, (int)rng.getUnsignedInt64(0, 5));
+		double result = (double)rng.getUnsignedInt64(0, 3);
+		if (i == 150) {
+			result = NAN;
+		}
+		archive.addRecording(programs[rng.getUnsignedInt64(0, 2)], vect, result);
+
+		// Compare with candidates results on all hashes
+		for (int candidate = 0; candidate < 5; candidate++) {
+			std::map<size_t, double> hashesAndResults;
+			for (int value = 0; value < 6; value++) {
+				if (rng.getDouble(0.0, 1.0) < 0.7) {
+					d.setDataAt(typeid(int), 0, value);
+					hashesAndResults[Archive::getCombinedHash(vect)] = (double)rng.getUnsignedInt64(0, 3);
+				}
+			}
+			ASSERT_EQ(archive.areProgramResultsUnique(hashesAndResults, 0.5), referenceUnique(hashesAndResults, 0.5)) << "Unicity test differs from the reference after " << i << " recordings.";
+		}
+	}
+}
+
+TEST_F(ArchiveTest, areProgramResultsUniqueAfterPartialEviction) {
+	Archive archive(3);
+	Data::PrimitiveTypeArray<int>& d = (Data::PrimitiveTypeArray<int>&)vect.at(1).get();
+	Program::Program p2(*e);
+
+	// Three results of a same Program for a same hash, the first being NaN.
+	d.setDataAt(typeid(int), 0, 0);
+	size_t hash = Archive::getCombinedHash(vect);
+	archive.addRecording(p, vect, NAN);
+	archive.addRecording(p, vect, 5.0);
+	archive.addRecording(p, vect, 5.0);
+	ASSERT_TRUE(archive.areProgramResultsUnique({ {hash, 5.0} })) << "Results of a Program with a NaN recording should be unique.";
+
+	// Evict the NaN recording with a recording on another hash.
+	d.setDataAt(typeid(int), 0, 1);
+	archive.addRecording(&p2, vect, 1.0);
+	ASSERT_FALSE(archive.areProgramResultsUnique({ {hash, 5.0} })) << "Minimum and maximum results were not rebuilt after the eviction of a recording.";
+
+	// Evict a second recording of the Program, and add a new result.
+	d.setDataAt(typeid(int), 0, 0);
+	archive.addRecording(p, vect, 6.0);
+	ASSERT_FALSE(archive.areProgramResultsUnique({ {hash, 5.5} }, 0.6)) << "Results within tau of all remaining recordings should not be unique.";
+	ASSERT_TRUE(archive.areProgramResultsUnique({ {hash, 5.0} }, 0.6)) << "Results not within tau of all remaining recordings should be unique.";
+	ASSERT_TRUE(archive.areProgramResultsUnique({ {hash, 6.0} }, 0.6)) << "Results not within tau of all remaining recordings should be unique.";
+}
+
 TEST_F(ArchiveTest, DataHandlersAccessors) {
 	Archive archive(4);
 
@@ -237,3 +342,122 @@ TEST_F(ArchiveTest, Clear) {
 	ASSERT_EQ(archive.getNbRecordings(), 0) << "Number or recordings in the archive is incorrect.";
 	ASSERT_EQ(archive.getNbDataHandlers(), 0) << "Number or dataHandlers copied in the archive is incorrect.";
 }
+
+TEST_F(ArchiveTest, InsertRecording) {
+	Archive archive(2);
+
+	// Insert a recording with a new hash: ownership of the copy is taken.
+	size_t hash1 = Archive::getCombinedHash(vect);
+	std::vector<std::reference_wrapper<const Data::DataHandler>> copy1;
+	for (auto dh : vect) {
+		copy1.push_back(*dh.get().clone());
+	}
+	ASSERT_NO_THROW(archive.insertRecording(p, hash1, 1.0, copy1)) << "Inserting a recording in an empty archive failed.";
+	ASSERT_EQ(copy1.size(), 0) << "Ownership of the DataHandler copy should be taken by the Archive.";
+	ASSERT_EQ(archive.getNbRecordings(), 1) << "Number or recordings in the archive is incorrect.";
+	ASSERT_TRUE(archive.hasDataHandlers(hash1)) << "Inserted DataHandler should be in the archive.";
+
+	// Insert a recording with a known hash: copy is left untouched.
+	std::vector<std::reference_wrapper<const Data::DataHandler>> copy2;
+	for (auto dh : vect) {
+		copy2.push_back(*dh.get().clone());
+	}
+	ASSERT_NO_THROW(archive.insertRecording(p, hash1, 2.0, copy2)) << "Inserting a recording in a non-empty archive failed.";
+	ASSERT_EQ(copy2.size(), 2) << "DataHandler copy should remain owned by the caller.";
+	ASSERT_EQ(archive.getNbRecordings(), 2) << "Number or recordings in the archive is incorrect.";
+	ASSERT_EQ(archive.getNbDataHandlers(), 1) << "Number or dataHandlers copied in the archive is incorrect.";
+
+	// Eviction still applies
+	std::vector<std::reference_wrapper<const Data::DataHandler>> empty;
+	ASSERT_NO_THROW(archive.insertRecording(p, hash1, 3.0, empty)) << "Inserting a recording in a full archive failed.";
+	ASSERT_EQ(archive.getNbRecordings(), 2) << "Number or recordings in the archive is incorrect.";
+	ASSERT_EQ(archive.at(0).result, 2.0) << "Oldest recording should be evicted.";
+
+	for (auto dh : copy2) {
+		delete& dh.get();
+	}
+}
+
+TEST_F(ArchiveTest, ArchiveRecordingBuffer) {
+	ArchiveRecordingBuffer* buffer;
+	ASSERT_NO_THROW(buffer = new ArchiveRecordingBuffer(3, 1.0)) << "Construction of an ArchiveRecordingBuffer failed.";
+	ASSERT_THROW(buffer->addRecording(p, vect, 1.0), std::runtime_error) << "Adding a recording without segment should fail.";
+
+	ASSERT_NO_THROW(buffer->startSegment(0, 0)) << "Starting a segment failed.";
+	Data::PrimitiveTypeArray<int>& d = (Data::PrimitiveTypeArray<int>&)vect.at(1).get();
+	for (int i = 0; i < 5; i++) {
+		d.setDataAt(typeid(int), 0, i);
+		ASSERT_NO_THROW(buffer->addRecording(p, vect, (double)i)) << "Adding a recording to an ArchiveRecordingBuffer failed.";
+	}
+	ASSERT_EQ(buffer->getNbBufferedRecordings(), 3) << "Number of recordings in a segment should not exceed the buffer size.";
+	ASSERT_EQ(buffer->getNbRecordings(), 0) << "Recordings of an ArchiveRecordingBuffer should not be accessible as regular recordings.";
+
+	ASSERT_NO_THROW(buffer->clearBuffer()) << "Clearing an ArchiveRecordingBuffer failed.";
+	ASSERT_EQ(buffer->getNbBufferedRecordings(), 0) << "Cleared ArchiveRecordingBuffer should be empty.";
+
+	buffer->startSegment(1, 0);
+	buffer->addRecording(p, vect, 1.0);
+	ASSERT_NO_THROW(delete buffer) << "Destruction of a non-empty ArchiveRecordingBuffer failed.";
+}
+
+TEST_F(ArchiveTest, ArchiveRecordingBufferMerge) {
+	// Reference: One Archive per root, merged with forced recordings.
+	const size_t archiveSize = 7;
+	const double archivingProbability = 0.5;
+	const uint64_t nbRoots = 6;
+	Data::PrimitiveTypeArray<int>& d = (Data::PrimitiveTypeArray<int>&)vect.at(1).get();
+	auto recordRoot = [&](Archive& arch, uint64_t root) {
+		for (int i = 0; i < 8; i++) {
+			// Some data is shared among roots
+			d.setDataAt(typeid(int), 0, (int)(root % 2) * 100 + i);
+			arch.addRecording(p, vect, (double)(root * 10 + i));
+		}
+	};
+
+	Archive referenceArchive(archiveSize, archivingProbability);
+	referenceArchive.addRecording(p, vect, -1.0, true);
+	std::vector<Archive*> rootArchives;
+	for (uint64_t root = 0; root < nbRoots; root++) {
+		rootArchives.push_back(new Archive(archiveSize, archivingProbability, root));
+		recordRoot(*rootArchives.back(), root);
+	}
+	std::vector<std::tuple<const Program::Program*, std::vector<std::reference_wrapper<const Data::DataHandler>>, double>> allRecordings;
+	for (Archive* rootArchive : rootArchives) {
+		for (uint64_t idx = 0; idx < rootArchive->getNbRecordings(); idx++) {
+			const ArchiveRecording& rec = rootArchive->at(idx);
+			allRecordings.push_back({ rec.prog, rootArchive->getDataHandlers().at(rec.dataHash), rec.result });
+		}
+	}
+	for (size_t idx = (allRecordings.size() > archiveSize) ? allRecordings.size() - archiveSize : 0; idx < allRecordings.size(); idx++) {
+		referenceArchive.addRecording(std::get<0>(allRecordings.at(idx)), std::get<1>(allRecordings.at(idx)), std::get<2>(allRecordings.at(idx)), true);
+	}
+	for (Archive* rootArchive : rootArchives) {
+		delete rootArchive;
+	}
+
+	// Buffers: roots are dispatched in an arbitrary order among two buffers.
+	Archive archive(archiveSize, archivingProbability);
+	archive.addRecording(p, vect, -1.0, true);
+	ArchiveRecordingBuffer buffer0(archiveSize, archivingProbability);
+	ArchiveRecordingBuffer buffer1(archiveSize, archivingProbability);
+	for (uint64_t root : { 5, 0, 3, 2 }) {
+		buffer0.startSegment(root, root);
+		recordRoot(buffer0, root);
+	}
+	for (uint64_t root : { 1, 4 }) {
+		buffer1.startSegment(root, root);
+		recordRoot(buffer1, root);
+	}
+	ASSERT_NO_THROW(ArchiveRecordingBuffer::merge({ &buffer1, &buffer0 }, archive)) << "Merging ArchiveRecordingBuffer failed.";
+	ASSERT_EQ(buffer0.getNbBufferedRecordings(), 0) << "Merged ArchiveRecordingBuffer should be cleared.";
+
+	// Compare archives
+	ASSERT_EQ(archive.getNbRecordings(), referenceArchive.getNbRecordings()) << "Merged archive differs from the reference.";
+	ASSERT_EQ(archive.getNbDataHandlers(), referenceArchive.getNbDataHandlers()) << "Merged archive differs from the reference.";
+	for (uint64_t idx = 0; idx < archive.getNbRecordings(); idx++) {
+		ASSERT_EQ(archive.at(idx).prog, referenceArchive.at(idx).prog) << "Merged archive differs from the reference.";
+		ASSERT_EQ(archive.at(idx).dataHash, referenceArchive.at(idx).dataHash) << "Merged archive differs from the reference.";
+		ASSERT_EQ(archive.at(idx).result, referenceArchive.at(idx).result) << "Merged archive differs from the reference.";
+		ASSERT_EQ(Archive::getCombinedHash(archive.getDataHandlers().at(archive.at(idx).dataHash)), archive.at(idx).dataHash) << "Copy of DataHandler in the merged archive is incorrect.";
+	}
+}
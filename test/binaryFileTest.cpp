@@ -0,0 +1,207 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2020) :
+ *
+ * Karol Desnos <kdesnos@insa-rennes.fr> (2020)
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <unordered_map>
+
+#include "data/dataHandler.h"
+#include "data/primitiveTypeArray.h"
+#include "instructions/addPrimitiveType.h"
+#include "instructions/multByConstParam.h"
+#include "mutator/rng.h"
+#include "mutator/tpgMutator.h"
+#include "program/program.h"
+#include "program/line.h"
+#include "tpg/tpgAction.h"
+#include "tpg/tpgEdge.h"
+#include "tpg/tpgGraph.h"
+
+#include "program/packedLines.h"
+#include "file/tpgGraphBinaryExporter.h"
+#include "file/tpgGraphBinaryImporter.h"
+
+class BinaryFileTest : public ::testing::Test {
+protected:
+	const size_t size1{ 24 };
+	std::vector<std::reference_wrapper<const Data::DataHandler>> vect;
+	Instructions::Set set;
+	Environment* e = NULL;
+	TPG::TPGGraph* tpg = NULL;
+
+	virtual void SetUp() {
+		vect.push_back(*(new Data::PrimitiveTypeArray<double>((unsigned int)size1)));
+
+		set.add(*(new Instructions::AddPrimitiveType<double>()));
+		set.add(*(new Instructions::MultByConstParam<double, float>()));
+		e = new Environment(set, vect, 8);
+		tpg = new TPG::TPGGraph(*e);
+
+		// Random TPG with shared programs and mutated edges.
+		Mutator::RNG rng;
+		rng.setSeed(0);
+		Mutator::MutationParameters params;
+		params.tpg.nbActions = 4;
+		params.tpg.maxInitOutgoingEdges = 3;
+		params.prog.maxProgramSize = 20;
+		params.tpg.nbRoots = 10;
+		params.tpg.pEdgeDeletion = 0.7;
+		params.tpg.pEdgeAddition = 0.7;
+		params.tpg.pProgramMutation = 0.2;
+		params.tpg.pEdgeDestinationChange = 0.1;
+		params.tpg.pEdgeDestinationIsAction = 0.5;
+		params.prog.pAdd = 0.5;
+		params.prog.pDelete = 0.5;
+		params.prog.pMutate = 1.0;
+		params.prog.pSwap = 1.0;
+		Archive arch;
+		Mutator::TPGMutator::initRandomTPG(*tpg, params, rng);
+		Mutator::TPGMutator::populateTPG(*tpg, arch, params, rng, 1);
+	}
+
+	virtual void TearDown() {
+		// Remove files written by the tests.
+		std::remove("exported_tpg.bin");
+		std::remove("truncated_tpg.bin");
+		std::remove("text_tpg.bin");
+
+		delete tpg;
+		delete e;
+		delete (&(vect.at(0).get()));
+		delete (&set.getInstruction(0));
+		delete (&set.getInstruction(1));
+	}
+};
+
+TEST_F(BinaryFileTest, ExporterConstructor) {
+	File::TPGGraphBinaryExporter* exporter;
+	ASSERT_NO_THROW(exporter = new File::TPGGraphBinaryExporter("exported_tpg.bin", *tpg)) << "The TPGGraphBinaryExporter could not be constructed with a valid file path.";
+	ASSERT_NO_THROW(delete exporter) << "TPGGraphBinaryExporter could not be deleted.";
+	ASSERT_THROW(exporter = new File::TPGGraphBinaryExporter("XXX://INVALID_PATH", *tpg), std::runtime_error) << "The TPGGraphBinaryExporter construction should fail with an invalid path.";
+}
+
+TEST_F(BinaryFileTest, ExportImport) {
+	File::TPGGraphBinaryExporter exporter("exported_tpg.bin", *tpg);
+	ASSERT_NO_THROW(exporter.print()) << "Export of a TPGGraph in binary failed.";
+
+	TPG::TPGGraph tpgCopy(*e);
+	ASSERT_NO_THROW(File::TPGGraphBinaryImporter importer("exported_tpg.bin", tpgCopy)) << "Import of a TPGGraph from binary failed.";
+	ASSERT_THROW(File::TPGGraphBinaryImporter importer("XXX://INVALID_PATH", tpgCopy), std::runtime_error) << "The TPGGraphBinaryImporter construction should fail with an invalid path.";
+	File::TPGGraphBinaryImporter importer("exported_tpg.bin", tpgCopy);
+
+	// Compare vertices
+	auto vertices = tpg->getVertices();
+	auto verticesCopy = tpgCopy.getVertices();
+	ASSERT_EQ(verticesCopy.size(), vertices.size()) << "Number of imported vertices is incorrect.";
+	std::unordered_map<const TPG::TPGVertex*, const TPG::TPGVertex*> vertexCopies;
+	for (size_t i = 0; i < vertices.size(); i++) {
+		ASSERT_EQ(typeid(*verticesCopy.at(i)), typeid(*vertices.at(i))) << "Type of imported vertex is incorrect.";
+		if (typeid(*vertices.at(i)) == typeid(TPG::TPGAction)) {
+			ASSERT_EQ(((const TPG::TPGAction*)verticesCopy.at(i))->getActionID(), ((const TPG::TPGAction*)vertices.at(i))->getActionID()) << "Action ID of imported action is incorrect.";
+		}
+		vertexCopies.emplace(vertices.at(i), verticesCopy.at(i));
+	}
+	ASSERT_EQ(tpgCopy.getNbRootVertices(), tpg->getNbRootVertices()) << "Number of imported roots is incorrect.";
+
+	// Compare edges and programs
+	ASSERT_EQ(tpgCopy.getEdges().size(), tpg->getEdges().size()) << "Number of imported edges is incorrect.";
+	std::unordered_map<const Program::Program*, const Program::Program*> programCopies;
+	auto iterCopy = tpgCopy.getEdges().begin();
+	for (const TPG::TPGEdge& edge : tpg->getEdges()) {
+		ASSERT_EQ(iterCopy->getSource(), vertexCopies.at(edge.getSource())) << "Source of imported edge is incorrect.";
+		ASSERT_EQ(iterCopy->getDestination(), vertexCopies.at(edge.getDestination())) << "Destination of imported edge is incorrect.";
+		// Shared programs remain shared
+		auto inserted = programCopies.emplace(&edge.getProgram(), &iterCopy->getProgram());
+		ASSERT_EQ(inserted.first->second, &iterCopy->getProgram()) << "Sharing of imported programs is incorrect.";
+
+		const Program::Program& prog = edge.getProgram();
+		const Program::Program& progCopy = iterCopy->getProgram();
+		ASSERT_EQ(progCopy.getNbLines(), prog.getNbLines()) << "Number of lines of imported program is incorrect.";
+		for (uint64_t l = 0; l < prog.getNbLines(); l++) {
+			const Program::Line& line = prog.getLine(l);
+			const Program::Line& lineCopy = progCopy.getLine(l);
+			ASSERT_EQ(lineCopy.getInstructionIndex(), line.getInstructionIndex()) << "Instruction of imported line is incorrect.";
+			ASSERT_EQ(lineCopy.getDestinationIndex(), line.getDestinationIndex()) << "Destination of imported line is incorrect.";
+			for (uint64_t i = 0; i < e->getMaxNbOperands(); i++) {
+				ASSERT_EQ(lineCopy.getOperand(i), line.getOperand(i)) << "Operand of imported line is incorrect.";
+			}
+			for (uint64_t i = 0; i < e->getMaxNbParameters(); i++) {
+				ASSERT_EQ(lineCopy.getParameter(i).i, line.getParameter(i).i) << "Parameter of imported line is incorrect.";
+			}
+			ASSERT_EQ(progCopy.isIntron(l), prog.isIntron(l)) << "Intron status of imported line is incorrect.";
+		}
+		iterCopy++;
+	}
+
+	// Lines are stored as PackedLines
+	size_t nbExpectedWords = 2 + 7 + 3 + tpg->getNbVertices() + 3 * tpg->getEdges().size();
+	for (auto& program : programCopies) {
+		nbExpectedWords += 2 + Program::PackedLines(*program.first).getNbWords();
+	}
+	std::ifstream exported("exported_tpg.bin", std::ios::binary | std::ios::ate);
+	ASSERT_EQ((size_t)exported.tellg(), nbExpectedWords * sizeof(uint64_t)) << "Size of the binary file is incorrect.";
+	exported.close();
+
+	// Import again in the same graph.
+	ASSERT_NO_THROW(importer.importGraph()) << "Second import of the binary file failed.";
+	ASSERT_EQ(tpgCopy.getNbVertices(), tpg->getNbVertices()) << "The TPGGraph should be cleared before import.";
+}
+
+TEST_F(BinaryFileTest, ImportInvalidContent) {
+	File::TPGGraphBinaryExporter exporter("exported_tpg.bin", *tpg);
+	exporter.print();
+
+	// Environment with a different LineSize
+	Environment otherEnv(set, vect, 16);
+	TPG::TPGGraph otherTPG(otherEnv);
+	ASSERT_THROW(File::TPGGraphBinaryImporter importer("exported_tpg.bin", otherTPG), std::runtime_error) << "Import in an Environment with a different LineSize should fail.";
+
+	// Truncated file
+	std::ifstream input("exported_tpg.bin", std::ios::binary);
+	std::vector<char> content((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+	input.close();
+	std::ofstream truncated("truncated_tpg.bin", std::ios::binary);
+	truncated.write(content.data(), content.size() - sizeof(uint64_t));
+	truncated.close();
+	TPG::TPGGraph tpgCopy(*e);
+	ASSERT_THROW(File::TPGGraphBinaryImporter importer("truncated_tpg.bin", tpgCopy), std::runtime_error) << "Import of a truncated file should fail.";
+
+	// Not a binary TPGGraph
+	std::ofstream text("text_tpg.bin", std::ios::binary);
+	text << "digraph{}\n";
+	text.close();
+	ASSERT_THROW(File::TPGGraphBinaryImporter importer("text_tpg.bin", tpgCopy), std::runtime_error) << "Import of a file which is not a binary TPGGraph should fail.";
+}
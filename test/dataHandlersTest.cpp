@@ -34,6 +34,8 @@
  */
 
 #include <gtest/gtest.h>
+#include <thread>
+#include <vector>
 
 #include "data/dataHandler.h"
 #include "data/primitiveTypeArray.h"
@@ -86,6 +88,55 @@ TEST(DataHandlersTest, PrimitiveDataArrayAddressSpaceArray) {
 	delete d;
 }
 
+TEST(DataHandlersTest, PrimitiveDataArrayAddressSpaceArrayCached) {
+	// Address space for an array type must depend on the PrimitiveTypeArray
+	// size, even if the type was already encountered by another instance.
+	Data::PrimitiveTypeArray<int> d0(10);
+	Data::PrimitiveTypeArray<int> d1(4);
+	ASSERT_EQ(d0.getAddressSpace(typeid(int[3])), 8) << "Address space size for type int[3] in PrimitiveTypeArray<int>(10) is not 8";
+	ASSERT_EQ(d0.getAddressSpace(typeid(int[3])), 8) << "Address space size for type int[3] in PrimitiveTypeArray<int>(10) changed for a second call.";
+	ASSERT_EQ(d1.getAddressSpace(typeid(int[3])), 2) << "Address space size for type int[3] in PrimitiveTypeArray<int>(4) is not 2";
+	ASSERT_EQ(d1.getAddressSpace(typeid(int[5])), 0) << "Address space size for type int[5] in PrimitiveTypeArray<int>(4) is not 0";
+	ASSERT_EQ(d0.getAddressSpace(typeid(int[5])), 6) << "Address space size for type int[5] in PrimitiveTypeArray<int>(10) is not 6";
+	ASSERT_EQ(d0.getAddressSpace(typeid(long[3])), 0) << "Address space size for type long[3] in PrimitiveTypeArray<int>(10) is not 0";
+	ASSERT_EQ(d0.getAddressSpace(typeid(long[3])), 0) << "Address space size for type long[3] in PrimitiveTypeArray<int>(10) changed for a second call.";
+}
+
+TEST(DataHandlersTest, PrimitiveDataArrayAddressSpaceArrayCachedClone) {
+	Data::PrimitiveTypeArray<int> d0(10);
+	ASSERT_EQ(d0.getAddressSpace(typeid(int[3])), 8) << "Address space size for type int[3] in PrimitiveTypeArray<int>(10) is not 8";
+	ASSERT_EQ(d0.getAddressSpace(typeid(long[3])), 0) << "Address space size for type long[3] in PrimitiveTypeArray<int>(10) is not 0";
+
+	// Identified types are copied with the PrimitiveTypeArray.
+	Data::DataHandler* d1 = d0.clone();
+	ASSERT_EQ(d1->getAddressSpace(typeid(int[3])), 8) << "Address space size for type int[3] in a clone of PrimitiveTypeArray<int>(10) is not 8";
+	ASSERT_EQ(d1->getAddressSpace(typeid(long[3])), 0) << "Address space size for type long[3] in a clone of PrimitiveTypeArray<int>(10) is not 0";
+	ASSERT_EQ(d1->getAddressSpace(typeid(int[4])), 7) << "Address space size for type int[4] in a clone of PrimitiveTypeArray<int>(10) is not 7";
+	delete d1;
+}
+
+TEST(DataHandlersTest, PrimitiveDataArrayAddressSpaceArrayConcurrent) {
+	// Types are identified concurrently by several threads.
+	Data::PrimitiveTypeArray<int> d(10);
+	std::vector<std::thread> threads;
+	std::vector<size_t> results(8);
+	for (size_t i = 0; i < results.size(); i++) {
+		threads.emplace_back([&d, &results, i]() {
+			size_t result = 0;
+			for (int j = 0; j < 100; j++) {
+				result += d.getAddressSpace(typeid(int[2])) + d.getAddressSpace(typeid(int[3])) + d.getAddressSpace(typeid(int[5]));
+			}
+			results[i] = result;
+			});
+	}
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+	for (size_t result : results) {
+		ASSERT_EQ(result, 100 * (9 + 8 + 6)) << "Address spaces computed concurrently are incorrect.";
+	}
+}
+
 TEST(DataHandlersTest, PrimitiveDataArrayLargestAddressSpace) {
 	Data::DataHandler* d = new Data::PrimitiveTypeArray<float>(20); // Array of 20 float
 	ASSERT_EQ(d->getLargestAddressSpace(), 20) << "Largest address space size for type in PrimitiveTypeArray<float>(20) is not 20 as expected.";
@@ -137,6 +188,11 @@ TEST(DataHandlersTest, PrimitiveDataArrayGetDataAtArray) {
 		}
 	}
 
+	// Arrays are not copied: overlapping arrays point to the same memory.
+	const int* a0 = d->getDataAt(typeid(int[sizeArray]), 0).getSharedPointer<const int[]>().get();
+	const int* a1 = d->getDataAt(typeid(int[sizeArray]), 1).getSharedPointer<const int[]>().get();
+	ASSERT_EQ(a0 + 1, a1) << "Data retrieved as arrays should not be copied.";
+
 	ASSERT_THROW(d->getDataAt(typeid(int[sizeArray]), size - 1), std::out_of_range) << "Address exceeding the addressSpace should cause an exception.";
 	ASSERT_THROW(d->getDataAt(typeid(long[sizeArray]), 0), std::invalid_argument) << "Requesting a non-handled type, even at a valid location, should cause /an /exception.";
 
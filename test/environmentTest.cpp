@@ -41,6 +41,7 @@
 #include "instructions/set.h"
 #include "instructions/addPrimitiveType.h"
 #include "instructions/multByConstParam.h"
+#include "instructions/lambdaInstruction.h"
 #include "environment.h"
 
 TEST(EnvironmentTest, Constructor) {
@@ -227,3 +228,28 @@ TEST(EnvironmentTest, DataSourceAccessor) {
 		ASSERT_EQ(&dataSourcesCpy.at(i).get(), &vect.at(i).get()) << "Instruction referenced in the copied Set should be identical to the ones referenced in the Set given at construction.";
 	}
 }
+
+TEST(EnvironmentTest, RegistersAccess) {
+	std::vector<std::reference_wrapper<const Data::DataHandler>> vect;
+	Instructions::Set set;
+
+	Data::PrimitiveTypeArray<int> d1(24);
+
+	Instructions::AddPrimitiveType<int> iAddInt; // Registers can not provide int operands
+	Instructions::AddPrimitiveType<double> iAdd;
+	Instructions::LambdaInstruction<const double[3]> iArray([](const double a[3]) {return a[0] + a[1] + a[2]; });
+
+	set.add(iAddInt);
+	set.add(iAdd);
+	set.add(iArray);
+
+	vect.push_back(d1);
+
+	Environment e(set, vect, 8);
+
+	ASSERT_EQ(e.getRegistersAccess(0, 1), (std::pair<size_t, size_t>(0, 0))) << "Registers should not be accessible for an int operand.";
+	ASSERT_EQ(e.getRegistersAccess(1, 0), (std::pair<size_t, size_t>(8, 1))) << "A double operand should access one of the 8 registers.";
+	ASSERT_EQ(e.getRegistersAccess(2, 0), (std::pair<size_t, size_t>(6, 3))) << "A double[3] operand should access 3 consecutive registers, from 6 possible positions.";
+	ASSERT_THROW(e.getRegistersAccess(2, 2), std::out_of_range) << "Accessing a non-existing operand should fail.";
+	ASSERT_THROW(e.getRegistersAccess(3, 0), std::out_of_range) << "Accessing a non-existing Instruction should fail.";
+}
@@ -51,6 +51,8 @@
 #include "tpg/tpgGraph.h"
 
 #include "file/tpgGraphDotExporter.h"
+#include "file/tpgGraphDotImporter.h"
+#include "file/tpgGraphCheckpointer.h"
 
 
 class ExporterTest : public ::testing::Test {
@@ -164,3 +166,40 @@ TEST_F(ExporterTest, print) {
 
 	ASSERT_NO_THROW(dotExporter.print()) << "File export was executed without error.";
 }
+
+TEST_F(ExporterTest, printToString) {
+	File::TPGGraphDotExporter dotExporter("exported_tpg.dot", *tpg);
+	ASSERT_NO_THROW(dotExporter.print()) << "File export was executed without error.";
+
+	std::ifstream file("exported_tpg.dot");
+	std::string fileContent((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+	File::TPGGraphDotExporter stringExporter(*tpg);
+	ASSERT_EQ(stringExporter.printToString(), fileContent) << "String export differs from the file export.";
+	ASSERT_THROW(stringExporter.print(), std::runtime_error) << "File export should fail for an exporter built without file.";
+}
+
+TEST_F(ExporterTest, Checkpointer) {
+	File::TPGGraphCheckpointer checkpointer("checkpoint_tpg.dot");
+	ASSERT_EQ(checkpointer.getNbCheckpoints(), 0) << "No checkpoint should be saved at construction.";
+
+	uint64_t nbVertices = tpg->getNbVertices();
+	uint64_t nbEdges = tpg->getEdges().size();
+	ASSERT_NO_THROW(checkpointer.checkpoint(*tpg)) << "Checkpointing a TPGGraph failed.";
+
+	// Modify the TPGGraph while it is exported.
+	tpg->clear();
+
+	ASSERT_NO_THROW(checkpointer.wait()) << "Exporting the checkpoint failed.";
+	ASSERT_EQ(checkpointer.getNbCheckpoints(), 1) << "Incorrect number of checkpoints.";
+
+	TPG::TPGGraph importedGraph(*e);
+	File::TPGGraphDotImporter importer("checkpoint_tpg.dot", *e, importedGraph);
+	ASSERT_NO_THROW(importer.importGraph()) << "Checkpoint file could not be imported.";
+	ASSERT_EQ(importedGraph.getNbVertices(), nbVertices) << "Checkpoint does not contain the TPGGraph state at checkpoint time.";
+	ASSERT_EQ(importedGraph.getEdges().size(), nbEdges) << "Checkpoint does not contain the TPGGraph state at checkpoint time.";
+
+	File::TPGGraphCheckpointer invalidCheckpointer("XXX://INVALID_PATH");
+	ASSERT_NO_THROW(invalidCheckpointer.checkpoint(importedGraph)) << "Checkpoint should return before the export.";
+	ASSERT_THROW(invalidCheckpointer.wait(), std::runtime_error) << "Export failure should be reported by wait().";
+}
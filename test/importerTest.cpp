@@ -37,6 +37,8 @@
 #include <gtest/gtest.h>
 #include <iostream>
 #include <fstream>
+#include <cstdio>
+#include <string>
 
 #include "data/dataHandler.h"
 #include "data/primitiveTypeArray.h"
@@ -247,6 +249,71 @@ TEST_F(ImporterTest, importGraph)
 	ASSERT_EQ(p.getLine(2).getOperand(0).second,1) << "The second part of the operand changed";
 }
 
+TEST_F(ImporterTest, importGraphNegativeParametersAndCRLF)
+{
+	// Negative parameter in the program shared by T0->A0 and T1->A0
+	progPointers.at(0)->getLine(0).setParameter(0, (int16_t)-16384);
+	File::TPGGraphDotExporter exporter("exported_tpg3.dot", *tpg);
+	exporter.print();
+
+	File::TPGGraphDotImporter dotImporter("exported_tpg3.dot", *e, *tpg_copy);
+	ASSERT_EQ(tpg_copy->getNbVertices(), tpg->getNbVertices()) << "the wrong number of vertices have been created.";
+	ASSERT_EQ(tpg_copy->getEdges().size(), tpg->getEdges().size()) << "the wrong number of edges have been created.";
+	const Program::Program& p = tpg_copy->getEdges().front().getProgram();
+	ASSERT_EQ(p.getNbLines(), 3) << "The number of lines of the copied program dismatch";
+	ASSERT_NEAR((float)(p.getLine(0).getParameter(0)), -0.5f, 0.0001) << "The negative parameter changed";
+
+	// Same file with CRLF line endings
+	std::ifstream input("exported_tpg3.dot");
+	std::ofstream output("exported_tpg3_crlf.dot", std::ios::binary);
+	std::string line;
+	while (std::getline(input, line)) {
+		output << line << "\r\n";
+	}
+	input.close();
+	output.close();
+	ASSERT_NO_THROW(dotImporter.setNewFilePath("exported_tpg3_crlf.dot"));
+	ASSERT_NO_THROW(dotImporter.importGraph()) << "The Graph import failed with CRLF line endings.";
+	ASSERT_EQ(tpg_copy->getNbVertices(), tpg->getNbVertices()) << "the wrong number of vertices have been created with CRLF line endings.";
+	ASSERT_EQ(tpg_copy->getEdges().size(), tpg->getEdges().size()) << "the wrong number of edges have been created with CRLF line endings.";
+}
+
+TEST_F(ImporterTest, importGraphInvalidNumbers)
+{
+	progPointers.at(0)->getLine(0).setParameter(0, (int16_t)-16384);
+	File::TPGGraphDotExporter exporter("exported_tpg4.dot", *tpg);
+	exporter.print();
+	std::ifstream input("exported_tpg4.dot");
+	std::string content((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+	input.close();
+
+	// Write the exported file with a modified first Program line.
+	auto writeModified = [&content](const std::string& oldText, const std::string& newText) {
+		std::string modified = content;
+		size_t pos = modified.find(oldText);
+		modified.replace(pos, oldText.size(), newText);
+		std::ofstream output("invalid_tpg.dot");
+		output << modified;
+	};
+	const std::string firstLine = "0|1&-16384|$0|1#0|0&#92;n";
+	ASSERT_NE(content.find(firstLine), std::string::npos) << "Exported Program line has an unexpected format.";
+
+	// Parameter out of the range of int16_t
+	writeModified(firstLine, "0|1&-40000|$0|1#0|0&#92;n");
+	ASSERT_THROW(File::TPGGraphDotImporter("invalid_tpg.dot", *e, *tpg_copy), std::out_of_range) << "Importing a parameter out of the range of int16_t should fail.";
+
+	// Number out of the range of uint64_t
+	writeModified(firstLine, "0|1&-16384|$0|1#0|99999999999999999999&#92;n");
+	ASSERT_THROW(File::TPGGraphDotImporter("invalid_tpg.dot", *e, *tpg_copy), std::out_of_range) << "Importing a number out of the range of uint64_t should fail.";
+
+	// Missing line separator
+	writeModified(firstLine, "0|1&-16384|$0|1#0|0 0|1&6554|$0|1#0|0&#92;n");
+	ASSERT_THROW(File::TPGGraphDotImporter("invalid_tpg.dot", *e, *tpg_copy), std::invalid_argument) << "Importing a Program line followed by unexpected characters should fail.";
+
+	std::remove("exported_tpg4.dot");
+	std::remove("invalid_tpg.dot");
+}
+
 TEST_F(ImporterTest, readLineFromFile) {
 	std::ofstream myfile;
 	File::TPGGraphDotImporter* dotImporter;
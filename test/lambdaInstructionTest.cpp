@@ -125,3 +125,46 @@ TEST(LambdaInstructionsTest, ExecuteAllTypesMixed) {
 	vect2.emplace_back(&c, Data::UntypedSharedPtr::emptyDestructor<int>());
 	ASSERT_EQ(instruction2.execute({}, vect2), 0.0) << "Result of the LambdaInstruction with wrong argument types should be 0.";
 }
+
+TEST(LambdaInstructionsTest, Kernel) {
+	double a{ 1.0 };
+	double b[2]{ 1.5, 2.0 };
+	int c = 2;
+	const void* operands[3]{ &a, b, &c };
+
+	// Lambda without capture: kernel calls the raw function pointer.
+	Instructions::LambdaInstruction<double, const double[2], int> instruction1([](double d, const double e[2], int i) {return (d + e[0] + e[1]) * i; });
+	Instructions::Instruction::Kernel kernel1;
+	ASSERT_NO_THROW(kernel1 = instruction1.getKernel()) << "Getting the kernel of a LambdaInstruction failed unexpectedly.";
+	ASSERT_NE(kernel1, nullptr) << "LambdaInstruction should have a kernel.";
+	ASSERT_EQ(kernel1(instruction1, operands, nullptr), 9.0) << "Result of the kernel of a LambdaInstruction is incorrect.";
+
+	// Lambda with capture: kernel calls the std::function.
+	double factor = 0.5;
+	Instructions::LambdaInstruction<double, const double[2], int> instruction2([factor](double d, const double e[2], int i) {return (d + e[0] + e[1]) * i * factor; });
+	Instructions::Instruction::Kernel kernel2 = instruction2.getKernel();
+	ASSERT_NE(kernel2, nullptr) << "LambdaInstruction with a capturing lambda should have a kernel.";
+	ASSERT_NE(kernel2, kernel1) << "LambdaInstruction with a capturing lambda should not use the raw function pointer kernel.";
+	ASSERT_EQ(kernel2(instruction2, operands, nullptr), 4.5) << "Result of the kernel of a LambdaInstruction with a capturing lambda is incorrect.";
+
+	// Result of the kernel is the same as the result of execute
+	std::vector<Data::UntypedSharedPtr> vect;
+	vect.push_back(Data::UntypedSharedPtr::createView<double>(&a));
+	vect.push_back(Data::UntypedSharedPtr::createView<double[]>(b));
+	vect.push_back(Data::UntypedSharedPtr::createView<int>(&c));
+	ASSERT_EQ(instruction1.execute({}, vect), kernel1(instruction1, operands, nullptr)) << "Result of the kernel differs from the result of the execute method.";
+
+	// Derived classes, which may override execute(), have no kernel.
+	class DerivedLambdaInstruction : public Instructions::LambdaInstruction<double, const double[2], int> {
+	public:
+		DerivedLambdaInstruction() : LambdaInstruction([](double d, const double e[2], int i) {return (d + e[0] + e[1]) * i; }) {};
+		double execute(const std::vector<std::reference_wrapper<const Parameter>>& params, const std::vector<Data::UntypedSharedPtr>& args) const override {
+			return -LambdaInstruction::execute(params, args);
+		};
+	} instruction4;
+	ASSERT_EQ(instruction4.getKernel(), nullptr) << "Class derived from LambdaInstruction should have no kernel by default.";
+
+	// Other instructions have no kernel by default.
+	Instructions::AddPrimitiveType<double> instruction3;
+	ASSERT_EQ(instruction3.getKernel(), nullptr) << "Instruction should have no kernel by default.";
+}
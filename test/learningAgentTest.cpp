@@ -36,8 +36,13 @@
 
 #include <gtest/gtest.h>
 #include <numeric>
+#include <algorithm>
+#include <set>
+#include <fstream>
+#include <cstdio>
 
 #include "tpg/tpgGraph.h"
+#include "file/tpgGraphDotImporter.h"
 
 #include "mutator/rng.h"
 #include "mutator/tpgMutator.h"
@@ -83,6 +88,29 @@ protected:
 
 class ParallelLearningAgentTest : public LearningAgentTest {};
 
+/**
+* StickGameWithOpponent keeping track of its living clones.
+*/
+class CloneTrackingStickGame : public StickGameWithOpponent {
+public:
+	/// Living clones, shared between the original and its clones.
+	std::shared_ptr<std::set<const Learn::LearningEnvironment*>> clones = std::make_shared<std::set<const Learn::LearningEnvironment*>>();
+
+	/// Total number of clones created.
+	std::shared_ptr<uint64_t> nbClones = std::make_shared<uint64_t>(0);
+
+	Learn::LearningEnvironment* clone() const override {
+		CloneTrackingStickGame* copy = new CloneTrackingStickGame(*this);
+		this->clones->insert(copy);
+		(*this->nbClones)++;
+		return copy;
+	}
+
+	~CloneTrackingStickGame() {
+		this->clones->erase(this);
+	}
+};
+
 TEST_F(LearningAgentTest, Constructor) {
 	Learn::LearningAgent* la;
 
@@ -161,6 +189,35 @@ TEST_F(LearningAgentTest, EvalAllRoots) {
 	ASSERT_EQ(result.size(), la.getTPGGraph().getNbRootVertices()) << "Number of evaluated roots is under the number of roots from the TPGGraph.";
 }
 
+TEST_F(LearningAgentTest, EvalAllRootsBidCache) {
+	params.archiveSize = 50;
+	params.archivingProbability = 0.5;
+	params.maxNbActionsPerEval = 11;
+	params.nbIterationsPerPolicyEvaluation = 10;
+
+	Learn::LearningAgent la(le, set, params);
+	params.bidCacheSize = 1000;
+	Learn::LearningAgent laCache(le, set, params);
+
+	la.init();
+	laCache.init();
+	std::multimap<std::shared_ptr<Learn::EvaluationResult>, const TPG::TPGVertex*> result;
+	std::multimap<std::shared_ptr<Learn::EvaluationResult>, const TPG::TPGVertex*> resultCache;
+	ASSERT_NO_THROW(result = la.evaluateAllRoots(0, Learn::LearningMode::TRAINING)) << "Evaluation from a root failed.";
+	ASSERT_NO_THROW(resultCache = laCache.evaluateAllRoots(0, Learn::LearningMode::TRAINING)) << "Evaluation from a root failed with an active bid cache.";
+
+	// Memoization of bids must not change the results.
+	ASSERT_EQ(result.size(), resultCache.size()) << "Number of evaluated roots differs with an active bid cache.";
+	auto iter = result.begin();
+	auto iterCache = resultCache.begin();
+	while (iter != result.end()) {
+		ASSERT_EQ(iter->first->getResult(), iterCache->first->getResult()) << "Evaluation results differ with an active bid cache.";
+		iter++;
+		iterCache++;
+	}
+	ASSERT_EQ(la.getArchive().getNbRecordings(), laCache.getArchive().getNbRecordings()) << "Archive content differs with an active bid cache.";
+}
+
 TEST_F(LearningAgentTest, GetArchive) {
 	params.archiveSize = 50;
 	params.archivingProbability = 0.5;
@@ -306,6 +363,80 @@ TEST_F(LearningAgentTest, Train) {
 	ASSERT_NO_THROW(la.train(alt, true)) << "Using the boolean reference to stop the training should not fail.";
 }
 
+TEST_F(LearningAgentTest, TrainWithCheckpoint) {
+	params.archiveSize = 50;
+	params.archivingProbability = 0.5;
+	params.maxNbActionsPerEval = 11;
+	params.nbIterationsPerPolicyEvaluation = 5;
+	params.ratioDeletedRoots = 0.2;
+	params.nbGenerations = 3;
+
+	// Remove checkpoint of a previous run, if any.
+	std::remove("checkpoint_train.dot");
+
+	Learn::LearningAgent la(le, set, params);
+	ASSERT_NO_THROW(la.setCheckpoint("checkpoint_train.dot", 3)) << "Setting the checkpoint should not fail.";
+
+	la.init();
+	bool alt = false;
+	ASSERT_NO_THROW(la.train(alt, false)) << "Training a TPG with checkpoints should not fail.";
+
+	// The last checkpoint is the TPGGraph at the end of the training.
+	std::ifstream file("checkpoint_train.dot");
+	ASSERT_TRUE(file.good()) << "Checkpoint file was not written during training.";
+	file.close();
+	TPG::TPGGraph importedGraph(la.getTPGGraph().getEnvironment());
+	File::TPGGraphDotImporter importer("checkpoint_train.dot", la.getTPGGraph().getEnvironment(), importedGraph);
+	ASSERT_NO_THROW(importer.importGraph()) << "Checkpoint file could not be imported.";
+	ASSERT_EQ(importedGraph.getNbVertices(), la.getTPGGraph().getNbVertices()) << "Checkpoint does not contain the TPGGraph at checkpoint time.";
+	ASSERT_EQ(importedGraph.getEdges().size(), la.getTPGGraph().getEdges().size()) << "Checkpoint does not contain the TPGGraph at checkpoint time.";
+}
+
+TEST_F(LearningAgentTest, TrainWithProgramDeduplication) {
+	params.archiveSize = 50;
+	params.archivingProbability = 0.5;
+	params.maxNbActionsPerEval = 11;
+	params.nbIterationsPerPolicyEvaluation = 5;
+	params.ratioDeletedRoots = 0.2;
+	params.nbGenerations = 20;
+	params.mutation.tpg.nbRoots = 30;
+	params.maxNbEvaluationPerPolicy = params.nbIterationsPerPolicyEvaluation * 3;
+
+	// Count the distinct Programs and effective codes of a TPGGraph.
+	auto countPrograms = [](TPG::TPGGraph& tpg, uint64_t& nbPrograms, uint64_t& nbEffectiveCodes) {
+		std::set<const Program::Program*> programs;
+		std::set<std::vector<uint64_t>> effectiveCodes;
+		for (const TPG::TPGEdge& edge : tpg.getEdges()) {
+			edge.getProgram().updateIntrons();
+			programs.insert(&edge.getProgram());
+			effectiveCodes.insert(edge.getProgram().getEffectiveCode());
+		}
+		nbPrograms = programs.size();
+		nbEffectiveCodes = effectiveCodes.size();
+	};
+	uint64_t nbPrograms, nbEffectiveCodes;
+	bool alt = false;
+
+	// Without deduplication, some edges hold distinct but identical Programs.
+	Learn::LearningAgent la(le, set, params);
+	la.init();
+	la.train(alt, false);
+	countPrograms(la.getTPGGraph(), nbPrograms, nbEffectiveCodes);
+	ASSERT_EQ(la.getTPGGraph().getNbPrograms(), nbPrograms) << "Number of distinct Programs of the TPGGraph is incorrect.";
+	ASSERT_GT(nbPrograms, nbEffectiveCodes) << "Training without deduplication is expected to produce identical Programs.";
+	ASSERT_EQ(la.getTPGGraph().getNbDeduplicatedPrograms(), 0) << "No Program should be deduplicated when deduplication is disabled.";
+
+	// With deduplication, each effective code is held by a single Program.
+	Learn::LearningAgent laDedup(le, set, params);
+	laDedup.setProgramDeduplication(true);
+	laDedup.init();
+	ASSERT_NO_THROW(laDedup.train(alt, false)) << "Training a TPG with program deduplication should not fail.";
+	countPrograms(laDedup.getTPGGraph(), nbPrograms, nbEffectiveCodes);
+	ASSERT_EQ(nbPrograms, nbEffectiveCodes) << "Programs with identical effective code should be shared after training with deduplication.";
+	ASSERT_GT(laDedup.getTPGGraph().getNbDeduplicatedPrograms(), 0) << "Programs should have been deduplicated during training.";
+	ASSERT_EQ(laDedup.getTPGGraph().internPrograms(), 0) << "Programs should already be interned at the end of the training.";
+}
+
 // Similat to previous test, but verifications of graphs properties are here to
 // ensure the result of the training is identical on all OSes and Compilers.
 TEST_F(LearningAgentTest, TrainPortability) {
@@ -429,6 +560,50 @@ TEST_F(ParallelLearningAgentTest, EvalAllRootsParallel) {
 	ASSERT_EQ(result.size(), pla.getTPGGraph().getNbRootVertices()) << "Number of evaluated roots is under the number of roots from the TPGGraph.";
 }
 
+TEST_F(ParallelLearningAgentTest, EvalAllRootsParallelEvaluationContexts) {
+	params.archiveSize = 50;
+	params.archivingProbability = 0.5;
+	params.maxNbActionsPerEval = 11;
+	params.nbIterationsPerPolicyEvaluation = 10;
+	params.nbThreads = 4;
+	params.bidCacheSize = 100;
+
+	CloneTrackingStickGame trackedLe;
+	Learn::ParallelLearningAgent pla(trackedLe, set, params);
+
+	pla.init();
+	std::multimap<std::shared_ptr<Learn::EvaluationResult>, const TPG::TPGVertex*> result;
+	ASSERT_NO_THROW(result = pla.evaluateAllRoots(0, Learn::LearningMode::TRAINING)) << "Evaluation with evaluation contexts failed.";
+	ASSERT_EQ(result.size(), pla.getTPGGraph().getNbRootVertices()) << "Number of evaluated roots is under the number of roots from the TPGGraph.";
+	const std::set<const Learn::LearningEnvironment*> firstClones = *trackedLe.clones;
+	ASSERT_GT(firstClones.size(), 0) << "LearningEnvironment should be cloned for the evaluation contexts.";
+	ASSERT_LE(firstClones.size(), 4) << "LearningEnvironment should be cloned at most once per thread.";
+	ASSERT_EQ(*trackedLe.nbClones, firstClones.size()) << "Clones of the LearningEnvironment should be kept by the evaluation contexts.";
+
+	// Evaluation contexts of threads, and their clone of the
+	// LearningEnvironment, are reused between generations.
+	for (uint64_t generation = 1; generation < 3; generation++) {
+		ASSERT_NO_THROW(result = pla.evaluateAllRoots(generation, Learn::LearningMode::TRAINING)) << "Evaluation with reused evaluation contexts failed.";
+		ASSERT_EQ(result.size(), pla.getTPGGraph().getNbRootVertices()) << "Number of evaluated roots is under the number of roots from the TPGGraph.";
+	}
+	// (Threads without a root to evaluate in the first generation may
+	// create their context later.)
+	ASSERT_TRUE(std::includes(trackedLe.clones->begin(), trackedLe.clones->end(), firstClones.begin(), firstClones.end())) << "Clones of the LearningEnvironment should survive from one generation to the next.";
+	ASSERT_EQ(*trackedLe.nbClones, trackedLe.clones->size()) << "Clones of the LearningEnvironment should never be destroyed between generations.";
+	ASSERT_LE(trackedLe.clones->size(), 4) << "LearningEnvironment should be cloned at most once per thread.";
+
+	// Clearing the contexts drops their clones of the LearningEnvironment.
+	ASSERT_NO_THROW(pla.clearEvaluationContexts()) << "Clearing evaluation contexts failed.";
+	ASSERT_EQ(trackedLe.clones->size(), 0) << "Clones of the LearningEnvironment should be destroyed with the evaluation contexts.";
+
+	// And new ones are created for the next evaluation.
+	uint64_t nbClones = *trackedLe.nbClones;
+	ASSERT_NO_THROW(result = pla.evaluateAllRoots(3, Learn::LearningMode::VALIDATION)) << "Evaluation with cleared evaluation contexts failed.";
+	ASSERT_EQ(result.size(), pla.getTPGGraph().getNbRootVertices()) << "Number of evaluated roots is under the number of roots from the TPGGraph.";
+	ASSERT_GT(trackedLe.clones->size(), 0) << "Evaluation contexts should be recreated after being cleared.";
+	ASSERT_EQ(*trackedLe.nbClones, nbClones + trackedLe.clones->size()) << "Evaluation contexts should be recreated with new clones of the LearningEnvironment.";
+}
+
 TEST_F(ParallelLearningAgentTest, EvalAllRootsParallelTrainingDeterminism) {
 	// Check that parallel execution leads to the exact same results as 
 	// sequential
@@ -44,6 +44,7 @@
 #include "data/primitiveTypeArray.h"
 #include "program/program.h"
 #include "program/line.h"
+#include "program/packedLines.h"
 
 class LineTest : public ::testing::Test {
 protected:
@@ -171,3 +172,92 @@ TEST_F(LineTest, LineOperandAccessors) {
 	// There are only 2 operands
 	ASSERT_THROW(l.getOperand(2), std::range_error) << "Getting value of an incorrectly indexed operand did not fail.";
 }
+
+TEST_F(LineTest, PackedLinesLayout) {
+	Program::Program p(*e);
+	Program::PackedLines emptyLines(p);
+	ASSERT_EQ(emptyLines.getNbLines(), 0) << "PackedLines of an empty Program should contain no line.";
+	ASSERT_EQ(emptyLines.getNbWords(), 0) << "PackedLines of an empty Program should contain no word.";
+
+	// Three lines to have records crossing the 64-bit words boundaries.
+	for (int i = 0; i < 3; i++) {
+		Program::Line& l = p.addNewLine();
+		l.setInstructionIndex(1);
+		l.setDestinationIndex(7 - i);
+		l.setOperand(0, 2, 31 - i);
+		l.setOperand(1, 1, i);
+		l.setParameter(0, int16_t(-1 - i));
+	}
+
+	Program::PackedLines packedLines(p);
+	ASSERT_EQ(packedLines.getNbLines(), 3) << "Incorrect number of lines.";
+	ASSERT_EQ(packedLines.getNbWords(), (3 * e->getLineSize().totalNbBits + 63) / 64) << "Lines are not stored with the number of bits given by the LineSize.";
+	const uint64_t nbUsedBits = (3 * e->getLineSize().totalNbBits) % 64;
+	if (nbUsedBits != 0) {
+		ASSERT_EQ(packedLines.getWords()[packedLines.getNbWords() - 1] >> nbUsedBits, 0) << "Bits following the last line record are not 0.";
+	}
+
+	// Lines crossing words boundaries are unpacked correctly
+	Program::Program p2(*e);
+	ASSERT_TRUE(packedLines.unpack(p2, true)) << "Checked unpacking of valid lines failed.";
+	for (int i = 0; i < 3; i++) {
+		const Program::Line& l = p2.getLine(i);
+		ASSERT_EQ(l.getInstructionIndex(), 1) << "Unpacked instructionIndex differs from the packed one.";
+		ASSERT_EQ(l.getDestinationIndex(), 7 - i) << "Unpacked destinationIndex differs from the packed one.";
+		ASSERT_EQ(l.getOperand(0), (std::pair<uint64_t, uint64_t>(2, 31 - i))) << "Unpacked operand differs from the packed one.";
+		ASSERT_EQ(l.getOperand(1), (std::pair<uint64_t, uint64_t>(1, i))) << "Unpacked operand differs from the packed one.";
+		ASSERT_EQ((int16_t)l.getParameter(0), -1 - i) << "Unpacked parameter differs from the packed one.";
+	}
+}
+
+TEST_F(LineTest, PackedLinesPackUnpack) {
+	Program::Program p(*e);
+	for (int i = 0; i < 5; i++) {
+		Program::Line& l = p.addNewLine();
+		l.setInstructionIndex(i % 2);
+		l.setDestinationIndex(i);
+		l.setOperand(0, i % 3, 3 * i);
+		l.setOperand(1, 1, 31 - i);
+		l.setParameter(0, int16_t(1000 * i - 2000));
+	}
+
+	Program::PackedLines packedLines(p);
+	ASSERT_EQ(packedLines.getNbLines(), p.getNbLines()) << "Incorrect number of packed lines.";
+
+	Program::Program p2(*e);
+	ASSERT_NO_THROW(packedLines.unpack(p2)) << "Unpacking lines in a Program failed.";
+	ASSERT_EQ(p2.getNbLines(), p.getNbLines()) << "Incorrect number of unpacked lines.";
+	for (uint64_t i = 0; i < p.getNbLines(); i++) {
+		const Program::Line& l = p.getLine(i);
+		const Program::Line& l2 = p2.getLine(i);
+		ASSERT_EQ(l2.getInstructionIndex(), l.getInstructionIndex()) << "Unpacked instructionIndex differs from the packed one.";
+		ASSERT_EQ(l2.getDestinationIndex(), l.getDestinationIndex()) << "Unpacked destinationIndex differs from the packed one.";
+		ASSERT_EQ(l2.getOperand(0), l.getOperand(0)) << "Unpacked operand differs from the packed one.";
+		ASSERT_EQ(l2.getOperand(1), l.getOperand(1)) << "Unpacked operand differs from the packed one.";
+		ASSERT_EQ((int16_t)l2.getParameter(0), (int16_t)l.getParameter(0)) << "Unpacked parameter differs from the packed one.";
+	}
+
+	// Load from the buffer of a PackedLines
+	Program::PackedLines loadedLines(*e, packedLines.getNbLines(), packedLines.getWords(), packedLines.getNbWords());
+	ASSERT_EQ(loadedLines.getNbLines(), packedLines.getNbLines()) << "Incorrect number of loaded lines.";
+	Program::Program p5(*e);
+	loadedLines.unpack(p5);
+	for (uint64_t i = 0; i < p.getNbLines(); i++) {
+		ASSERT_EQ(p5.getLine(i).getOperand(1), p.getLine(i).getOperand(1)) << "Loaded line differs from the stored one.";
+	}
+	ASSERT_THROW(Program::PackedLines(*e, packedLines.getNbLines() + 1, packedLines.getWords(), packedLines.getNbWords()), std::invalid_argument) << "Loading lines from a buffer with an inconsistent size did not fail.";
+	ASSERT_THROW(Program::PackedLines(*e, UINT64_MAX, packedLines.getWords(), packedLines.getNbWords()), std::invalid_argument) << "Loading lines from a buffer with an inconsistent size did not fail.";
+
+	// Checked unpacking of encodable but invalid values.
+	Program::Program p3(*e);
+	ASSERT_TRUE(packedLines.unpack(p3, true)) << "Checked unpacking of valid lines failed.";
+	p.getLine(3).setOperand(0, 3, 0, false);
+	Program::PackedLines invalidLines(p);
+	Program::Program p4(*e);
+	ASSERT_FALSE(invalidLines.unpack(p4, true)) << "Checked unpacking of an invalid line did not fail.";
+	ASSERT_EQ(p4.getNbLines(), p.getNbLines()) << "All lines should be unpacked, even when one of them is invalid.";
+
+	// Values set without checks may not be encodable.
+	p.getLine(2).setOperand(0, 0, 32, false);
+	ASSERT_THROW(Program::PackedLines{ p }, std::out_of_range) << "Packing a line with a value that can not be encoded did not fail.";
+}
@@ -447,6 +447,55 @@ TEST_F(MutatorTest, ProgramMutatorMutateBehavior) {
 	ASSERT_TRUE(Mutator::ProgramMutator::mutateProgram(*p, params, rng)) << "Mutation did not occur with known seed.";
 }
 
+TEST_F(MutatorTest, ProgramMutatorUpdateIntrons) {
+	Mutator::RNG rng;
+	rng.setSeed(0);
+
+	Mutator::MutationParameters params;
+	params.prog.maxProgramSize = 20;
+	Mutator::ProgramMutator::initRandomProgram(*p, params, rng);
+
+	uint64_t nbNeutralMutations = 0;
+	for (int i = 0; i < 1000; i++) {
+		const std::vector<uint64_t> effectiveCode = p->getEffectiveCode();
+
+		// Apply a random mutation
+		switch (rng.getUnsignedInt64(0, 3)) {
+		case 0:
+			Mutator::ProgramMutator::deleteRandomLine(*p, rng);
+			break;
+		case 1:
+			if (p->getNbLines() < params.prog.maxProgramSize) {
+				Mutator::ProgramMutator::insertRandomLine(*p, rng);
+			}
+			break;
+		case 2:
+			Mutator::ProgramMutator::alterRandomLine(*p, rng);
+			break;
+		default:
+			Mutator::ProgramMutator::swapRandomLines(*p, rng);
+			break;
+		}
+
+		bool effectiveCodeChanged = true;
+		ASSERT_NO_THROW(effectiveCodeChanged = p->updateIntrons()) << "Incremental identification of introns failed.";
+
+		// Compare with a complete identification of introns.
+		Program::Program reference(*p);
+		reference.identifyIntrons();
+		for (uint64_t lineIdx = 0; lineIdx < p->getNbLines(); lineIdx++) {
+			ASSERT_EQ(p->isIntron(lineIdx), reference.isIntron(lineIdx)) << "Incremental identification of introns differs from the complete one at iteration " << i << ".";
+		}
+		ASSERT_EQ(p->getEffectiveLineIndexes(), reference.getEffectiveLineIndexes()) << "Indexes of non-intron lines are incorrect.";
+
+		if (!effectiveCodeChanged) {
+			nbNeutralMutations++;
+			ASSERT_EQ(p->getEffectiveCode(), effectiveCode) << "Effective code changed although the mutation was reported as neutral.";
+		}
+	}
+	ASSERT_GT(nbNeutralMutations, 0) << "Mutations of intron lines should be reported as neutral.";
+}
+
 TEST_F(MutatorTest, TPGMutatorInitRandomTPG) {
 	Mutator::RNG rng;
 	rng.setSeed(0);
@@ -710,6 +759,73 @@ TEST_F(MutatorTest, TPGMutatorMutateProgramBehaviorAgainstArchive) {
 	ASSERT_TRUE(arch.areProgramResultsUnique(hashesAndResults)) << "Mutated program associated to the edge should return a unique bid on the environment.";
 }
 
+/**
+* Archive rejecting the first nbRejections Program results submitted to
+* areProgramResultsUnique(), and recording the effective code of the
+* mutated Program for each of these calls.
+*/
+class RejectingArchive : public Archive {
+public:
+	const Program::Program* program = nullptr;
+	const size_t nbRejections;
+	mutable std::vector<std::vector<uint64_t>> replayedEffectiveCodes;
+
+	RejectingArchive(size_t nbRejections) : Archive(), nbRejections{ nbRejections } {};
+
+	virtual bool areProgramResultsUnique(const std::map<size_t, double>& hashesAndResults, double tau = 1e-4) const override {
+		this->replayedEffectiveCodes.push_back(this->program->getEffectiveCode());
+		return this->replayedEffectiveCodes.size() > this->nbRejections;
+	};
+};
+
+TEST_F(MutatorTest, TPGMutatorMutateProgramBehaviorSkipsNeutralMutations) {
+	Mutator::RNG rng;
+	rng.setSeed(0);
+
+	// Small programs, so that many mutations leave the effective code
+	// unchanged, or back to a previously rejected one.
+	Mutator::MutationParameters params;
+	params.prog.maxProgramSize = 4;
+	params.prog.pAdd = 0.5;
+	params.prog.pDelete = 0.5;
+	params.prog.pMutate = 1.0;
+	params.prog.pSwap = 1.0;
+	std::shared_ptr<Program::Program> prog = std::make_shared<Program::Program>(*e);
+	Mutator::ProgramMutator::initRandomProgram(*prog, params, rng);
+	Program::Program replica(*prog);
+
+	const size_t nbRejections = 20;
+	RejectingArchive arch(nbRejections);
+	arch.program = prog.get();
+	TPG::TPGExecutionEngine tee(*e, &arch);
+	TPG::TPGGraph tpg(*e);
+	const TPG::TPGEdge& edge = tpg.addNewEdge(tpg.addNewTeam(), tpg.addNewAction(0), progPointer);
+	tee.evaluateEdge(edge);
+
+	const uint64_t seed = rng.getUnsignedInt64(0, UINT64_MAX);
+	rng.setSeed(seed);
+	ASSERT_NO_THROW(Mutator::TPGMutator::mutateProgramBehaviorAgainstArchive(prog, params, arch, rng)) << "Mutating a Program behavior failed unexpectedly.";
+
+	// The Program was executed on the Archive once per rejection, plus once
+	// for the accepted mutation, and never twice with the same effective code.
+	ASSERT_EQ(arch.replayedEffectiveCodes.size(), nbRejections + 1) << "Number of executions of the mutated Program on the Archive is incorrect.";
+	std::set<std::vector<uint64_t>> distinctCodes(arch.replayedEffectiveCodes.begin(), arch.replayedEffectiveCodes.end());
+	ASSERT_EQ(distinctCodes.size(), arch.replayedEffectiveCodes.size()) << "A rejected effective code was executed again on the Archive.";
+
+	// Replay the same mutations: some of them led to an effective code
+	// already rejected, whose execution on the Archive was skipped.
+	rng.setSeed(seed);
+	std::set<std::vector<uint64_t>> seenCodes;
+	size_t nbMutations = 0;
+	while (seenCodes.size() < nbRejections + 1) {
+		while (!Mutator::ProgramMutator::mutateProgram(replica, params, rng));
+		nbMutations++;
+		seenCodes.insert(replica.getEffectiveCode());
+	}
+	ASSERT_EQ(replica.getEffectiveCode(), prog->getEffectiveCode()) << "Replayed mutations do not lead to the same Program.";
+	ASSERT_GT(nbMutations, arch.replayedEffectiveCodes.size()) << "No mutation was skipped, the test does not cover the skip of neutral mutations.";
+}
+
 TEST_F(MutatorTest, TPGMutatorMutateNewProgramBehaviorsSequential) {
 	Mutator::RNG rng;
 	rng.setSeed(0);
@@ -883,4 +999,10 @@ TEST_F(MutatorTest, TPGMutatorPopulate) {
 	// Increase coverage with a TPG that has no root team
 	TPG::TPGGraph tpg2(*e);
 	ASSERT_NO_THROW(Mutator::TPGMutator::populateTPG(tpg2, arch, params, rng, 0)) << "Populating an empty TPG failed.";
+
+	// Populate with an existing ThreadPool
+	ThreadPool threadPool(4);
+	params.tpg.nbRoots = 10;
+	ASSERT_NO_THROW(Mutator::TPGMutator::populateTPG(tpg, arch, params, rng, threadPool)) << "Populating a TPG with a ThreadPool failed.";
+	ASSERT_EQ(tpg.getRootVertices().size(), params.tpg.nbRoots);
 }
@@ -304,3 +304,57 @@ TEST_F(ProgramExecutionEngineTest, execute) {
 	ASSERT_NO_THROW(result = progExecEng.executeProgram(true)) << "Program line using a incorrect Instruction index should not interrupt the Execution when ignored.";
 	ASSERT_EQ(result, r0) << "Result of the program from Fixture, with an additional ignored line, is not as expected.";
 }
+
+TEST_F(ProgramExecutionEngineTest, executeCompiledProgram) {
+	Program::ProgramExecutionEngine progExecEng(*p);
+	double result;
+
+	double r1 = value0 + 0;
+	double r0 = r1 * (Parameter(value1)).operator float();
+	r0 = r0 * value2 + r1 * value3;
+
+	// Successive executions reuse the CompiledProgram of the Program
+	std::shared_ptr<const Program::CompiledProgram> compiled = p->getCompiledProgram();
+	ASSERT_EQ(compiled->getLines().at(0).kernel, nullptr) << "Line with an Instruction without kernel should have no kernel.";
+	ASSERT_NE(compiled->getLines().at(2).kernel, nullptr) << "Line with a LambdaInstruction should have a kernel.";
+	ASSERT_EQ(progExecEng.executeProgram(), r0) << "Result of the program from Fixture is not as expected.";
+	ASSERT_EQ(progExecEng.executeProgram(), r0) << "Result of the second execution of the program from Fixture is not as expected.";
+	ASSERT_EQ(p->getCompiledProgram(), compiled) << "Execution of a Program should not rebuild its CompiledProgram.";
+
+	// Modify the Program: the line 3 now only uses register 1.
+	Program::Line& l3 = p->getLine(3);
+	l3.setOperand(0, 0, 1); // 1st operand: 1st and 2nd registers.
+	ASSERT_EQ(p->identifyIntrons(), 2);
+	ASSERT_NO_THROW(result = progExecEng.executeProgram()) << "Modified program failed to execute.";
+	ASSERT_EQ(result, r1 * value2) << "Modification of the Program was not taken into account in its execution.";
+
+	// Data sources modifications are taken into account
+	((Data::PrimitiveTypeArray<double>&)vect.at(1).get()).setDataAt(typeid(double), 5, value3);
+	ASSERT_EQ(progExecEng.executeProgram(), r1 * value3) << "Modification of the data sources was not taken into account in the execution.";
+}
+
+TEST_F(ProgramExecutionEngineTest, executeCompiledProgramBatch) {
+	Program::ProgramExecutionEngine progExecEng(*p);
+
+	double r1 = value0 + 0;
+	double r0 = r1 * (Parameter(value1)).operator float();
+	double expected0 = r0 * value2 + r1 * value3;
+	double expected1 = r0 * value3 + r1 * value3;
+
+	// Two compatible sets of data sources, the second with a modified value.
+	std::vector<std::reference_wrapper<const Data::DataHandler>> otherVect;
+	otherVect.push_back(*vect.at(0).get().clone());
+	otherVect.push_back(*vect.at(1).get().clone());
+	((Data::PrimitiveTypeArray<double>&)otherVect.at(1).get()).setDataAt(typeid(double), 5, value3);
+
+	std::vector<double> results;
+	ASSERT_NO_THROW(progExecEng.executeCompiledProgramBatch(*p->getCompiledProgram(), { &vect, &otherVect, &vect }, results)) << "Batch execution of a CompiledProgram failed.";
+	ASSERT_EQ(results, std::vector<double>({ expected0, expected1, expected0 })) << "Results of the batch execution of a CompiledProgram are not as expected.";
+
+	// Data sources of the engine are bound again after the batch.
+	ASSERT_EQ(progExecEng.executeProgram(), expected0) << "Data sources of the ProgramExecutionEngine were not restored after a batch execution.";
+
+	// Clean up
+	delete& otherVect.at(0).get();
+	delete& otherVect.at(1).get();
+}
@@ -166,6 +166,39 @@ TEST_F(ProgramTest, CopyConstructor) {
 	ASSERT_NEAR((float)p1.getLine(0).getParameter(0), 0.3f, PARAM_FLOAT_PRECISION) << "Line parameter value was not copied on Program copy.";
 }
 
+TEST_F(ProgramTest, LinesStoredInPlace) {
+	Program::Program p0(*e);
+	std::vector<Program::Line*> lines;
+	for (int i = 0; i < 50; i++) {
+		Program::Line& l = p0.addNewLine(i / 2);
+		l.setDestinationIndex(i % 8);
+		l.setOperand(1, 1, i);
+		l.setParameter(0, int16_t(-i));
+		lines.insert(lines.begin() + i / 2, &l);
+	}
+
+	// References to lines remain valid when other lines are added.
+	for (int i = 0; i < 50; i++) {
+		ASSERT_EQ(&p0.getLine(i), lines.at(i)) << "Reference to a Line changed after the addition of other lines.";
+	}
+
+	// Slots of removed lines are reused.
+	p0.removeLine(10);
+	ASSERT_EQ(&p0.addNewLine(), lines.at(10)) << "Slot of a removed Line was not reused.";
+	ASSERT_EQ(p0.getLine(49).getOperand(1).first, 0) << "Line reusing a slot was not filled with 0 bits.";
+	p0.removeLine(49);
+
+	// Lines of a copy are stored contiguously, in order.
+	Program::Program p1(p0);
+	const ptrdiff_t slotSize = (const char*)&p1.getLine(1) - (const char*)&p1.getLine(0);
+	ASSERT_GE(slotSize, (ptrdiff_t)sizeof(Program::Line)) << "Lines of a copied Program overlap.";
+	for (uint64_t i = 1; i < p1.getNbLines(); i++) {
+		ASSERT_EQ((const char*)&p1.getLine(i) - (const char*)&p1.getLine(i - 1), slotSize) << "Lines of a copied Program are not stored contiguously.";
+		ASSERT_EQ(p1.getLine(i).getOperand(1), p0.getLine(i).getOperand(1)) << "Line of a copied Program differs from the original.";
+		ASSERT_EQ((int16_t)p1.getLine(i).getParameter(0), (int16_t)p0.getLine(i).getParameter(0)) << "Line of a copied Program differs from the original.";
+	}
+}
+
 TEST_F(ProgramTest, ProgramSwapLines) {
 	Program::Program p(*e);
 
@@ -265,6 +298,150 @@ TEST_F(ProgramTest, identifyIntronsAndIsIntron) {
 	ASSERT_TRUE(p.isIntron(2)) << "Line 2 wrongfully detected as not an intron.";
 	ASSERT_FALSE(p.isIntron(3)) << "Line 3 wrongfully detected as an intron.";
 
+	// Indexes of non-intron lines
+	ASSERT_EQ(p.getEffectiveLineIndexes(), std::vector<uint64_t>({ 1, 3 })) << "Indexes of non-intron lines are incorrect.";
+
+	// Indexes follow the modifications of the lines
+	p.swapLines(0, 1);
+	ASSERT_TRUE(p.isIntron(1)) << "Intron property was not swapped with the line.";
+	ASSERT_EQ(p.getEffectiveLineIndexes(), std::vector<uint64_t>({ 0, 3 })) << "Indexes of non-intron lines are incorrect after a swap.";
+	p.removeLine(0);
+	ASSERT_EQ(p.getEffectiveLineIndexes(), std::vector<uint64_t>({ 2 })) << "Indexes of non-intron lines are incorrect after a removal.";
+	p.addNewLine(1);
+	ASSERT_EQ(p.getEffectiveLineIndexes(), std::vector<uint64_t>({ 1, 3 })) << "Indexes of non-intron lines are incorrect after an insertion.";
+
 	// cleanup
 	delete (&set.getInstruction(2));
 }
+
+TEST_F(ProgramTest, getEffectiveCode) {
+	Program::Program p(*e);
+	Program::Line& l0 = p.addNewLine();
+	Program::Line& l1 = p.addNewLine();
+
+	// L0: Register 1 = Datasource_1[2] + DataSource_1[2] (Intron)
+	l0.setDestinationIndex(1);
+	l0.setOperand(0, 1, 2);
+	l0.setOperand(1, 1, 2);
+	l0.setInstructionIndex(0);
+
+	// L1: Register 0 = DataSource_1[3] * constant
+	l1.setDestinationIndex(0);
+	l1.setOperand(0, 1, 3);
+	l1.setInstructionIndex(1); //MultByConst
+	l1.setParameter(0, 0.5f);
+	p.identifyIntrons();
+
+	std::vector<uint64_t> effectiveCode;
+	ASSERT_NO_THROW(effectiveCode = p.getEffectiveCode()) << "Getting the effective code of a Program failed.";
+	// Instruction, destination, one operand and one parameter.
+	ASSERT_EQ(effectiveCode.size(), 5) << "Effective code should only describe non-intron lines.";
+
+	// Modifying an intron or an unused operand does not change the effective code
+	l0.setOperand(0, 1, 5);
+	l1.setOperand(1, 0, 3);
+	p.identifyIntrons();
+	ASSERT_EQ(p.getEffectiveCode(), effectiveCode) << "Effective code should not depend on introns and unused operands.";
+
+	// Modifying a parameter does.
+	l1.setParameter(0, 0.25f);
+	ASSERT_NE(p.getEffectiveCode(), effectiveCode) << "Effective code should depend on the parameters of non-intron lines.";
+
+	// Copies have the same effective code.
+	Program::Program p2(p);
+	ASSERT_EQ(p2.getEffectiveCode(), p.getEffectiveCode()) << "Copied Program should have the same effective code.";
+}
+
+TEST_F(ProgramTest, getEffectiveCodeHash) {
+	Program::Program p(*e);
+	Program::Line& l0 = p.addNewLine();
+	Program::Line& l1 = p.addNewLine();
+
+	// L0: Register 1 = Datasource_1[2] + DataSource_1[2] (Intron)
+	l0.setDestinationIndex(1);
+	l0.setOperand(0, 1, 2);
+	l0.setOperand(1, 1, 2);
+	l0.setInstructionIndex(0);
+
+	// L1: Register 0 = DataSource_1[3] * constant
+	l1.setDestinationIndex(0);
+	l1.setOperand(0, 1, 3);
+	l1.setInstructionIndex(1); //MultByConst
+	l1.setParameter(0, 0.5f);
+	p.identifyIntrons();
+
+	uint64_t hash = 0;
+	ASSERT_NO_THROW(hash = p.getEffectiveCodeHash()) << "Getting the effective code hash of a Program failed.";
+
+	// Modifying an intron or an unused operand does not change the hash
+	l0.setOperand(0, 1, 5);
+	l1.setOperand(1, 0, 3);
+	p.identifyIntrons();
+	ASSERT_EQ(p.getEffectiveCodeHash(), hash) << "Effective code hash should not depend on introns and unused operands.";
+
+	// Copies have the same hash.
+	Program::Program p2(p);
+	ASSERT_EQ(p2.getEffectiveCodeHash(), hash) << "Copied Program should have the same effective code hash.";
+
+	// Modifying a parameter of an effective line does, once introns are
+	// updated.
+	l1.setParameter(0, 0.25f);
+	p.identifyIntrons();
+	ASSERT_NE(p.getEffectiveCodeHash(), hash) << "Effective code hash should depend on the parameters of non-intron lines.";
+
+	// Swapping the values of an operand changes the hash.
+	Program::Line& l2 = p2.getLine(1);
+	l2.setOperand(0, 1, 0);
+	p2.identifyIntrons();
+	uint64_t hash2 = p2.getEffectiveCodeHash();
+	l2.setOperand(0, 0, 1);
+	p2.identifyIntrons();
+	ASSERT_NE(p2.getEffectiveCodeHash(), hash2) << "Effective code hash should depend on the order of the effective code values.";
+}
+
+TEST_F(ProgramTest, getCompiledProgram) {
+	Program::Program p(*e);
+	Program::Line& l0 = p.addNewLine();
+	l0.setDestinationIndex(0);
+	l0.setOperand(0, 1, 30); // 30 is scaled to 6 for an array of 24 doubles.
+	l0.setInstructionIndex(1); // MultByConst
+	l0.setParameter(0, 0.5f);
+	p.identifyIntrons();
+
+	std::shared_ptr<const Program::CompiledProgram> compiled;
+	ASSERT_NO_THROW(compiled = p.getCompiledProgram()) << "Compilation of a valid Program failed.";
+	ASSERT_NE(compiled, nullptr) << "Compiled Program should not be null.";
+	ASSERT_EQ(compiled->getLines().size(), 1) << "Number of compiled lines is not as expected.";
+	const Program::CompiledProgram::Line& line = compiled->getLines().at(0);
+	ASSERT_FALSE(line.fault) << "Valid Line should not be marked as faulty.";
+	ASSERT_EQ(line.instruction, &e->getInstructionSet().getInstruction(1)) << "Instruction of the compiled Line is not as expected.";
+	ASSERT_EQ(line.nbOperands, 1) << "Number of operands of the compiled Line is not as expected.";
+	ASSERT_EQ(compiled->getOperands(line)[0].location, 6) << "Operand location should be scaled in the compiled Line.";
+	ASSERT_EQ(line.nbParameters, 1) << "Number of parameters of the compiled Line is not as expected.";
+	ASSERT_EQ((float)compiled->getParameters(line)[0], 0.5f) << "Parameter of the compiled Line is not as expected.";
+
+	// Compiled program is kept while the program is unmodified
+	ASSERT_EQ(p.getCompiledProgram(), compiled) << "CompiledProgram should not be rebuilt for an unmodified Program.";
+
+	// Copy shares the compiled program
+	Program::Program copy(p);
+	ASSERT_EQ(copy.getCompiledProgram(), compiled) << "Copied Program should share the CompiledProgram of the original.";
+
+	// Faulty lines are compiled
+	Program::Line& l1 = p.addNewLine();
+	l1.setInstructionIndex(2, false); // Non-existing instruction.
+	ASSERT_NE(p.getCompiledProgram(), compiled) << "CompiledProgram should be rebuilt after a modification of the Program.";
+	compiled = p.getCompiledProgram();
+	ASSERT_EQ(compiled->getLines().size(), 2) << "Number of compiled lines is not as expected.";
+	ASSERT_TRUE(compiled->getLines().at(1).fault) << "Line with an invalid instruction should be marked as faulty.";
+
+	// Intron lines are not compiled.
+	p.removeLine(1);
+	Program::Line& l2 = p.addNewLine();
+	l2.setDestinationIndex(5);
+	p.identifyIntrons();
+	ASSERT_EQ(p.getCompiledProgram()->getLines().size(), 1) << "Intron lines should not be compiled.";
+
+	// Copy is not affected by modifications of the original.
+	ASSERT_EQ(copy.getCompiledProgram()->getLines().size(), 1) << "Modification of a Program should not affect the CompiledProgram of its copy.";
+}
@@ -0,0 +1,112 @@
+/**
+ * Copyright or © or Copr. IETR/INSA - Rennes (2020) :
+ *
+ * Karol Desnos <kdesnos@insa-rennes.fr> (2020)
+ *
+ * GEGELATI is an open-source reinforcement learning framework for training
+ * artificial intelligence based on Tangled Program Graphs (TPGs).
+ *
+ * This software is governed by the CeCILL-C license under French law and
+ * abiding by the rules of distribution of free software. You can use,
+ * modify and/ or redistribute the software under the terms of the CeCILL-C
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty and the software's author, the holder of the
+ * economic rights, and the successive licensors have only limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading, using, modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean that it is complicated to manipulate, and that also
+ * therefore means that it is reserved for developers and experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and, more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-C license and that you accept its terms.
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <vector>
+#include <stdexcept>
+
+#include "threadPool.h"
+
+TEST(ThreadPoolTest, Constructor) {
+	ThreadPool* threadPool;
+	ASSERT_NO_THROW(threadPool = new ThreadPool(4)) << "Construction of a ThreadPool failed.";
+	ASSERT_EQ(threadPool->getNbThreads(), 4) << "Incorrect number of threads.";
+	ASSERT_NO_THROW(delete threadPool) << "Destruction of a ThreadPool failed.";
+
+	ThreadPool sequentialPool(0);
+	ASSERT_EQ(sequentialPool.getNbThreads(), 1) << "A ThreadPool should always use at least the calling thread.";
+}
+
+TEST(ThreadPoolTest, ParallelFor) {
+	ThreadPool threadPool(4);
+
+	// Reuse the pool for several jobs of various sizes.
+	for (uint64_t nbTasks : { 0, 1, 3, 4, 1000 }) {
+		std::vector<std::atomic<uint64_t>> nbExecutions(nbTasks);
+		std::vector<uint64_t> results(nbTasks, 0);
+		std::atomic<bool> validThreadIdx{ true };
+		ASSERT_NO_THROW(threadPool.parallelFor(nbTasks, [&](uint64_t taskIdx, uint64_t threadIdx) {
+			nbExecutions.at(taskIdx)++;
+			results.at(taskIdx) = taskIdx * taskIdx;
+			if (threadIdx >= threadPool.getNbThreads()) {
+				validThreadIdx = false;
+			}
+			})) << "Parallel execution of " << nbTasks << " tasks failed.";
+
+		ASSERT_TRUE(validThreadIdx) << "Tasks were given an incorrect thread index.";
+		for (uint64_t idx = 0; idx < nbTasks; idx++) {
+			ASSERT_EQ(nbExecutions.at(idx), 1) << "Task " << idx << " should be executed exactly once.";
+			ASSERT_EQ(results.at(idx), idx * idx) << "Result of task " << idx << " is incorrect.";
+		}
+	}
+}
+
+TEST(ThreadPoolTest, ParallelForSequential) {
+	ThreadPool threadPool(1);
+
+	// All tasks are executed in order by the calling thread.
+	std::vector<uint64_t> order;
+	ASSERT_NO_THROW(threadPool.parallelFor(10, [&order](uint64_t taskIdx, uint64_t threadIdx) {
+		ASSERT_EQ(threadIdx, 0);
+		order.push_back(taskIdx);
+		})) << "Sequential execution of tasks failed.";
+
+	ASSERT_EQ(order.size(), 10) << "Incorrect number of executed tasks.";
+	for (uint64_t idx = 0; idx < order.size(); idx++) {
+		ASSERT_EQ(order.at(idx), idx) << "Tasks should be executed in order with a single thread.";
+	}
+}
+
+TEST(ThreadPoolTest, ParallelForException) {
+	ThreadPool threadPool(3);
+
+	std::atomic<uint64_t> nbExecutions{ 0 };
+	ASSERT_THROW(threadPool.parallelFor(100, [&nbExecutions](uint64_t taskIdx, uint64_t) {
+		nbExecutions++;
+		if (taskIdx == 42) {
+			throw std::runtime_error("Task failure.");
+		}
+		}), std::runtime_error) << "Exception thrown by a task should be rethrown by parallelFor.";
+	ASSERT_EQ(nbExecutions, 100) << "All tasks should be executed despite the exception.";
+
+	// Pool is still usable after an exception
+	nbExecutions = 0;
+	ASSERT_NO_THROW(threadPool.parallelFor(100, [&nbExecutions](uint64_t, uint64_t) { nbExecutions++; }));
+	ASSERT_EQ(nbExecutions, 100) << "ThreadPool should remain usable after an exception.";
+
+	ASSERT_THROW(threadPool.parallelFor((uint64_t)UINT32_MAX + 1, [](uint64_t, uint64_t) {}), std::length_error) << "Number of tasks exceeding 32 bits should not be accepted.";
+}
@@ -39,6 +39,7 @@
 #include "data/primitiveTypeArray.h"
 #include "instructions/addPrimitiveType.h"
 #include "instructions/multByConstParam.h"
+#include "instructions/lambdaInstruction.h"
 #include "program/program.h"
 #include "tpg/tpgVertex.h"
 #include "tpg/tpgTeam.h"
@@ -47,6 +48,8 @@
 #include "tpg/tpgGraph.h"
 
 #include "tpg/tpgExecutionEngine.h"
+#include "tpg/frozenTPGGraph.h"
+#include "tpg/frozenTPGExecutionEngine.h"
 
 class TPGExecutionEngineTest : public ::testing::Test {
 protected:
@@ -172,6 +175,30 @@ TEST_F(TPGExecutionEngineTest, ArchiveUsage) {
 	ASSERT_EQ(a.getNbRecordings(), 1) << "No recording was added to the archive.";
 }
 
+TEST_F(TPGExecutionEngineTest, BidCache) {
+	TPG::TPGExecutionEngine tpee(*e, &a, 10);
+
+	ASSERT_NEAR(tpee.evaluateEdge(*edges.at(0)), 0.5, PARAM_FLOAT_PRECISION) << "Evaluation of the program of an Edge failed with an active bid cache.";
+
+	// Modify the program without clearing the cache: memoized bid is returned.
+	progPointers.at(0)->getLine(0).setParameter(0, 0.25f);
+	ASSERT_NEAR(tpee.evaluateEdge(*edges.at(0)), 0.5, PARAM_FLOAT_PRECISION) << "Bid of the program should be memoized for unchanged data sources.";
+	ASSERT_EQ(a.getNbRecordings(), 2) << "Memoized bids should still be recorded in the Archive.";
+
+	// Clear the cache: new bid.
+	tpee.clearBidCache();
+	ASSERT_NEAR(tpee.evaluateEdge(*edges.at(0)), 0.25, PARAM_FLOAT_PRECISION) << "Bid of the program should not be memoized after clearing the cache.";
+
+	// Change data sources: new bid.
+	((Data::PrimitiveTypeArray<double>&)vect.at(0).get()).setDataAt(typeid(double), 0, 2.0);
+	ASSERT_NEAR(tpee.evaluateEdge(*edges.at(0)), 0.5, PARAM_FLOAT_PRECISION) << "Bid of the program should not be memoized for new data sources.";
+
+	// Going back to previous data sources: memoized bid.
+	((Data::PrimitiveTypeArray<double>&)vect.at(0).get()).setDataAt(typeid(double), 0, 1.0);
+	progPointers.at(0)->getLine(0).setParameter(0, 0.75f);
+	ASSERT_NEAR(tpee.evaluateEdge(*edges.at(0)), 0.25, PARAM_FLOAT_PRECISION) << "Bid of the program should be memoized for previously seen data sources.";
+}
+
 TEST_F(TPGExecutionEngineTest, EvaluateTeam) {
 	TPG::TPGExecutionEngine tpee(*e);
 
@@ -189,6 +216,43 @@ TEST_F(TPGExecutionEngineTest, EvaluateTeam) {
 	ASSERT_THROW(result = &tpee.evaluateTeam(*(const TPG::TPGTeam*)(tpg->getVertices().at(0)), { tpg->getVertices().at(1),  tpg->getVertices().at(4) }), std::runtime_error) << "Evaluation of a TPGTeam with all edges excluded did not fail as expected.";
 }
 
+TEST_F(TPGExecutionEngineTest, EvaluateTeamBids) {
+	TPG::TPGExecutionEngine tpee(*e, &a);
+	const TPG::TPGTeam& team = *(const TPG::TPGTeam*)(tpg->getVertices().at(1));
+
+	std::vector<std::pair<const TPG::TPGEdge*, double>> bids;
+	ASSERT_NO_THROW(bids = tpee.evaluateTeamBids(team, {})) << "Evaluation of the bids of a valid TPGTeam with no exclusion failed.";
+	ASSERT_EQ(bids.size(), 4) << "Number of bids is not as expected.";
+	// Bids follow the order of outgoing edges of the team.
+	ASSERT_EQ(bids.at(0).first, edges.at(1)) << "Edge of the bid is incorrect.";
+	ASSERT_EQ(bids.at(1).first, edges.at(5)) << "Edge of the bid is incorrect.";
+	ASSERT_EQ(bids.at(2).first, edges.at(7)) << "Edge of the bid is incorrect.";
+	ASSERT_EQ(bids.at(3).first, edges.at(8)) << "Edge of the bid is incorrect.";
+	ASSERT_NEAR(bids.at(1).second, 0.9, PARAM_FLOAT_PRECISION) << "Bid value is not as expected.";
+	ASSERT_EQ(a.getNbRecordings(), 4) << "Bids should be recorded in the Archive.";
+
+	// Exclude two edges
+	ASSERT_NO_THROW(bids = tpee.evaluateTeamBids(team, { tpg->getVertices().at(2), tpg->getVertices().at(4) })) << "Evaluation of the bids of a valid TPGTeam with exclusions failed.";
+	ASSERT_EQ(bids.size(), 2) << "Number of bids with exclusions is not as expected.";
+	ASSERT_EQ(bids.at(0).first, edges.at(1)) << "Edge of the bid is incorrect.";
+	ASSERT_EQ(bids.at(1).first, edges.at(8)) << "Edge of the bid is incorrect.";
+
+	// Exclusions of a previous evaluation are forgotten.
+	bids = tpee.evaluateTeamBids(team, { tpg->getVertices().at(4) });
+	ASSERT_EQ(bids.size(), 3) << "Exclusions of a previous evaluation should be forgotten.";
+
+	// A vertex of another graph with the same index as a destination does
+	// not exclude it.
+	TPG::TPGGraph otherTpg(*e);
+	const TPG::TPGVertex* foreignVertex = nullptr;
+	while (foreignVertex == nullptr || foreignVertex->getIndex() < tpg->getVertices().at(2)->getIndex()) {
+		foreignVertex = &otherTpg.addNewTeam();
+	}
+	ASSERT_EQ(foreignVertex->getIndex(), tpg->getVertices().at(2)->getIndex());
+	bids = tpee.evaluateTeamBids(team, { foreignVertex });
+	ASSERT_EQ(bids.size(), 4) << "A vertex from another graph should not exclude any edge.";
+}
+
 TEST_F(TPGExecutionEngineTest, EvaluateFromRoot) {
 	TPG::TPGExecutionEngine tpee(*e);
 
@@ -202,3 +266,161 @@ TEST_F(TPGExecutionEngineTest, EvaluateFromRoot) {
 	ASSERT_EQ(result.at(2), tpg->getVertices().at(2)) << "2nd element of the traversed path during execution is incorrect.";
 	ASSERT_EQ(result.at(3), tpg->getVertices().at(6)) << "2nd element of the traversed path during execution is incorrect.";
 }
+
+TEST_F(TPGExecutionEngineTest, ExecuteBatchFromRoot) {
+	TPG::TPGExecutionEngine tpee(*e);
+
+	// Create observations: copies of the data sources with various values.
+	const std::vector<double> values{ 1.0, -1.0, 0.5, -2.0, 0.0 };
+	std::vector<std::vector<std::reference_wrapper<const Data::DataHandler>>> observations;
+	for (double value : values) {
+		Data::PrimitiveTypeArray<double>* dataSource = (Data::PrimitiveTypeArray<double>*)vect.at(0).get().clone();
+		dataSource->setDataAt(typeid(double), 0, value);
+		observations.push_back({ *dataSource, *vect.at(1).get().clone() });
+	}
+
+	std::vector<uint64_t> actionIDs;
+	ASSERT_NO_THROW(actionIDs = tpee.executeBatchFromRoot(*tpg->getVertices().at(0), observations)) << "Batch execution of the TPGGraph failed.";
+	ASSERT_EQ(actionIDs.size(), values.size()) << "Number of actions of the batch execution is incorrect.";
+
+	// Compare with the execution of each observation.
+	for (size_t i = 0; i < observations.size(); i++) {
+		TPG::TPGExecutionEngine tpeeSingle(*e);
+		// Put the observation in the original data sources.
+		((Data::PrimitiveTypeArray<double>&)vect.at(0).get()).setDataAt(typeid(double), 0, values.at(i));
+		const TPG::TPGAction* action = (const TPG::TPGAction*)tpeeSingle.executeFromRoot(*tpg->getVertices().at(0)).back();
+		ASSERT_EQ(actionIDs.at(i), action->getActionID()) << "Action of the batch execution differs from the single execution for observation " << i << ".";
+	}
+
+	// Batch from an action
+	ASSERT_EQ(tpee.executeBatchFromRoot(*tpg->getVertices().at(4), observations), std::vector<uint64_t>(values.size(), 0)) << "Batch execution from a TPGAction should return its ID for all observations.";
+
+	// Data sources of the engine are restored.
+	((Data::PrimitiveTypeArray<double>&)vect.at(0).get()).setDataAt(typeid(double), 0, 1.0);
+	ASSERT_NEAR(tpee.evaluateEdge(*edges.at(0)), 0.5, PARAM_FLOAT_PRECISION) << "Data sources of the TPGExecutionEngine should be restored after a batch execution.";
+
+	// Incompatible observation
+	std::vector<std::vector<std::reference_wrapper<const Data::DataHandler>>> badObservations{ { vect.at(1), vect.at(0) } };
+	ASSERT_THROW(tpee.executeBatchFromRoot(*tpg->getVertices().at(0), badObservations), std::runtime_error) << "Batch execution with incompatible observations should fail.";
+
+	// Clean up
+	for (auto& observation : observations) {
+		for (auto& dataSource : observation) {
+			delete& dataSource.get();
+		}
+	}
+}
+
+TEST_F(TPGExecutionEngineTest, FrozenTPGGraph) {
+	const TPG::TPGVertex& root = *tpg->getRootVertices().at(0);
+
+	// Vertex outside the graph
+	TPG::TPGTeam foreignTeam;
+	ASSERT_THROW(tpg->freeze(foreignTeam), std::runtime_error) << "Freezing a TPGGraph from a vertex outside the graph should fail.";
+
+	TPG::FrozenTPGGraph* frozenGraph = NULL;
+	ASSERT_NO_THROW(frozenGraph = new TPG::FrozenTPGGraph(tpg->freeze(root))) << "Freezing a TPGGraph from a valid root failed.";
+
+	// T0, A0, T1, A1, T2, A2 are reachable from T0
+	ASSERT_EQ(frozenGraph->getVertices().size(), 6) << "Number of vertices of the FrozenTPGGraph is incorrect.";
+	ASSERT_EQ(frozenGraph->getEdges().size(), 8) << "Number of edges of the FrozenTPGGraph is incorrect.";
+	ASSERT_EQ(frozenGraph->getPrograms().size(), 8) << "Number of programs of the FrozenTPGGraph is incorrect.";
+	ASSERT_FALSE(frozenGraph->getVertices().at(0).isAction) << "Root of the FrozenTPGGraph should be a team.";
+	ASSERT_EQ(frozenGraph->getVertices().at(0).nbEdges, 2) << "Number of edges of the root of the FrozenTPGGraph is incorrect.";
+
+	// Compare executions with the TPGExecutionEngine for various inputs.
+	TPG::TPGExecutionEngine tpee(*e);
+	TPG::FrozenTPGExecutionEngine ftee(*frozenGraph);
+	Data::PrimitiveTypeArray<double>& dataSource = (Data::PrimitiveTypeArray<double>&)vect.at(0).get();
+	for (double value : { 1.0, -1.0, 0.5, -2.0, 0.0 }) {
+		dataSource.setDataAt(typeid(double), 0, value);
+		uint64_t expected = ((const TPG::TPGAction*)tpee.executeFromRoot(root).back())->getActionID();
+		ASSERT_EQ(ftee.executeFromRoot(), expected) << "Execution of the FrozenTPGGraph differs from the one of the TPGGraph for input " << value << ".";
+	}
+
+	// The FrozenTPGGraph is independent from the TPGGraph.
+	dataSource.setDataAt(typeid(double), 0, 1.0);
+	tpg->clear();
+	ASSERT_EQ(ftee.executeFromRoot(), 2) << "Execution of the FrozenTPGGraph should not depend on the TPGGraph it was built from.";
+	delete frozenGraph;
+
+	// Team with no outgoing edge
+	const TPG::TPGTeam& team = tpg->addNewTeam();
+	TPG::FrozenTPGGraph emptyTeamGraph = tpg->freeze(team);
+	TPG::FrozenTPGExecutionEngine emptyTeamEngine(emptyTeamGraph);
+	ASSERT_THROW(emptyTeamEngine.executeFromRoot(), std::runtime_error) << "Executing a team without outgoing edge should fail.";
+}
+
+TEST_F(TPGExecutionEngineTest, FrozenTPGGraphKernels) {
+	// Environment with an Instruction executed with a kernel, and one without.
+	Instructions::Set kernelSet;
+	Instructions::AddPrimitiveType<double> add;
+	Instructions::LambdaInstruction<double, double> minus([](double a, double b) { return a - b; });
+	kernelSet.add(add);
+	kernelSet.add(minus);
+	Environment kernelEnv(kernelSet, vect, 8);
+
+	// Team with two actions:
+	// P0: r1 = ds[0] - ds[1] (kernel); r0 = r1 + ds[2] (no kernel)
+	// P1: r0 = ds[1] - ds[0] (kernel)
+	TPG::TPGGraph kernelTPG(kernelEnv);
+	const TPG::TPGTeam& team = kernelTPG.addNewTeam();
+	std::shared_ptr<Program::Program> p0 = std::make_shared<Program::Program>(kernelEnv);
+	Program::Line& l00 = p0->addNewLine();
+	l00.setInstructionIndex(1);
+	l00.setOperand(0, 1, 0);
+	l00.setOperand(1, 1, 1);
+	l00.setDestinationIndex(1);
+	Program::Line& l01 = p0->addNewLine();
+	l01.setInstructionIndex(0);
+	l01.setOperand(0, 0, 1);
+	l01.setOperand(1, 1, 2);
+	l01.setDestinationIndex(0);
+	p0->identifyIntrons();
+	std::shared_ptr<Program::Program> p1 = std::make_shared<Program::Program>(kernelEnv);
+	Program::Line& l10 = p1->addNewLine();
+	l10.setInstructionIndex(1);
+	l10.setOperand(0, 1, 1);
+	l10.setOperand(1, 1, 0);
+	l10.setDestinationIndex(0);
+	p1->identifyIntrons();
+	kernelTPG.addNewEdge(team, kernelTPG.addNewAction(0), p0);
+	kernelTPG.addNewEdge(team, kernelTPG.addNewAction(1), p1);
+
+	TPG::FrozenTPGGraph frozenGraph = kernelTPG.freeze(team);
+	ASSERT_NE(frozenGraph.getPrograms().at(0)->getLines().at(0).kernel, nullptr) << "Line with a LambdaInstruction should be executed with a kernel.";
+	TPG::FrozenTPGExecutionEngine ftee(frozenGraph);
+
+	// Observation replacing the data sources of the Environment.
+	std::vector<std::reference_wrapper<const Data::DataHandler>> observation;
+	observation.push_back(*vect.at(0).get().clone());
+	observation.push_back(*vect.at(1).get().clone());
+	Data::PrimitiveTypeArray<double>& obsData = (Data::PrimitiveTypeArray<double>&)observation.at(0).get();
+	ASSERT_NO_THROW(ftee.setDataSources(observation)) << "Setting compatible data sources for the FrozenTPGExecutionEngine failed.";
+
+	// Operand pointers follow the content of the data sources.
+	for (auto values : { std::vector<double>{ 2.0, 1.0, 0.0 }, std::vector<double>{ 1.0, 2.0, 0.0 }, std::vector<double>{ 1.0, 2.0, 3.0 } }) {
+		for (size_t i = 0; i < values.size(); i++) {
+			obsData.setDataAt(typeid(double), i, values.at(i));
+		}
+		double bid0 = (values.at(0) - values.at(1)) + values.at(2);
+		double bid1 = values.at(1) - values.at(0);
+		uint64_t expected = (bid1 >= bid0) ? 1 : 0;
+		ASSERT_EQ(ftee.executeFromRoot(), expected) << "Execution of the FrozenTPGGraph with kernels is incorrect.";
+	}
+
+	// Back to the data sources of the Environment (ds[0] = 1.0, others 0)
+	ASSERT_NO_THROW(ftee.setDataSources(vect)) << "Setting compatible data sources for the FrozenTPGExecutionEngine failed.";
+	ASSERT_EQ(ftee.executeFromRoot(), 0) << "Execution of the FrozenTPGGraph does not use the new data sources.";
+
+	// Incompatible data sources
+	std::vector<std::reference_wrapper<const Data::DataHandler>> badObservation;
+	badObservation.push_back(*(new Data::PrimitiveTypeArray<double>((unsigned int)size1)));
+	badObservation.push_back(observation.at(1));
+	ASSERT_THROW(ftee.setDataSources(badObservation), std::runtime_error) << "Setting incompatible data sources for the FrozenTPGExecutionEngine should fail.";
+
+	// Clean up
+	delete& badObservation.at(0).get();
+	delete& observation.at(0).get();
+	delete& observation.at(1).get();
+}
@@ -304,6 +304,93 @@ TEST_F(TPGTest, TPGGraphRemoveVertex) {
 	ASSERT_EQ(vertex4.getOutgoingEdges().size(), 0) << "Edge connected to the vertex removed from the graph was not disconnected from its destination.";
 }
 
+TEST_F(TPGTest, TPGGraphRemoveVerticesAndEdgesOrder) {
+	TPG::TPGGraph tpg(*e);
+	std::vector<const TPG::TPGVertex*> teams;
+	for (int i = 0; i < 10; i++) {
+		teams.push_back(&tpg.addNewTeam());
+	}
+	const TPG::TPGAction& action = tpg.addNewAction(0);
+	std::vector<const TPG::TPGEdge*> edges;
+	for (int i = 0; i < 10; i++) {
+		edges.push_back(&tpg.addNewEdge(*teams.at(i), action, progPointer));
+	}
+
+	// Remove every other vertex and check order of remaining vertices and 
+	// edges.
+	for (int i = 0; i < 10; i += 2) {
+		ASSERT_NO_THROW(tpg.removeVertex(*teams.at(i))) << "Removing a vertex from the graph failed.";
+		ASSERT_FALSE(tpg.hasVertex(*teams.at(i))) << "Removed vertex should no longer be in the graph.";
+	}
+	ASSERT_EQ(tpg.getNbVertices(), 6) << "Number of vertices of the TPG is incorrect after removing TPGVertex.";
+	auto vertices = tpg.getVertices();
+	for (int i = 0; i < 5; i++) {
+		ASSERT_EQ(vertices.at(i), teams.at(2 * i + 1)) << "Order of remaining vertices is incorrect.";
+	}
+	ASSERT_EQ(vertices.back(), &action) << "Order of remaining vertices is incorrect.";
+
+	ASSERT_EQ(tpg.getEdges().size(), 5) << "Number of edges of the TPG is incorrect after removing TPGVertex.";
+	ASSERT_EQ(action.getIncomingEdges().size(), 5) << "Incoming edges of the TPGAction are incorrect after removing TPGVertex.";
+	int i = 1;
+	for (const TPG::TPGEdge& edge : tpg.getEdges()) {
+		ASSERT_EQ(&edge, edges.at(i)) << "Order of remaining edges is incorrect.";
+		ASSERT_EQ(action.getIncomingEdges().at(i / 2), edges.at(i)) << "Order of incoming edges is incorrect.";
+		i += 2;
+	}
+
+	// Edges not in the graph can not be removed nor cloned.
+	TPG::TPGEdge foreignEdge(teams.at(1), &action, progPointer);
+	ASSERT_THROW(tpg.removeEdge(foreignEdge), std::runtime_error) << "Removing an edge not in the graph should fail.";
+	ASSERT_THROW(tpg.cloneEdge(foreignEdge), std::runtime_error) << "Cloning an edge not in the graph should fail.";
+	ASSERT_NO_THROW(tpg.removeEdge(*edges.at(1))) << "Removing an edge from the graph failed.";
+	ASSERT_EQ(tpg.getEdges().size(), 4) << "Number of edges of the TPG is incorrect after removing a TPGEdge.";
+}
+
+TEST_F(TPGTest, TPGGraphVertexIndexes) {
+	TPG::TPGGraph tpg(*e);
+	std::vector<const TPG::TPGVertex*> teams;
+	for (int i = 0; i < 10; i++) {
+		teams.push_back(&tpg.addNewTeam());
+		ASSERT_EQ(teams.back()->getIndex(), i) << "Index of a new vertex is incorrect.";
+	}
+	const TPG::TPGAction& action = tpg.addNewAction(0);
+	for (int i = 0; i < 10; i++) {
+		tpg.addNewEdge(*teams.at(i), action, progPointer);
+	}
+
+	// Removing vertices does not change the index of other vertices, until
+	// empty slots outnumber vertices.
+	for (int i = 0; i < 5; i++) {
+		tpg.removeVertex(*teams.at(i));
+	}
+	for (int i = 5; i < 10; i++) {
+		ASSERT_EQ(teams.at(i)->getIndex(), i) << "Index of a vertex changed before the compaction of vertices.";
+	}
+	ASSERT_EQ(action.getIndex(), 10) << "Index of a vertex changed before the compaction of vertices.";
+
+	// Compaction
+	tpg.removeVertex(*teams.at(5));
+	ASSERT_EQ(tpg.getNbVertices(), 5) << "Number of vertices is incorrect after their compaction.";
+	auto vertices = tpg.getVertices();
+	for (uint64_t i = 0; i < vertices.size(); i++) {
+		ASSERT_EQ(vertices.at(i)->getIndex(), i) << "Indexes of vertices do not follow their order after compaction.";
+		ASSERT_TRUE(tpg.hasVertex(*vertices.at(i))) << "Vertex is no longer found after compaction.";
+	}
+	ASSERT_EQ(vertices.back(), &action) << "Order of vertices is incorrect after compaction.";
+	auto roots = tpg.getRootVertices();
+	ASSERT_EQ(roots.size(), 4) << "Number of root vertices is incorrect after compaction.";
+	for (int i = 0; i < 4; i++) {
+		ASSERT_EQ(roots.at(i), teams.at(6 + i)) << "Order of root vertices is incorrect after compaction.";
+	}
+
+	// New vertices follow the compacted ones.
+	ASSERT_EQ(tpg.addNewTeam().getIndex(), 5) << "Index of a new vertex is incorrect after compaction.";
+
+	// A vertex of another graph with the same index does not belong to this graph.
+	TPG::TPGGraph otherTpg(*e);
+	ASSERT_FALSE(tpg.hasVertex(otherTpg.addNewTeam())) << "Vertex of another graph should not belong to the graph.";
+}
+
 TEST_F(TPGTest, TPGGraphClear) {
 	TPG::TPGGraph tpg(*e);
 	const TPG::TPGVertex& vertex0 = tpg.addNewTeam();
@@ -334,6 +421,146 @@ TEST_F(TPGTest, TPGGraphGetRootVertices) {
 	ASSERT_EQ(tpg.getRootVertices().at(0), &vertex0) << "Vertex classified as root is incorrect.";
 }
 
+TEST_F(TPGTest, TPGGraphRootVerticesMaintenance) {
+	TPG::TPGGraph tpg(*e);
+	const TPG::TPGVertex& team0 = tpg.addNewTeam();
+	const TPG::TPGVertex& team1 = tpg.addNewTeam();
+	const TPG::TPGVertex& team2 = tpg.addNewTeam();
+	const TPG::TPGVertex& action = tpg.addNewAction(0);
+
+	// Reference root vertices, computed from the incoming edges.
+	auto checkRoots = [&tpg]() {
+		std::vector<const TPG::TPGVertex*> expected;
+		for (const TPG::TPGVertex* vertex : tpg.getVertices()) {
+			if (vertex->getIncomingEdges().size() == 0) {
+				expected.push_back(vertex);
+			}
+		}
+		ASSERT_EQ(tpg.getNbRootVertices(), expected.size()) << "Number of roots of the TPG is incorrect.";
+		ASSERT_EQ(tpg.getRootVertices(), expected) << "Root vertices of the TPG are incorrect.";
+	};
+
+	checkRoots();
+	const TPG::TPGEdge& edge0 = tpg.addNewEdge(team0, team1, progPointer);
+	checkRoots();
+	const TPG::TPGEdge& edge1 = tpg.addNewEdge(team2, team1, progPointer);
+	tpg.addNewEdge(team1, action, progPointer);
+	checkRoots();
+	ASSERT_EQ(tpg.getNbRootVertices(), 2) << "Number of roots of the TPG is incorrect.";
+
+	// Retarget an edge: team1 keeps an incoming edge.
+	ASSERT_TRUE(tpg.setEdgeDestination(edge0, team2));
+	checkRoots();
+	ASSERT_EQ(tpg.getRootVertices().at(0), &team0) << "Vertex classified as root is incorrect.";
+
+	// Last incoming edge of team1 removed.
+	tpg.removeEdge(edge1);
+	checkRoots();
+	ASSERT_EQ(tpg.getNbRootVertices(), 2) << "Number of roots of the TPG is incorrect.";
+
+	// Removed and cloned vertices.
+	tpg.removeVertex(team0);
+	checkRoots();
+	tpg.cloneVertex(team1);
+	checkRoots();
+	ASSERT_EQ(tpg.getNbRootVertices(), 3) << "Number of roots of the TPG is incorrect.";
+
+	tpg.clear();
+	ASSERT_EQ(tpg.getNbRootVertices(), 0) << "Cleared graph should have no root.";
+}
+
+TEST_F(TPGTest, TPGGraphClone) {
+	TPG::TPGGraph tpg(*e);
+	const TPG::TPGVertex& team0 = tpg.addNewTeam();
+	const TPG::TPGVertex& team1 = tpg.addNewTeam();
+	const TPG::TPGVertex& action = tpg.addNewAction(3);
+	tpg.addNewEdge(team0, team1, progPointer);
+	tpg.addNewEdge(team1, action, progPointer);
+	tpg.addNewEdge(team0, action, progPointer);
+
+	TPG::TPGGraph copy(*e);
+	ASSERT_NO_THROW(copy = tpg.clone()) << "Cloning a TPGGraph failed.";
+	ASSERT_EQ(copy.getNbVertices(), tpg.getNbVertices()) << "Number of vertices of the cloned TPGGraph is incorrect.";
+	ASSERT_EQ(copy.getEdges().size(), tpg.getEdges().size()) << "Number of edges of the cloned TPGGraph is incorrect.";
+	ASSERT_EQ(copy.getNbRootVertices(), 1) << "Number of roots of the cloned TPGGraph is incorrect.";
+
+	// Vertices are new, but their type and order are preserved.
+	for (size_t i = 0; i < tpg.getNbVertices(); i++) {
+		ASSERT_NE(copy.getVertices().at(i), tpg.getVertices().at(i)) << "Cloned TPGGraph shares its vertices with the original.";
+		ASSERT_EQ(typeid(*copy.getVertices().at(i)), typeid(*tpg.getVertices().at(i))) << "Type of a cloned vertex is incorrect.";
+	}
+	ASSERT_EQ(((const TPG::TPGAction*)copy.getVertices().at(2))->getActionID(), 3) << "ActionID of a cloned action is incorrect.";
+
+	// Edges connect the corresponding vertices and share the Program.
+	std::vector<const TPG::TPGVertex*> copyVertices = copy.getVertices();
+	auto edgeIt = tpg.getEdges().begin();
+	for (const TPG::TPGEdge& edge : copy.getEdges()) {
+		ASSERT_EQ(&edge.getProgram(), &edgeIt->getProgram()) << "Cloned edge does not share the Program of the original.";
+		auto srcIdx = std::find(copyVertices.begin(), copyVertices.end(), edge.getSource()) - copyVertices.begin();
+		auto dstIdx = std::find(copyVertices.begin(), copyVertices.end(), edge.getDestination()) - copyVertices.begin();
+		ASSERT_EQ(tpg.getVertices().at(srcIdx), edgeIt->getSource()) << "Source of a cloned edge is incorrect.";
+		ASSERT_EQ(tpg.getVertices().at(dstIdx), edgeIt->getDestination()) << "Destination of a cloned edge is incorrect.";
+		edgeIt++;
+	}
+
+	// Modifying the copy leaves the original untouched.
+	copy.clear();
+	ASSERT_EQ(tpg.getNbVertices(), 3) << "Clearing the clone modified the original TPGGraph.";
+}
+
+TEST_F(TPGTest, TPGGraphInternPrograms) {
+	// Build a program: Register 0 = DataSource_1[3] * constant
+	Program::Line& line = progPointer->addNewLine();
+	line.setDestinationIndex(0);
+	line.setOperand(0, 1, 3);
+	line.setInstructionIndex(1); //MultByConst
+	line.setParameter(0, 0.5f);
+
+	// Identical program, with an additional intron.
+	std::shared_ptr<Program::Program> progIntron = std::make_shared<Program::Program>(*progPointer);
+	Program::Line& intron = progIntron->addNewLine(0);
+	intron.setDestinationIndex(1);
+	intron.setOperand(0, 1, 2);
+	intron.setOperand(1, 1, 2);
+	intron.setInstructionIndex(0);
+
+	// Different program.
+	std::shared_ptr<Program::Program> progOther = std::make_shared<Program::Program>(*progPointer);
+	progOther->getLine(0).setParameter(0, 0.25f);
+
+	TPG::TPGGraph tpg(*e);
+	const TPG::TPGVertex& team = tpg.addNewTeam();
+	const TPG::TPGVertex& action0 = tpg.addNewAction(0);
+	const TPG::TPGVertex& action1 = tpg.addNewAction(1);
+	const TPG::TPGVertex& action2 = tpg.addNewAction(2);
+	tpg.addNewEdge(team, action0, progPointer);
+	tpg.addNewEdge(team, action1, progIntron);
+	tpg.addNewEdge(team, action2, progOther);
+	ASSERT_EQ(tpg.getNbPrograms(), 3) << "Number of distinct Programs of the TPGGraph is incorrect.";
+
+	uint64_t nbReplaced = 0;
+	ASSERT_NO_THROW(nbReplaced = tpg.internPrograms()) << "Interning the Programs of a TPGGraph failed.";
+	ASSERT_EQ(nbReplaced, 1) << "Number of replaced Programs is incorrect.";
+	ASSERT_EQ(tpg.getNbPrograms(), 2) << "Identical Programs should be shared after interning.";
+	ASSERT_EQ(tpg.getNbDeduplicatedPrograms(), 1) << "Number of deduplicated Programs is incorrect.";
+
+	// First Program encountered is kept.
+	auto edgeIt = tpg.getEdges().begin();
+	ASSERT_EQ(&(edgeIt++)->getProgram(), progPointer.get()) << "Interned Program should be the first one encountered.";
+	ASSERT_EQ(&(edgeIt++)->getProgram(), progPointer.get()) << "Identical Program was not replaced by the interned one.";
+	ASSERT_EQ(&(edgeIt++)->getProgram(), progOther.get()) << "Different Program should not be replaced.";
+
+	// Programs added later are interned with the existing ones.
+	std::shared_ptr<Program::Program> progCopy = std::make_shared<Program::Program>(*progOther);
+	tpg.addNewEdge(team, action1, progCopy);
+	ASSERT_EQ(tpg.internPrograms(), 1) << "Program added after a first interning was not replaced.";
+	ASSERT_EQ(tpg.getNbPrograms(), 2) << "Identical Programs should be shared after interning.";
+	ASSERT_EQ(tpg.getNbDeduplicatedPrograms(), 2) << "Number of deduplicated Programs is incorrect.";
+
+	// Interning again changes nothing.
+	ASSERT_EQ(tpg.internPrograms(), 0) << "Interning already shared Programs should not replace them.";
+}
+
 TEST_F(TPGTest, TPGGraphCloneVertex) {
 	TPG::TPGGraph tpg(*e);
 	const TPG::TPGTeam& vertex0 = tpg.addNewTeam();
@@ -210,3 +210,38 @@ TEST_F(UntypedSharedPtrTest, getSharedPtrOnBuiltFromConcept) {
 		ASSERT_THROW(dataPtr = cusp.getSharedPointer<double[]>(), std::runtime_error) << "Getting a non-const pointer to orignally const data should fail.";
 	}
 }
+
+TEST_F(UntypedSharedPtrTest, createView) {
+	double values[4]{ 0.0, 1.0, 2.0, 3.0 };
+
+	{ // View on a single value
+		Data::UntypedSharedPtr usp = Data::UntypedSharedPtr::createView<double>(values + 1);
+		ASSERT_EQ(usp.getType(), typeid(double)) << "getType() method does not return the expected type_info for a view.";
+		ASSERT_EQ(usp.getPtrType(), typeid(const double*)) << "getPtrType() method does not return the expected type_info for a view.";
+
+		std::shared_ptr<const double> cdataPtr;
+		ASSERT_NO_THROW(cdataPtr = usp.getSharedPointer<const double>()) << "Getting the const shared pointer from a view failed unexpectedly.";
+		ASSERT_EQ(cdataPtr.get(), values + 1) << "Shared pointer retrieved from a view does not point to the viewed data.";
+		ASSERT_EQ(cdataPtr.use_count(), 0) << "Shared pointer retrieved from a view should not own the viewed data.";
+		ASSERT_THROW(usp.getSharedPointer<double>(), std::runtime_error) << "Getting a non-const pointer from a view should fail.";
+		ASSERT_THROW(usp.getSharedPointer<const int>(), std::runtime_error) << "Getting a pointer with the wrong type from a view should fail.";
+		ASSERT_THROW(usp.getSharedPointer<const double[]>(), std::runtime_error) << "Getting an array pointer from a view on a single value should fail.";
+	}
+
+	{ // View on an array
+		Data::UntypedSharedPtr usp = Data::UntypedSharedPtr::createView<double[]>(values + 1);
+		ASSERT_EQ(usp.getType(), typeid(double[])) << "getType() method does not return the expected type_info for a view on an array.";
+		ASSERT_EQ(usp.getPtrType(), typeid(const double*)) << "getPtrType() method does not return the expected type_info for a view on an array.";
+
+		std::shared_ptr<const double[]> cdataPtr;
+		ASSERT_NO_THROW(cdataPtr = usp.getSharedPointer<const double[]>()) << "Getting the const shared pointer from a view on an array failed unexpectedly.";
+		ASSERT_EQ(cdataPtr[2], 3.0) << "Shared pointer retrieved from a view on an array does not point to the viewed data.";
+		ASSERT_THROW(usp.getSharedPointer<double[]>(), std::runtime_error) << "Getting a non-const pointer from a view should fail.";
+		ASSERT_THROW(usp.getSharedPointer<const double>(), std::runtime_error) << "Getting a single value pointer from a view on an array should fail.";
+
+		// Copies of the view see the same data
+		Data::UntypedSharedPtr uspCopy = usp;
+		values[1] = 5.0;
+		ASSERT_EQ(uspCopy.getSharedPointer<const double[]>()[0], 5.0) << "Copy of a view does not point to the viewed data.";
+	}
+}